@@ -0,0 +1,1131 @@
+// Zerialize-only micro benchmarks (no reflect-cpp / xtensor required).
+//
+// Each section focuses on one mechanism: heap traffic, lookup cost, traversal
+// cost, and so on. Heap traffic is measured by replacing the global allocation
+// functions with counting versions, and copy volume by counting memcpy/memmove
+// (see copy_count.cpp).
+
+#include <atomic>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <zerialize/zerialize.hpp>
+#include <zerialize/dynamic.hpp>
+#include <zerialize/protocols/zera.hpp>
+#include <zerialize/stream.hpp>
+#include <zerialize/archive.hpp>
+#include <zerialize/ring.hpp>
+#include <zerialize/internals/base64.hpp>
+#ifdef ZERIALIZE_HAS_MSGPACK
+#include <zerialize/protocols/msgpack.hpp>
+#endif
+#ifdef ZERIALIZE_HAS_CBOR
+#include <zerialize/protocols/cbor.hpp>
+#endif
+#ifdef ZERIALIZE_HAS_JSON
+#include <zerialize/protocols/json.hpp>
+#include <zerialize/protocols/json_lazy.hpp>
+#endif
+
+using namespace zerialize;
+using namespace std::chrono;
+
+using std::cout, std::endl, std::string;
+using std::setw, std::setprecision, std::right, std::left, std::fixed;
+
+// -------------------------
+// Allocation counting
+
+static std::atomic<std::size_t> g_alloc_count{0};
+static std::atomic<std::size_t> g_alloc_bytes{0};
+
+void* operator new(std::size_t n) {
+    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+    g_alloc_bytes.fetch_add(n, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+// Bytes passed to memcpy/memmove so far (copy_count.cpp), when copy_counting().
+bool copy_counting();
+std::size_t copied_bytes();
+
+struct AllocSnapshot {
+    std::size_t count = g_alloc_count.load(std::memory_order_relaxed);
+    std::size_t bytes = g_alloc_bytes.load(std::memory_order_relaxed);
+    std::size_t copied = copied_bytes();
+};
+
+// -------------------------
+// Timing
+
+template <typename T>
+inline void do_not_optimize(const T& value) {
+#if defined(__clang__) || defined(__GNUC__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    volatile const T* volatile sink = &value;
+    (void)sink;
+#endif
+}
+
+struct Result {
+    double us = 0;           // time per iteration
+    double allocs = 0;       // heap allocations per iteration
+    double alloc_bytes = 0;  // heap bytes requested per iteration
+    double copy_bytes = 0;   // memcpy/memmove bytes per iteration
+};
+
+template<typename Func>
+Result benchmark(Func&& func, std::size_t iterations, std::size_t warmup = 16) {
+    for (std::size_t i = 0; i < warmup; i++) { auto r = func(); do_not_optimize(r); }
+
+    AllocSnapshot before;
+    auto start = high_resolution_clock::now();
+    for (std::size_t i = 0; i < iterations; i++) {
+        auto r = func();
+        do_not_optimize(r);
+    }
+    auto end = high_resolution_clock::now();
+    AllocSnapshot after;
+
+    Result res;
+    res.us = static_cast<double>(duration_cast<nanoseconds>(end - start).count()) / 1000.0 / iterations;
+    res.allocs = static_cast<double>(after.count - before.count) / iterations;
+    res.alloc_bytes = static_cast<double>(after.bytes - before.bytes) / iterations;
+    res.copy_bytes = static_cast<double>(after.copied - before.copied) / iterations;
+    return res;
+}
+
+constexpr int kLabelWidth = 34;
+constexpr int kColWidth = 16;
+
+void print_header(const string& title, std::initializer_list<const char*> cols) {
+    cout << "--- " << left << setw(kLabelWidth - 4) << title;
+    for (auto c : cols) cout << right << setw(kColWidth) << c;
+    cout << endl;
+}
+
+// -------------------------
+// Zera writer: heap traffic per message
+
+std::array<int, 10> smallArray = {1,2,3,4,5,6,7,8,9,10};
+std::vector<float> mediumTensor(2048, 1.5f);
+std::vector<std::uint8_t> largeTensor(3 * 1024 * 768, 7);
+
+template <typename T>
+std::span<const std::byte> as_bytes_span(const std::vector<T>& v) {
+    return std::as_bytes(std::span<const T>(v));
+}
+
+ZBuffer zera_smallstruct() {
+    return serialize<Zera>(
+        zmap<"int_value","double_value","string_value","array_value">(
+            42, 3.14159, "hello world", smallArray));
+}
+
+ZBuffer zera_telemetry() {
+    return serialize<Zera>(
+        zmap<"device","seq","ts","pose","status">(
+            "sensor-head-07", 12345, 1712345678.25,
+            zmap<"position","orientation","frame">(
+                zvec(1.0, 2.0, 3.0),
+                zvec(0.0, 0.0, 0.0, 1.0),
+                "map"),
+            zvec(zmap<"name","ok">("imu", true),
+                 zmap<"name","ok">("gps", true),
+                 zmap<"name","ok">("lidar", false))));
+}
+
+ZBuffer zera_mediumtensor() {
+    return serialize<Zera>(
+        zmap<"int_value","double_value","string_value","array_value","tensor_value">(
+            42, 3.14159, "hello world", smallArray,
+            zvec(10, zvec(1, 2048), as_bytes_span(mediumTensor))));
+}
+
+ZBuffer zera_largetensor() {
+    return serialize<Zera>(
+        zmap<"int_value","double_value","string_value","array_value","tensor_value">(
+            42, 3.14159, "hello world", smallArray,
+            zvec(4, zvec(3, 1024, 768), as_bytes_span(largeTensor))));
+}
+
+// A dense tensor emitted through write_typed_array (what the xtensor/Eigen adapters do):
+// a native TYPED_ARRAY for Zera, once opted in, instead of the [dtype, shape, blob] triple.
+struct TensorRef {
+    int dtype;
+    std::array<std::uint64_t, 3> dims;
+    std::size_t rank;
+    std::span<const std::byte> bytes;
+};
+
+template <Writer W>
+void serialize(const TensorRef& t, W& w) {
+    write_typed_array(w, t.dtype, std::span<const std::uint64_t>(t.dims.data(), t.rank), t.bytes);
+}
+
+ZBuffer zera_mediumtensor_native() {
+    Zera::RootSerializer rs;
+    rs.set_native_tensors(true);
+    Zera::Serializer w{rs};
+    zmap<"int_value","double_value","string_value","array_value","tensor_value">(
+        42, 3.14159, "hello world", smallArray,
+        TensorRef{10, {1, 2048, 0}, 2, as_bytes_span(mediumTensor)})(w);
+    return rs.finish();
+}
+
+ZBuffer zera_largetensor_native() {
+    Zera::RootSerializer rs;
+    rs.set_native_tensors(true);
+    Zera::Serializer w{rs};
+    zmap<"int_value","double_value","string_value","array_value","tensor_value">(
+        42, 3.14159, "hello world", smallArray,
+        TensorRef{4, {3, 1024, 768}, 3, as_bytes_span(largeTensor)})(w);
+    return rs.finish();
+}
+
+template<typename Func>
+void zera_writer_row(const string& name, Func&& f, std::size_t iterations) {
+    const std::size_t size = f().size();
+    auto r = benchmark(f, iterations);
+    cout << "    " << left << setw(kLabelWidth - 4) << name
+         << right << fixed << setprecision(3) << setw(kColWidth) << r.us
+         << setprecision(1) << setw(kColWidth) << r.allocs
+         << setprecision(0) << setw(kColWidth) << r.alloc_bytes;
+    if (copy_counting()) cout << setw(kColWidth) << r.copy_bytes;
+    else cout << setw(kColWidth) << "n/a";
+    cout << setw(kColWidth) << size << endl;
+}
+
+void bench_zera_writer() {
+    print_header("Zera writer", {"Serialize (µs)", "allocs/msg", "alloc B/msg", "copied B/msg", "Size (bytes)"});
+    zera_writer_row("SmallStruct", zera_smallstruct, 1000000);
+    zera_writer_row("Telemetry (nested)", zera_telemetry, 1000000);
+    zera_writer_row("MediumTensorStruct 1x2048 float", zera_mediumtensor, 100000);
+    zera_writer_row("LargeTensorStruct 3x1024x768 u8", zera_largetensor, 1000);
+    zera_writer_row("MediumTensorStruct typed array", zera_mediumtensor_native, 100000);
+    zera_writer_row("LargeTensorStruct typed array", zera_largetensor_native, 1000);
+    cout << endl;
+}
+
+// -------------------------
+// ZBuffer ownership: encode, hand off, release
+
+template <class Func>
+void zbuffer_row(const string& name, Func&& f) {
+    auto r = benchmark(f, 1000000);
+    cout << "    " << left << setw(kLabelWidth - 4) << name
+         << right << fixed << setprecision(1) << setw(kColWidth) << r.us * 1000.0
+         << setw(kColWidth) << r.allocs
+         << setprecision(0) << setw(kColWidth) << r.alloc_bytes << endl;
+}
+
+#define SMALLSTRUCT zmap<"int_value","double_value","string_value","array_value">( \
+    42, 3.14159, "hello world", smallArray)
+
+void bench_zbuffer() {
+    print_header("serialize() → ZBuffer → release", {"ns/msg", "allocs/msg", "alloc B/msg"});
+    BufferPool pool;
+#ifdef ZERIALIZE_HAS_MSGPACK
+    zbuffer_row("MsgPack", [] { return serialize<MsgPack>(SMALLSTRUCT); });
+    zbuffer_row("MsgPack, BufferPool", [&] { return serialize<MsgPack>(pool, SMALLSTRUCT); });
+    {
+        MsgPack::RootSerializer rs(pool);
+        zbuffer_row("MsgPack, RootSerializer(pool)", [&] {
+            MsgPack::Serializer w{rs};
+            SMALLSTRUCT(w);
+            return rs.finish();
+        });
+    }
+    {
+        // Encoded in place into caller memory; nothing to release.
+        std::array<std::uint8_t, 256> slot{};
+        BasicMsgPackRootSerializer<SpanOutput> rs{std::span<std::uint8_t>(slot)};
+        zbuffer_row("MsgPack, SpanOutput", [&] {
+            rs.reset();
+            BasicMsgPackSerializer<SpanOutput> w{rs};
+            SMALLSTRUCT(w);
+            return rs.finish_view().size();
+        });
+    }
+#endif
+    zbuffer_row("Zera", [] { return serialize<Zera>(SMALLSTRUCT); });
+    zbuffer_row("Zera, BufferPool", [&] { return serialize<Zera>(pool, SMALLSTRUCT); });
+    {
+        Zera::RootSerializer rs(pool);
+        zbuffer_row("Zera, RootSerializer(pool)", [&] {
+            Zera::Serializer w{rs};
+            SMALLSTRUCT(w);
+            return rs.finish();
+        });
+    }
+#ifdef ZERIALIZE_HAS_CBOR
+    zbuffer_row("CBOR", [] { return serialize<CBOR>(SMALLSTRUCT); });
+    zbuffer_row("CBOR, BufferPool", [&] { return serialize<CBOR>(pool, SMALLSTRUCT); });
+    {
+        CBOR::RootSerializer rs(pool);
+        zbuffer_row("CBOR, RootSerializer(pool)", [&] {
+            CBOR::Serializer w{rs};
+            SMALLSTRUCT(w);
+            return rs.finish();
+        });
+    }
+#endif
+    cout << endl;
+}
+
+#undef SMALLSTRUCT
+
+// -------------------------
+// Large blobs: copied into the message vs referenced as segments
+
+template <class Msg>
+void segments_row(const string& name, Msg&& msg, std::size_t ref_threshold) {
+    Zera::RootSerializer rs;
+    rs.set_blob_reference_threshold(ref_threshold);
+    rs.set_native_tensors(true);
+    std::size_t owned = 0;
+    auto r = benchmark([&] {
+        Zera::Serializer w{rs};
+        msg(w);
+        SegmentedBuffer out = rs.finish_segments();
+        owned = out.owned().size();
+        return out;
+    }, 1000);
+    cout << "    " << left << setw(kLabelWidth - 4) << name
+         << right << fixed << setprecision(3) << setw(kColWidth) << r.us
+         << setprecision(1) << setw(kColWidth) << r.allocs
+         << setprecision(0) << setw(kColWidth) << r.alloc_bytes
+         << setw(kColWidth) << owned << endl;
+}
+
+void bench_segments() {
+    print_header("Zera LargeTensor 3x1024x768 u8", {"Serialize (µs)", "allocs/msg", "alloc B/msg", "Owned bytes"});
+    auto triple = [](Zera::Serializer& w) {
+        zmap<"int_value","double_value","string_value","array_value","tensor_value">(
+            42, 3.14159, "hello world", smallArray,
+            zvec(4, zvec(3, 1024, 768), as_bytes_span(largeTensor)))(w);
+    };
+    auto typed = [](Zera::Serializer& w) {
+        zmap<"int_value","double_value","string_value","array_value","tensor_value">(
+            42, 3.14159, "hello world", smallArray,
+            TensorRef{4, {3, 1024, 768}, 3, as_bytes_span(largeTensor)})(w);
+    };
+    segments_row("triple, copied", triple, 0);
+    segments_row("triple, referenced", triple, 64 * 1024);
+    segments_row("typed array, copied", typed, 0);
+    segments_row("typed array, referenced", typed, 64 * 1024);
+    cout << endl;
+}
+
+// -------------------------
+// Output into a caller's slot: encode then copy vs encode in place
+
+template <class P>
+void span_output_row(const string& name, std::span<std::byte> slot) {
+    auto msg = [](auto& w) {
+        zmap<"int_value","double_value","string_value","tensor_value">(
+            42, 3.14159, "hello world", as_bytes_span(mediumTensor))(w);
+    };
+    typename P::RootSerializer owned;
+    auto copied = benchmark([&] {
+        owned.reset();
+        typename P::Serializer w{owned};
+        msg(w);
+        auto bytes = owned.finish_view();
+        std::memcpy(slot.data(), bytes.data(), bytes.size());
+        return bytes.size();
+    }, 100000);
+    typename P::SpanRootSerializer in_place{slot};
+    auto direct = benchmark([&] {
+        in_place.reset(slot);
+        typename P::SpanSerializer w{in_place};
+        msg(w);
+        return in_place.finish_view().size();
+    }, 100000);
+    cout << "    " << left << setw(kLabelWidth - 4) << name
+         << right << fixed << setprecision(1) << setw(kColWidth) << copied.us * 1000.0
+         << setw(kColWidth) << direct.us * 1000.0
+         << setw(kColWidth) << direct.allocs << endl;
+}
+
+void bench_span_output() {
+    print_header("8 KB message into a slot", {"copy in (ns)", "in place (ns)", "allocs/msg"});
+    alignas(16) static std::array<std::byte, 16384> slot{};
+    span_output_row<Zera>("Zera", slot);
+#ifdef ZERIALIZE_HAS_MSGPACK
+    span_output_row<MsgPack>("MsgPack", slot);
+#endif
+#ifdef ZERIALIZE_HAS_CBOR
+    span_output_row<CBOR>("CBOR", slot);
+#endif
+    cout << endl;
+}
+
+// -------------------------
+// measure(): exact size before encoding, vs encoding in place
+
+template <class P>
+void measure_row(const string& name, std::span<std::byte> slot) {
+    auto measured = benchmark([&] {
+        return measure<P>(zmap<"int_value","double_value","string_value","array_value","tensor_value">(
+            42, 3.14159, "hello world", smallArray, as_bytes_span(mediumTensor)));
+    }, 100000);
+    typename P::SpanRootSerializer in_place{slot};
+    auto encoded = benchmark([&] {
+        in_place.reset(slot);
+        typename P::SpanSerializer w{in_place};
+        zmap<"int_value","double_value","string_value","array_value","tensor_value">(
+            42, 3.14159, "hello world", smallArray, as_bytes_span(mediumTensor))(w);
+        return in_place.finish_view().size();
+    }, 100000);
+    cout << "    " << left << setw(kLabelWidth - 4) << name
+         << right << fixed << setprecision(1) << setw(kColWidth) << measured.us * 1000.0
+         << setw(kColWidth) << encoded.us * 1000.0
+         << setw(kColWidth) << measured.allocs << endl;
+}
+
+void bench_measure() {
+    print_header("8 KB message: size, then encode", {"measure (ns)", "in place (ns)", "allocs/msg"});
+    alignas(16) static std::array<std::byte, 16384> slot{};
+    measure_row<Zera>("Zera", slot);
+#ifdef ZERIALIZE_HAS_MSGPACK
+    measure_row<MsgPack>("MsgPack", slot);
+#endif
+#ifdef ZERIALIZE_HAS_CBOR
+    measure_row<CBOR>("CBOR", slot);
+#endif
+    cout << endl;
+}
+
+// -------------------------
+// Many producer threads, one consumer: mutex-protected queue of ZBuffers vs
+// the MPSC byte ring
+
+template <class Produce, class Consume>
+double run_producers(int producers, int per_producer, Produce&& produce, Consume&& consume) {
+    auto start = high_resolution_clock::now();
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] { for (int i = 0; i < per_producer; ++i) produce(p, i); });
+    }
+    const long total = long(producers) * per_producer;
+    for (long got = 0; got < total;) {
+        const long n = consume();
+        if (n == 0) std::this_thread::yield();
+        got += n;
+    }
+    for (auto& t : threads) t.join();
+    auto end = high_resolution_clock::now();
+    return double(total) / (double(duration_cast<nanoseconds>(end - start).count()) / 1e9) / 1e6;
+}
+
+void bench_ring() {
+    print_header("MsgPack, N producers -> 1 consumer", {"mutex (M/s)", "ring (M/s)"});
+    constexpr int kMessages = 400000;
+    for (int producers : {1, 2, 4, 8, 16, 32}) {
+        const int per = kMessages / producers;
+        long seq_sum = 0;
+
+        std::mutex mu;
+        std::deque<ZBuffer> queue;
+        std::deque<ZBuffer> batch;
+        const double locked = run_producers(producers, per,
+            [&](int p, int i) {
+                ZBuffer b = serialize<MsgPack>(zmap<"producer","seq","value","name">(p, i, 3.14159, "sensor"));
+                std::lock_guard<std::mutex> lock(mu);
+                queue.push_back(std::move(b));
+            },
+            [&] {
+                { std::lock_guard<std::mutex> lock(mu); batch.swap(queue); }
+                const long n = long(batch.size());
+                for (const auto& b : batch) seq_sum += MsgPack::Deserializer(b.buf())["seq"].asInt64();
+                batch.clear();
+                return n;
+            });
+
+        ring::ByteRing q(1 << 20);
+        const double lock_free = run_producers(producers, per,
+            [&](int p, int i) {
+                ring::write<MsgPack>(q, zmap<"producer","seq","value","name">(p, i, 3.14159, "sensor"));
+            },
+            [&] {
+                return long(ring::read<MsgPack>(q, [&](const MsgPack::Deserializer& m) {
+                    seq_sum += m["seq"].asInt64();
+                }));
+            });
+
+        do_not_optimize(seq_sum);
+        cout << "    " << left << setw(kLabelWidth - 4) << (std::to_string(producers) + " producers")
+             << right << fixed << setprecision(2) << setw(kColWidth) << locked
+             << setw(kColWidth) << lock_free << endl;
+    }
+    cout << endl;
+}
+
+// -------------------------
+// zmap keys: runtime key() vs compile-time encoded key_raw
+
+// Forwards everything except key_raw, so zmap falls back to key().
+template <Writer S>
+struct KeysAtRuntime {
+    S& s;
+    void null() { s.null(); }
+    void boolean(bool b) { s.boolean(b); }
+    void int64(std::int64_t i) { s.int64(i); }
+    void uint64(std::uint64_t u) { s.uint64(u); }
+    void double_(double d) { s.double_(d); }
+    void string(std::string_view sv) { s.string(sv); }
+    void binary(std::span<const std::byte> b) { s.binary(b); }
+    void key(std::string_view k) { s.key(k); }
+    void begin_array(std::size_t n) { s.begin_array(n); }
+    void end_array() { s.end_array(); }
+    void begin_map(std::size_t n) { s.begin_map(n); }
+    void end_map() { s.end_map(); }
+};
+
+template <class P>
+void raw_key_row() {
+    auto msg = zmap<"int_value","double_value","string_value","array_value">(
+        42, 3.14159, "hello world", smallArray);
+    typename P::RootSerializer rs;
+    auto runtime = benchmark([&]{
+        rs.reset();
+        typename P::Serializer s{rs};
+        KeysAtRuntime<typename P::Serializer> w{s};
+        msg(w);
+        return rs.finish_view().size();
+    }, 1000000);
+    auto raw = benchmark([&]{
+        rs.reset();
+        typename P::Serializer s{rs};
+        msg(s);
+        return rs.finish_view().size();
+    }, 1000000);
+    cout << "    " << left << setw(kLabelWidth - 4) << (string(P::Name) + " SmallStruct")
+         << right << fixed << setprecision(1)
+         << setw(kColWidth) << runtime.us * 1000.0
+         << setw(kColWidth) << raw.us * 1000.0 << endl;
+}
+
+void bench_raw_keys() {
+    print_header("zmap keys", {"key() (ns)", "key_raw (ns)"});
+    raw_key_row<Zera>();
+#ifdef ZERIALIZE_HAS_MSGPACK
+    raw_key_row<MsgPack>();
+#endif
+#ifdef ZERIALIZE_HAS_CBOR
+    raw_key_row<CBOR>();
+#endif
+    cout << endl;
+}
+
+// -------------------------
+// Zera tensor read: [dtype, shape, blob] triple vs native typed array
+
+struct TensorParts {
+    int dtype = 0;
+    std::array<std::uint64_t, 8> dims{};
+    std::size_t rank = 0;
+    std::span<const std::byte> bytes;
+};
+
+TensorParts read_triple(const Zera::Deserializer& d) {
+    auto t = d["tensor_value"];
+    TensorParts p;
+    p.dtype = t[0].asInt32();
+    auto shape = t[1];
+    p.rank = shape.arraySize();
+    for (std::size_t i = 0; i < p.rank; i++) p.dims[i] = shape[i].asUInt64();
+    p.bytes = t[2].asBlob();
+    return p;
+}
+
+TensorParts read_native(const Zera::Deserializer& d) {
+    const TypedArrayView ta = d["tensor_value"].asTypedArray();
+    TensorParts p;
+    p.dtype = ta.dtype;
+    p.rank = ta.rank;
+    p.dims = ta.dims;
+    p.bytes = ta.data;
+    return p;
+}
+
+void bench_zera_tensor_read() {
+    print_header("Zera tensor read", {"Read (ns)"});
+    auto triple = zera_largetensor();
+    auto native = zera_largetensor_native();
+    Zera::Deserializer dt(triple.buf());
+    Zera::Deserializer dn(native.buf());
+    auto rt = benchmark([&]{ return read_triple(dt); }, 1000000);
+    auto rn = benchmark([&]{ return read_native(dn); }, 1000000);
+    cout << "    " << left << setw(kLabelWidth - 4) << "[dtype, shape, blob] triple"
+         << right << fixed << setprecision(1) << setw(kColWidth) << rt.us * 1000.0 << endl;
+    cout << "    " << left << setw(kLabelWidth - 4) << "typed array"
+         << right << fixed << setprecision(1) << setw(kColWidth) << rn.us * 1000.0 << endl;
+    cout << endl;
+}
+
+// -------------------------
+// Zera object lookup: linear (v1) vs key index
+
+ZBuffer zera_object_with_keys(std::size_t nkeys, std::uint32_t index_threshold) {
+    dyn::Value::Map m;
+    for (std::size_t i = 0; i < nkeys; i++) m.emplace_back("field_" + std::to_string(i), static_cast<std::int64_t>(i));
+    Zera::RootSerializer rs;
+    rs.set_object_index_threshold(index_threshold);
+    Zera::Serializer w{rs};
+    serialize(dyn::Value::map(std::move(m)), w);
+    return rs.finish();
+}
+
+void zera_lookup_row(std::size_t nkeys, std::uint32_t index_threshold, const string& label) {
+    auto buf = zera_object_with_keys(nkeys, index_threshold);
+    Zera::Deserializer d(buf.buf());
+
+    // Look keys up in a scrambled order so every position is exercised.
+    std::vector<string> keys;
+    for (std::size_t i = 0; i < nkeys; i++) keys.push_back("field_" + std::to_string((i * 7919) % nkeys));
+
+    std::size_t i = 0;
+    auto r = benchmark([&]{
+        const auto& k = keys[i++ % nkeys];
+        return d[k].asInt64();
+    }, 1000000);
+    cout << "    " << left << setw(kLabelWidth - 4) << (std::to_string(nkeys) + " keys, " + label)
+         << right << fixed << setprecision(1) << setw(kColWidth) << r.us * 1000.0
+         << setw(kColWidth) << buf.size() << endl;
+}
+
+void bench_zera_lookup() {
+    print_header("Zera object lookup", {"Lookup (ns)", "Size (bytes)"});
+    for (std::size_t n : {4, 64, 1024}) {
+        zera_lookup_row(n, 0, "linear (v1)");
+        zera_lookup_row(n, 1, "indexed");
+    }
+    cout << endl;
+}
+
+// -------------------------
+// Typed reads: one key lookup per field vs one read_map pass
+
+struct Pose {
+    std::int64_t seq = 0;
+    double ts = 0, x = 0, y = 0, z = 0, qx = 0, qy = 0, qz = 0, qw = 0;
+    std::string device, frame;
+    bool ok = false;
+};
+
+template <Writer W>
+void serialize(const Pose& p, W& w) {
+    zmap<"seq","ts","x","y","z","qx","qy","qz","qw","device","frame","ok">(
+        p.seq, p.ts, p.x, p.y, p.z, p.qx, p.qy, p.qz, p.qw, p.device, p.frame, p.ok)(w);
+}
+
+template <Reader V>
+void deserialize(const V& v, Pose& p) {
+    read_map<"seq","ts","x","y","z","qx","qy","qz","qw","device","frame","ok">(
+        v, p.seq, p.ts, p.x, p.y, p.z, p.qx, p.qy, p.qz, p.qw, p.device, p.frame, p.ok);
+}
+
+template <Reader V>
+Pose pose_by_lookup(const V& v) {
+    Pose p;
+    p.seq = v["seq"].asInt64();
+    p.ts = v["ts"].asDouble();
+    p.x = v["x"].asDouble();
+    p.y = v["y"].asDouble();
+    p.z = v["z"].asDouble();
+    p.qx = v["qx"].asDouble();
+    p.qy = v["qy"].asDouble();
+    p.qz = v["qz"].asDouble();
+    p.qw = v["qw"].asDouble();
+    p.device = v["device"].asString();
+    p.frame = v["frame"].asString();
+    p.ok = v["ok"].asBool();
+    return p;
+}
+
+template <class P>
+void typed_read_row() {
+    const Pose src{12345, 1712345678.25, 1, 2, 3, 0, 0, 0, 1, "sensor-head-07", "map", true};
+    auto buf = serialize<P>(src);
+    typename P::Deserializer d(buf.buf());
+
+    auto lookup = benchmark([&]{ return pose_by_lookup(d); }, 200000);
+    auto pass = benchmark([&]{ return deserialize<Pose>(d); }, 200000);
+    cout << "    " << left << setw(kLabelWidth - 4) << P::Name
+         << right << fixed << setprecision(1)
+         << setw(kColWidth) << lookup.us * 1000.0
+         << setw(kColWidth) << pass.us * 1000.0 << endl;
+}
+
+void bench_typed_read() {
+    print_header("Typed read, 12 fields", {"operator[] (ns)", "read_map (ns)"});
+    typed_read_row<Zera>();
+#ifdef ZERIALIZE_HAS_MSGPACK
+    typed_read_row<MsgPack>();
+#endif
+#ifdef ZERIALIZE_HAS_CBOR
+    typed_read_row<CBOR>();
+#endif
+    cout << endl;
+
+    // A few fields out of a large Zera object: read_map walks every entry of
+    // an unindexed object, but probes an indexed one once per field.
+    print_header("read_map, 3 of 1024 keys", {"Read (ns)"});
+    for (std::uint32_t threshold : {0u, 1u}) {
+        auto buf = zera_object_with_keys(1024, threshold);
+        Zera::Deserializer d(buf.buf());
+        auto r = benchmark([&]{
+            std::int64_t a = 0, b = 0, c = 0;
+            read_map<"field_3","field_500","field_1000">(d, a, b, c);
+            return a + b + c;
+        }, 200000);
+        cout << "    " << left << setw(kLabelWidth - 4) << (threshold ? "Zera, indexed (key hashes)" : "Zera, linear (one pass)")
+             << right << fixed << setprecision(1) << setw(kColWidth) << r.us * 1000.0 << endl;
+    }
+    cout << endl;
+}
+
+// -------------------------
+// Template messages: a fixed 30-field control message, zmap vs patched skeleton
+
+struct Control {
+    std::int64_t seq = 0, cycle = 0, mode = 0, err = 0;
+    double ts = 0, x = 0, y = 0, z = 0;
+    std::array<double, 7> q{}, dq{}, tau{};
+    bool ok = false, estop = false;
+};
+
+#define CONTROL_KEYS "seq","cycle","mode","err","ts","x","y","z", \
+    "q0","q1","q2","q3","q4","q5","q6","dq0","dq1","dq2","dq3","dq4","dq5","dq6", \
+    "tau0","tau1","tau2","tau3","tau4","tau5","tau6","ok"
+#define CONTROL_VALUES(c) c.seq, c.cycle, c.mode, c.err, c.ts, c.x, c.y, c.z, \
+    c.q[0], c.q[1], c.q[2], c.q[3], c.q[4], c.q[5], c.q[6], \
+    c.dq[0], c.dq[1], c.dq[2], c.dq[3], c.dq[4], c.dq[5], c.dq[6], \
+    c.tau[0], c.tau[1], c.tau[2], c.tau[3], c.tau[4], c.tau[5], c.tau[6], c.ok
+
+template <class P>
+void template_message_row() {
+    Control c;
+    typename P::RootSerializer rs;
+    std::size_t zmap_size = 0, tmpl_size = 0;
+    auto built = benchmark([&]{
+        ++c.seq; c.ts += 0.001; c.q[3] += 0.01;
+        zmap_size = serialize_into<P>(rs, zmap<CONTROL_KEYS>(CONTROL_VALUES(c))).size();
+        return zmap_size;
+    }, 1000000);
+    TemplateMessage<P, CONTROL_KEYS> msg;
+    auto patched = benchmark([&]{
+        ++c.seq; c.ts += 0.001; c.q[3] += 0.01;
+        tmpl_size = msg.encode(CONTROL_VALUES(c)).size();
+        return tmpl_size;
+    }, 1000000);
+    cout << "    " << left << setw(kLabelWidth - 4) << P::Name
+         << right << fixed << setprecision(1)
+         << setw(kColWidth) << built.us * 1000.0
+         << setw(kColWidth) << patched.us * 1000.0
+         << setw(kColWidth) << zmap_size
+         << setw(kColWidth) << tmpl_size << endl;
+}
+
+#undef CONTROL_KEYS
+#undef CONTROL_VALUES
+
+void bench_template_message() {
+    print_header("30-field message", {"zmap (ns)", "template (ns)", "zmap B", "template B"});
+    template_message_row<Zera>();
+#ifdef ZERIALIZE_HAS_MSGPACK
+    template_message_row<MsgPack>();
+#endif
+#ifdef ZERIALIZE_HAS_CBOR
+    template_message_row<CBOR>();
+#endif
+    cout << endl;
+}
+
+// -------------------------
+// Reader traversal: write_value over a large array
+
+// Writer that only counts values, so the timings are the reader's traversal cost.
+struct NullWriter {
+    std::size_t n = 0;
+    void null() { ++n; }
+    void boolean(bool) { ++n; }
+    void int64(std::int64_t) { ++n; }
+    void uint64(std::uint64_t) { ++n; }
+    void double_(double) { ++n; }
+    void string(std::string_view) { ++n; }
+    void binary(std::span<const std::byte>) { ++n; }
+    void key(std::string_view) {}
+    void begin_array(std::size_t) {}
+    void end_array() {}
+    void begin_map(std::size_t) {}
+    void end_map() {}
+};
+
+// The traversal write_value() did before readers had cursors: children by operator[].
+template <class V>
+void write_value_by_index(const V& v, NullWriter& w) {
+    if (v.isArray()) {
+        for (std::size_t i = 0; i < v.arraySize(); i++) write_value_by_index(v[i], w);
+    } else if (v.isMap()) {
+        for (std::string_view k : v.mapKeys()) write_value_by_index(v[k], w);
+    } else {
+        w.int64(0);
+    }
+}
+
+template <class P>
+void traversal_rows(std::size_t n) {
+    std::vector<std::int64_t> values(n);
+    for (std::size_t i = 0; i < n; i++) values[i] = static_cast<std::int64_t>(i * 7919 % 100000);
+    auto buf = serialize<P>(values);
+    typename P::Deserializer d(buf.buf());
+
+    auto fast = benchmark([&]{ NullWriter w; write_value(d, w); return w.n; }, n >= 1000000 ? 10 : 100);
+    cout << "    " << left << setw(kLabelWidth - 4) << (string(P::Name) + " " + std::to_string(n) + " ints")
+         << right << fixed << setprecision(3);
+
+    // The quadratic path takes seconds at 100k elements; run it once, unwarmed,
+    // and not at all beyond that.
+    if (n > 100000) {
+        cout << setw(kColWidth) << "-";
+    } else {
+        const std::size_t slow_iters = n >= 100000 ? 1 : (n >= 10000 ? 10 : 100);
+        auto slow = benchmark([&]{ NullWriter w; write_value_by_index(d, w); return w.n; }, slow_iters, slow_iters > 1 ? 2 : 0);
+        cout << setw(kColWidth) << slow.us / 1000.0;
+    }
+    cout << setw(kColWidth) << fast.us / 1000.0 << endl;
+}
+
+void bench_traversal() {
+    print_header("write_value over an array", {"operator[] (ms)", "cursor (ms)"});
+#ifdef ZERIALIZE_HAS_MSGPACK
+    for (std::size_t n : {1000, 10000, 100000}) traversal_rows<MsgPack>(n);
+#endif
+#ifdef ZERIALIZE_HAS_CBOR
+    for (std::size_t n : {1000, 10000, 100000, 1000000}) traversal_rows<CBOR>(n);
+#endif
+    cout << endl;
+}
+
+// -------------------------
+// Streams: many small messages per buffer
+
+template <class W>
+void write_telemetry(W& w, int seq) {
+    w.write(zmap<"device","seq","ts","pose">(
+        "sensor-head-07", seq, 1712345678.25 + seq,
+        zmap<"position","orientation">(zvec(1.0, 2.0, 3.0), zvec(0.0, 0.0, 0.0, 1.0))));
+}
+
+// What each caller did by hand: one ZBuffer per message.
+struct PerMessageBatch {
+    std::vector<ZBuffer> msgs;
+    template <class Root>
+    void write(Root&& r) { msgs.push_back(serialize<Zera>(std::forward<Root>(r))); }
+};
+
+void stream_row(const string& name, Result r, std::size_t bytes) {
+    cout << "    " << left << setw(kLabelWidth - 4) << name
+         << right << fixed << setprecision(3) << setw(kColWidth) << r.us
+         << setprecision(1) << setw(kColWidth) << r.allocs
+         << setprecision(0) << setw(kColWidth) << bytes << endl;
+}
+
+void bench_stream() {
+    constexpr int kMessages = 1000;
+    print_header("Zera, 1000 messages", {"Batch (µs)", "allocs/batch", "Size (bytes)"});
+
+    std::size_t per_message_bytes = 0;
+    auto per_message = benchmark([&]{
+        PerMessageBatch b;
+        b.msgs.reserve(kMessages);
+        for (int i = 0; i < kMessages; i++) write_telemetry(b, i);
+        per_message_bytes = 0;
+        for (auto& m : b.msgs) per_message_bytes += m.size();
+        return b.msgs.size();
+    }, 50);
+    stream_row("ZBuffer per message", per_message, per_message_bytes);
+
+    stream::FrameWriter<Zera> out;
+    auto framed = benchmark([&]{
+        out.clear();
+        for (int i = 0; i < kMessages; i++) write_telemetry(out, i);
+        return out.size();
+    }, 50);
+    stream_row("FrameWriter (length-prefixed)", framed, out.size());
+
+    auto read = benchmark([&]{
+        stream::FrameReader<Zera> in(out.view());
+        std::int64_t sum = 0;
+        while (auto msg = in.next()) sum += (*msg)["seq"].asInt64();
+        return sum;
+    }, 50);
+    stream_row("FrameReader, read seq", read, out.size());
+    cout << endl;
+}
+
+// -------------------------
+// Archives: open cost and random access
+
+void bench_archive() {
+    print_header("Zera archive", {"Open (µs)", "Read (ns)", "Size (bytes)"});
+    const auto path = std::filesystem::temp_directory_path() / "zerialize_bench.zar";
+    for (int n : {1000, 100000}) {
+        {
+            archive::ArchiveWriter<Zera> w(path);
+            for (int i = 0; i < n; i++) write_telemetry(w, i);
+        }
+        auto open = benchmark([&]{ archive::ArchiveReader<Zera> r(path); return r.size(); }, 100);
+        archive::ArchiveReader<Zera> r(path);
+        std::uint64_t k = 0;
+        auto read = benchmark([&]{
+            k = (k * 6364136223846793005ull + 1442695040888963407ull);
+            return r[(k >> 33) % r.size()]["seq"].asInt64();
+        }, 100000);
+        cout << "    " << left << setw(kLabelWidth - 4) << (std::to_string(n) + " messages")
+             << right << fixed << setprecision(3) << setw(kColWidth) << open.us
+             << setprecision(1) << setw(kColWidth) << read.us * 1000.0
+             << setprecision(0) << setw(kColWidth) << std::filesystem::file_size(path) << endl;
+    }
+    std::filesystem::remove(path);
+    cout << endl;
+}
+
+// -------------------------
+// Base64 (JSON blobs): scalar vs SSE4.1 vs AVX2, encode and decode
+
+void bench_base64() {
+    using namespace base64_detail;
+    print_header("Base64 throughput", {"scalar (GB/s)", "SSE4.1 (GB/s)", "AVX2 (GB/s)"});
+    for (std::size_t mb : {1, 8}) {
+        std::vector<std::uint8_t> bytes(mb << 20);
+        for (std::size_t i = 0; i < bytes.size(); ++i) bytes[i] = static_cast<std::uint8_t>(i * 131 + 7);
+        std::string text(base64EncodedSize(bytes.size()), '\0');
+        encode_scalar(bytes.data(), bytes.size(), text.data());
+        std::vector<std::uint8_t> back(bytes.size());
+        const std::size_t iterations = 64 / mb;
+
+        for (bool encode : {true, false}) {
+            cout << "    " << left << setw(kLabelWidth - 4)
+                 << ((encode ? "encode " : "decode ") + std::to_string(mb) + " MB");
+            for (Isa isa : {Isa::Scalar, Isa::SSE41, Isa::AVX2}) {
+                if (isa > best_isa()) { cout << right << setw(kColWidth) << "-"; continue; }
+                auto r = benchmark([&] {
+                    if (encode) encode_with(isa, bytes.data(), bytes.size(), text.data());
+                    else decode_with(isa, text.data(), data_length(text), back.data());
+                    return text.data();
+                }, iterations, 2);
+                cout << right << fixed << setprecision(2) << setw(kColWidth)
+                     << double(bytes.size()) / (r.us * 1000.0);
+            }
+            cout << endl;
+        }
+    }
+    cout << endl;
+}
+
+#ifdef ZERIALIZE_HAS_JSON
+// -------------------------
+// JSON writers: yyjson document vs direct text
+
+template <class Make>
+void json_writer_row(const string& name, Make&& make, std::size_t iterations) {
+    JSON::RootSerializer dom;
+    JSONDirect::RootSerializer direct;
+    auto a = benchmark([&] { return serialize_into<JSON>(dom, make()).size(); }, iterations);
+    auto b = benchmark([&] { return serialize_into<JSONDirect>(direct, make()).size(); }, iterations);
+    cout << "    " << left << setw(kLabelWidth - 4) << name
+         << right << fixed << setprecision(1)
+         << setw(kColWidth) << a.us * 1000.0 << setw(kColWidth) << b.us * 1000.0
+         << setw(kColWidth) << a.allocs << setw(kColWidth) << b.allocs << endl;
+}
+
+void bench_json_writer() {
+    print_header("JSON serialize_into", {"yyjson (ns)", "direct (ns)", "yyjson allocs", "direct allocs"});
+    json_writer_row("SmallStruct", [] {
+        return zmap<"int_value","double_value","string_value","array_value">(42, 3.14159, "hello world", smallArray);
+    }, 200000);
+
+    std::vector<double> doubles(1000);
+    for (std::size_t i = 0; i < doubles.size(); ++i) doubles[i] = std::sin(double(i)) * 1000.0;
+    json_writer_row("1000 doubles", [&] { return zmap<"values">(doubles); }, 2000);
+
+    std::vector<std::int64_t> ints(1000);
+    for (std::size_t i = 0; i < ints.size(); ++i) ints[i] = static_cast<std::int64_t>(i * i * 7919);
+    json_writer_row("1000 ints", [&] { return zmap<"values">(ints); }, 5000);
+
+    std::vector<string> strings(100, string(60, 'a') + "\"quoted\"\n" + string(30, 'b'));
+    json_writer_row("100 strings, escapes", [&] { return zmap<"values">(strings); }, 10000);
+
+    std::vector<std::byte> blob(64 * 1024, std::byte{0x5a});
+    json_writer_row("64 KB blob", [&] { return zmap<"blob">(std::span<const std::byte>(blob)); }, 2000);
+    cout << endl;
+}
+
+// -------------------------
+// JSON readers: yyjson document vs on-demand, on a ~200 KB document
+
+template <class P, class Read>
+Result json_read(std::string_view text, Read&& read, std::size_t iterations) {
+    return benchmark([&] {
+        const typename P::Deserializer d(text);
+        return read(d);
+    }, iterations);
+}
+
+ZBuffer json_records_document() {
+    std::vector<double> values(8);
+    dyn::Value::Array records;
+    for (int i = 0; i < 1000; ++i) {
+        for (std::size_t k = 0; k < values.size(); ++k) values[k] = std::sin(double(i * 8 + k)) * 100.0;
+        records.emplace_back(dyn::Value::Map{
+            {"seq", dyn::Value(i)},
+            {"name", dyn::Value("record-" + std::to_string(i))},
+            {"values", dyn::Value(dyn::Value::Array(values.begin(), values.end()))},
+            {"tags", dyn::Value(dyn::Value::Array{dyn::Value("alpha"), dyn::Value("beta\n")})}});
+    }
+    return serialize<JSONDirect>(zmap<"id", "records", "summary">(
+        12345, dyn::Value(std::move(records)), zmap<"count", "checksum">(1000, "c0ffee")));
+}
+
+void bench_json_reader() {
+    const auto buf = json_records_document();
+    const std::string_view text(reinterpret_cast<const char*>(buf.buf().data()), buf.size());
+
+    print_header("JSON read (" + std::to_string(text.size() / 1024) + " KB)",
+                 {"yyjson (us)", "lazy (us)", "yyjson allocs", "lazy allocs"});
+    auto row = [&](const string& name, auto&& read, std::size_t iterations) {
+        auto a = json_read<JSON>(text, read, iterations);
+        auto b = json_read<JSONLazy>(text, read, iterations);
+        cout << "    " << left << setw(kLabelWidth - 4) << name
+             << right << fixed << setprecision(1)
+             << setw(kColWidth) << a.us << setw(kColWidth) << b.us
+             << setw(kColWidth) << a.allocs << setw(kColWidth) << b.allocs << endl;
+    };
+    row("3 fields", [](const auto& d) {
+        return d["id"].asInt64() + std::int64_t(d["records"][500]["name"].asStringView().size()) +
+               std::int64_t(d["summary"]["checksum"].asStringView().size());
+    }, 500);
+    row("every record", [](const auto& d) {
+        double sum = 0;
+        for (auto&& r : d["records"].arrayElements()) sum += r["values"][3].asDouble();
+        return sum;
+    }, 200);
+    cout << endl;
+}
+
+// -------------------------
+// JSON parse: malloc'd documents vs ReadAllocator vs in-situ. yyjson calls
+// malloc, not operator new, so only time is shown. The in-situ columns
+// include copying the text into the buffer, which in-situ parsing consumes.
+
+void bench_json_parse() {
+    print_header("JSON parse", {"default (us)", "pooled (us)", "insitu (us)", "both (us)"});
+    auto row = [](const string& name, std::string_view text, std::size_t iterations) {
+        auto& alc = json::ReadAllocator::local();
+        std::vector<char> buf(text.size() + json::InsituPadding);
+        auto insitu = [&](auto&&... pool) {
+            std::memcpy(buf.data(), text.data(), text.size());
+            return JSON::Deserializer::insitu(buf, text.size(), pool...).isMap();
+        };
+        auto a = benchmark([&] { return JSON::Deserializer(text).isMap(); }, iterations);
+        auto b = benchmark([&] { return JSON::Deserializer(text, alc).isMap(); }, iterations);
+        auto c = benchmark([&] { return insitu(); }, iterations);
+        auto d = benchmark([&] { return insitu(alc); }, iterations);
+        cout << "    " << left << setw(kLabelWidth - 4) << name
+             << right << fixed << setprecision(2)
+             << setw(kColWidth) << a.us << setw(kColWidth) << b.us
+             << setw(kColWidth) << c.us << setw(kColWidth) << d.us << endl;
+    };
+    const auto small = serialize<JSONDirect>(
+        zmap<"int_value","double_value","string_value","array_value">(42, 3.14159, "hello world", smallArray));
+    row("SmallStruct", std::string_view(reinterpret_cast<const char*>(small.buf().data()), small.size()), 200000);
+    const auto big = json_records_document();
+    row("records (" + std::to_string(big.size() / 1024) + " KB)",
+        std::string_view(reinterpret_cast<const char*>(big.buf().data()), big.size()), 500);
+    cout << endl;
+}
+
+// -------------------------
+// JSON object lookup: yyjson's linear scan vs the key index, reading keys
+// spread over the object (1000 of them at most, so the scan stays bearable).
+
+void bench_json_key_index() {
+    print_header("JSON lookup by key", {"scan (ns)", "indexed (ns)", "build (us)"});
+    for (std::size_t nkeys : {std::size_t(10), std::size_t(1000), std::size_t(100000)}) {
+        dyn::Value::Map m;
+        for (std::size_t i = 0; i < nkeys; i++) m.emplace_back("field_" + std::to_string(i), static_cast<std::int64_t>(i));
+        const auto buf = serialize<JSONDirect>(dyn::Value::map(std::move(m)));
+        std::vector<string> keys;
+        const std::size_t step = std::max<std::size_t>(1, nkeys / 1000);
+        for (std::size_t i = 0; i < nkeys; i += step) keys.push_back("field_" + std::to_string(i));
+
+        JSON::Deserializer plain(buf.buf());
+        JSON::Deserializer indexed(buf.buf());
+        indexed.enableKeyIndex();
+        auto read_all = [&](const JSON::Deserializer& d) {
+            std::int64_t sum = 0;
+            for (const auto& k : keys) sum += d[k].asInt64();
+            return sum;
+        };
+        const std::size_t iterations = nkeys >= 100000 ? 5 : 200;
+        auto a = benchmark([&] { return read_all(plain); }, iterations, 2);
+        auto b = benchmark([&] { return read_all(indexed); }, iterations, 2);
+        auto c = benchmark([&] { return json::KeyIndex::Table(plain.raw_val()).find("field_0", json::key_hash("field_0")); },
+                           iterations, 2);
+        cout << "    " << left << setw(kLabelWidth - 4) << (std::to_string(nkeys) + " keys")
+             << right << fixed << setprecision(1)
+             << setw(kColWidth) << a.us * 1000.0 / keys.size() << setw(kColWidth) << b.us * 1000.0 / keys.size()
+             << setw(kColWidth) << c.us << endl;
+    }
+    cout << endl;
+}
+#endif
+
+int main() {
+    bench_zera_writer();
+    bench_zbuffer();
+    bench_segments();
+    bench_span_output();
+    bench_measure();
+#ifdef ZERIALIZE_HAS_MSGPACK
+    bench_ring();
+#endif
+    bench_base64();
+#ifdef ZERIALIZE_HAS_JSON
+    bench_json_writer();
+    bench_json_reader();
+    bench_json_parse();
+    bench_json_key_index();
+#endif
+    bench_raw_keys();
+    bench_zera_lookup();
+    bench_zera_tensor_read();
+    bench_typed_read();
+    bench_template_message();
+    bench_traversal();
+    bench_stream();
+    bench_archive();
+    cout << "Benchmark complete!" << endl;
+    return 0;
+}
@@ -0,0 +1,47 @@
+// Copy counting for benchmark_micro: memcpy/memmove calls that reach the C
+// library are counted, then forwarded to the real functions.
+//
+// This is its own translation unit so that no <cstring> (and no fortified
+// inline memcpy) is in scope. Only glibc-style symbol interposition is
+// supported; elsewhere copy_counting() is false. Copies the compiler inlines
+// (small fixed sizes, such as a 16-byte ValueRef) are not seen.
+
+#include <atomic>
+#include <cstddef>
+
+#if defined(__linux__) && defined(__GLIBC__)
+#include <dlfcn.h>
+
+namespace {
+
+std::atomic<std::size_t> g_copied{0};
+
+using CopyFn = void* (*)(void*, const void*, std::size_t);
+
+CopyFn next_symbol(const char* name) {
+    return reinterpret_cast<CopyFn>(dlsym(RTLD_NEXT, name));
+}
+
+} // namespace
+
+extern "C" void* memcpy(void* dst, const void* src, std::size_t n) noexcept {
+    static const CopyFn next = next_symbol("memcpy");
+    g_copied.fetch_add(n, std::memory_order_relaxed);
+    return next(dst, src, n);
+}
+
+extern "C" void* memmove(void* dst, const void* src, std::size_t n) noexcept {
+    static const CopyFn next = next_symbol("memmove");
+    g_copied.fetch_add(n, std::memory_order_relaxed);
+    return next(dst, src, n);
+}
+
+bool copy_counting() { return true; }
+std::size_t copied_bytes() { return g_copied.load(std::memory_order_relaxed); }
+
+#else
+
+bool copy_counting() { return false; }
+std::size_t copied_bytes() { return 0; }
+
+#endif
@@ -0,0 +1,258 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <zerialize/concepts.hpp>
+#include <zerialize/errors.hpp>
+#include <zerialize/mapped_buffer.hpp>
+#include <zerialize/serialize.hpp>
+
+namespace zerialize {
+namespace archive {
+
+/*
+ * Archives
+ * --------
+ * An append-only file of messages (typically Zera) with an offset index at the
+ * end, so a reader opens a recording of any size by mapping it and reading a
+ * fixed-size footer, then touches only the messages it asks for.
+ *
+ * Layout (integers little-endian):
+ *
+ *   message 0 | pad | message 1 | pad | ... | index | footer
+ *
+ *   • Every message starts at a multiple of MessageAlign (16) from the start
+ *     of the file, so Zera arenas stay aligned in a page-aligned mapping.
+ *   • index:  one { u64 offset, u64 size } entry per message.
+ *   • footer (32 bytes): magic "ZERIALAR", u32 version (1), u32 reserved (0),
+ *     u64 message count, u64 index offset.
+ *
+ * The index is written by ArchiveWriter::close() (or its destructor). An
+ * archive whose first writer never closed has no footer and does not open.
+ *
+ * Appending never rewrites bytes: the new messages go after the old index and
+ * footer, which stay behind as padding, and close() writes an index of every
+ * message and a new footer. A reader that finds no footer at the end of the
+ * file uses the last complete one before it, so a writer that dies while
+ * appending loses only the messages it added, not the archive.
+ */
+
+inline constexpr std::size_t MessageAlign = 16;
+inline constexpr std::size_t IndexEntrySize = 16;
+inline constexpr std::size_t FooterSize = 32;
+inline constexpr std::uint32_t Version = 1;
+inline constexpr char Magic[8] = {'Z','E','R','I','A','L','A','R'};
+
+namespace detail {
+
+inline std::uint64_t read_u64_le(const std::uint8_t* p) {
+    std::uint64_t v = 0;
+    for (int i = 7; i >= 0; --i) v = (v << 8) | p[i];
+    return v;
+}
+
+inline std::uint32_t read_u32_le(const std::uint8_t* p) {
+    return std::uint32_t(p[0]) | (std::uint32_t(p[1]) << 8) |
+           (std::uint32_t(p[2]) << 16) | (std::uint32_t(p[3]) << 24);
+}
+
+inline void append_u64_le(std::vector<std::uint8_t>& out, std::uint64_t v) {
+    for (int i = 0; i < 8; ++i) out.push_back(std::uint8_t(v >> (8 * i)));
+}
+
+inline void append_u32_le(std::vector<std::uint8_t>& out, std::uint32_t v) {
+    for (int i = 0; i < 4; ++i) out.push_back(std::uint8_t(v >> (8 * i)));
+}
+
+struct Footer {
+    std::uint64_t count = 0;
+    std::uint64_t index_ofs = 0;
+};
+
+// Validate the footer at the end of `file` and return it.
+inline Footer read_footer(std::span<const std::uint8_t> file) {
+    if (file.size() < FooterSize) throw DeserializationError("archive: file too small for a footer");
+    const std::uint8_t* f = file.data() + file.size() - FooterSize;
+    if (std::memcmp(f, Magic, sizeof(Magic)) != 0) {
+        throw DeserializationError("archive: bad footer magic (was the writer closed?)");
+    }
+    if (read_u32_le(f + 8) != Version) throw DeserializationError("archive: unsupported version");
+    Footer ft{ read_u64_le(f + 16), read_u64_le(f + 24) };
+    const std::uint64_t index_space = file.size() - FooterSize;
+    if (ft.index_ofs > index_space || ft.count > (index_space - ft.index_ofs) / IndexEntrySize ||
+        ft.index_ofs + ft.count * IndexEntrySize != index_space) {
+        throw DeserializationError("archive: index does not fit the file");
+    }
+    return ft;
+}
+
+// The footer at the end of `file`, or else the last valid one before it (the
+// file was being appended to when its writer stopped).
+inline Footer find_footer(std::span<const std::uint8_t> file) {
+    try {
+        return read_footer(file);
+    } catch (const DeserializationError&) {
+        for (std::size_t f = file.size() < FooterSize + 1 ? 0 : file.size() - FooterSize; f-- > 0;) {
+            if (std::memcmp(file.data() + f, Magic, sizeof(Magic)) != 0) continue;
+            try {
+                return read_footer(file.first(f + FooterSize));
+            } catch (const DeserializationError&) {
+                // Magic bytes inside a message; keep looking.
+            }
+        }
+        throw;
+    }
+}
+
+} // namespace detail
+
+/*
+ * ArchiveWriter<P>
+ * ----------------
+ * Appends messages to an archive file. write() encodes through a reused
+ * P::RootSerializer; append() takes bytes already encoded with P. Both return
+ * the message's index. Mode::Append reopens an archive and continues it after
+ * its last footer; close() writes the index of old and new messages.
+ *
+ * I/O failures throw SerializationError.
+ */
+template <Protocol P>
+requires ReusableRootSerializer<typename P::RootSerializer>
+class ArchiveWriter {
+    std::ofstream out_;
+    std::vector<std::uint64_t> index_; // offset, size pairs
+    std::uint64_t pos_ = 0;
+    typename P::RootSerializer rs_{};
+    bool open_ = false;
+
+    void put(const void* p, std::size_t n) {
+        out_.write(static_cast<const char*>(p), static_cast<std::streamsize>(n));
+        if (!out_) throw SerializationError("archive: write failed");
+        pos_ += n;
+    }
+
+public:
+    enum class Mode { Create, Append };
+
+    explicit ArchiveWriter(const std::filesystem::path& path, Mode mode = Mode::Create) {
+        if (mode == Mode::Append && std::filesystem::exists(path)) {
+            // Leave the file as it is, so it stays readable until close()
+            // writes an index of old and new messages after the new ones.
+            {
+                const auto file = MappedBuffer::open(path.string());
+                const auto ft = detail::find_footer(file.buf());
+                const std::uint8_t* ix = file.data() + ft.index_ofs;
+                index_.reserve(2 * ft.count);
+                for (std::uint64_t i = 0; i < 2 * ft.count; ++i) index_.push_back(detail::read_u64_le(ix + 8 * i));
+                pos_ = file.size();
+            }
+            out_.open(path, std::ios::binary | std::ios::app);
+        } else {
+            out_.open(path, std::ios::binary | std::ios::trunc);
+        }
+        if (!out_) throw SerializationError("archive: cannot open " + path.string());
+        open_ = true;
+    }
+
+    ArchiveWriter(const ArchiveWriter&) = delete;
+    ArchiveWriter& operator=(const ArchiveWriter&) = delete;
+
+    // Writes the index if close() was not called; errors are swallowed here.
+    ~ArchiveWriter() {
+        try { close(); } catch (...) {}
+    }
+
+    template <class RootType>
+    std::size_t write(RootType&& rootValue) {
+        return append(serialize_into<P>(rs_, std::forward<RootType>(rootValue)));
+    }
+
+    std::size_t append(std::span<const std::uint8_t> message) {
+        if (!open_) throw SerializationError("archive: writer is closed");
+        static constexpr std::uint8_t zeros[MessageAlign] = {};
+        if (const std::size_t pad = (MessageAlign - pos_ % MessageAlign) % MessageAlign) put(zeros, pad);
+        index_.push_back(pos_);
+        index_.push_back(message.size());
+        put(message.data(), message.size());
+        return index_.size() / 2 - 1;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return index_.size() / 2; }
+
+    // Write the index and footer and close the file. Idempotent.
+    void close() {
+        if (!open_) return;
+        open_ = false;
+        std::vector<std::uint8_t> tail;
+        tail.reserve(index_.size() * 8 + FooterSize);
+        for (std::uint64_t v : index_) detail::append_u64_le(tail, v);
+        tail.insert(tail.end(), Magic, Magic + sizeof(Magic));
+        detail::append_u32_le(tail, Version);
+        detail::append_u32_le(tail, 0);
+        detail::append_u64_le(tail, index_.size() / 2);
+        detail::append_u64_le(tail, pos_);
+        put(tail.data(), tail.size());
+        out_.close();
+        if (!out_) throw SerializationError("archive: close failed");
+    }
+};
+
+/*
+ * ArchiveReader<P>
+ * ----------------
+ * Opens an archive by mapping it (or over bytes the caller keeps alive) and
+ * validating only the footer; see the fallback above for a file whose last
+ * writer did not close. operator[](i) returns a P::Deserializer over
+ * message i in place; its bounds are checked when it is accessed.
+ */
+template <Protocol P>
+class ArchiveReader {
+    MappedBuffer file_; // empty when reading borrowed bytes
+    std::span<const std::uint8_t> bytes_;
+    const std::uint8_t* index_ = nullptr;
+    std::size_t count_ = 0;
+
+    void init() {
+        const auto ft = detail::find_footer(bytes_);
+        index_ = bytes_.data() + ft.index_ofs;
+        count_ = static_cast<std::size_t>(ft.count);
+    }
+
+public:
+    explicit ArchiveReader(const std::filesystem::path& path)
+        : file_(MappedBuffer::open(path.string())), bytes_(file_.buf())
+    {
+        file_.advise(MappedBuffer::Access::Random);
+        init();
+    }
+
+    // Borrowing: `bytes` must outlive the reader and its views.
+    explicit ArchiveReader(std::span<const std::uint8_t> bytes) : bytes_(bytes) { init(); }
+
+    [[nodiscard]] std::size_t size() const noexcept { return count_; }
+
+    // Encoded bytes of message i.
+    std::span<const std::uint8_t> message_bytes(std::size_t i) const {
+        if (i >= count_) throw DeserializationError("archive: message index out of range");
+        const std::uint64_t ofs = detail::read_u64_le(index_ + i * IndexEntrySize);
+        const std::uint64_t len = detail::read_u64_le(index_ + i * IndexEntrySize + 8);
+        const std::uint64_t limit = static_cast<std::uint64_t>(index_ - bytes_.data());
+        if (ofs > limit || len > limit - ofs) throw DeserializationError("archive: index entry out of bounds");
+        return bytes_.subspan(static_cast<std::size_t>(ofs), static_cast<std::size_t>(len));
+    }
+
+    typename P::Deserializer operator[](std::size_t i) const {
+        return typename P::Deserializer(message_bytes(i));
+    }
+};
+
+} // namespace archive
+} // namespace zerialize
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <zerialize/zbuffer.hpp>
+
+namespace zerialize {
+
+/*
+ * BufferPool
+ * ----------
+ * A free list of byte vectors for encode → send → release loops. A pooled
+ * ZBuffer gives its vector, capacity intact, back to the pool when it is
+ * destroyed, and the next message is written into it. Once the pool holds
+ * as many vectors as there are buffers in flight, encoding stops calling
+ * malloc and free.
+ *
+ *   zerialize::BufferPool pool;
+ *   for (const auto& s : samples) {
+ *       ZBuffer buf = zerialize::serialize<Zera>(pool, zmap<"seq">(s.seq));
+ *       queue.push(std::move(buf));   // the vector returns to `pool` when released
+ *   }
+ *
+ * Serializers that write into a std::vector (Zera, CBOR) take a pool in
+ * their constructor: finish() then returns a pooled ZBuffer and takes the
+ * next output vector from the pool. serialize<P>(pool, value) does this for
+ * one message.
+ *
+ * A pool is shared and thread-safe by default: buffers may be released on
+ * any thread. BufferPool::local() is a per-thread pool without locking; its
+ * buffers must be destroyed on the thread that made them. Either way the
+ * pool must outlive its buffers.
+ *
+ * At most `max_buffers` vectors are kept, and none larger than
+ * `max_capacity` bytes; anything beyond that is freed as usual.
+ */
+class BufferPool {
+public:
+    static constexpr std::size_t DefaultMaxBuffers = 64;
+    static constexpr std::size_t DefaultMaxCapacity = std::size_t(16) << 20;
+
+    explicit BufferPool(std::size_t max_buffers = DefaultMaxBuffers,
+                        std::size_t max_capacity = DefaultMaxCapacity,
+                        bool thread_safe = true)
+        : max_buffers_(max_buffers), max_capacity_(max_capacity), thread_safe_(thread_safe) {}
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    // This thread's pool (not locked). Its buffers must be released on this thread.
+    static BufferPool& local() {
+        thread_local BufferPool pool(DefaultMaxBuffers, DefaultMaxCapacity, false);
+        return pool;
+    }
+
+    // An empty vector, with whatever capacity a released one had.
+    std::vector<std::uint8_t> acquire() {
+        Guard g(*this);
+        if (free_.empty()) return {};
+        std::vector<std::uint8_t> v = std::move(free_.back());
+        free_.pop_back();
+        return v;
+    }
+
+    // Return a vector to the pool (or free it, if the pool is full).
+    void release(std::vector<std::uint8_t>&& v) noexcept {
+        if (v.capacity() == 0 || v.capacity() > max_capacity_) return;
+        v.clear();
+        Guard g(*this);
+        if (free_.size() >= max_buffers_) return;
+        if (free_.capacity() == free_.size()) {
+            try { free_.reserve(free_.empty() ? 8 : 2 * free_.size()); }
+            catch (...) { return; }
+        }
+        free_.push_back(std::move(v));
+    }
+
+    // A ZBuffer over `v` that hands it back to this pool on destruction.
+    ZBuffer wrap(std::vector<std::uint8_t>&& v) {
+        return ZBuffer(std::move(v), &BufferPool::recycle, this);
+    }
+
+    // Number of vectors currently available.
+    std::size_t size() const {
+        Guard g(*this);
+        return free_.size();
+    }
+
+private:
+    struct Guard {
+        const BufferPool& p;
+        explicit Guard(const BufferPool& pool) : p(pool) { if (p.thread_safe_) p.mu_.lock(); }
+        ~Guard() { if (p.thread_safe_) p.mu_.unlock(); }
+    };
+
+    static void recycle(void* context, std::vector<std::uint8_t>&& v) noexcept {
+        static_cast<BufferPool*>(context)->release(std::move(v));
+    }
+
+    std::vector<std::vector<std::uint8_t>> free_;
+    std::size_t max_buffers_;
+    std::size_t max_capacity_;
+    bool thread_safe_;
+    mutable std::mutex mu_;
+};
+
+} // namespace zerialize
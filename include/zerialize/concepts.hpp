@@ -14,11 +14,33 @@
 //                       scalar accessors, map/array/blobs.
 //   • Writer          — the minimal serializer surface (primitives,
 //                       begin/end array/map, keys, etc.).
+//   • TypedArrayWriter / TypedArrayReader — optional extensions for
+//                       protocols that encode dense tensors natively.
+//   • BlobDecodeReader — optional extension: decode an encoded blob (JSON's
+//                       base64) into caller memory.
+//   • RawKeyWriter    — optional extension: write a compile-time map key
+//                       from bytes encoded at compile time.
+//   • ArrayCursorReader / MapCursorReader — optional one-pass child
+//                       iteration for readers whose operator[] is not O(1).
+//   • HashedKeyReader — optional key lookup with a precomputed hash, for
+//                       readers whose maps may carry a hash index.
 //   • Builder         — a small tag-based concept for DSL builders
 //                       (zmap/zvec/etc.) that emit into a Writer.
 //   • RootSerializer  — default-constructible, finish() → ZBuffer.
+//   • ReusableRootSerializer — RootSerializer that can reset() and
+//                       finish_view() so one instance encodes many messages.
+//   • SegmentedRootSerializer — optional: RootSerializer that can return a
+//                       message as segments referencing large blobs in place.
 //   • SerializerFor   — Writer constructible from RootSerializer&.
 //   • Protocol        — ties the above together and requires a Name.
+//   • SelfDelimitingProtocol — optional: Protocol whose messages carry
+//                       their own length, so they can be concatenated.
+//   • PatchableProtocol — optional: Protocol that can overwrite a scalar
+//                       in an encoded message in place (TemplateMessage).
+//   • SpanOutputProtocol — optional: Protocol that can encode straight into
+//                       a caller-provided span (serialize_to).
+//   • MeasurableProtocol — optional: Protocol whose exact encoded size can be
+//                       counted before encoding (measure).
 //
 // Notes:
 //
@@ -45,10 +67,13 @@
 #include <ranges>        // std::ranges::forward_range, size, etc.
 #include <string_view>
 #include <span>
+#include <array>
 #include <cstddef>
 #include <cstdint>
 
+#include <zerialize/segments.hpp>
 #include <zerialize/zbuffer.hpp>
+#include <zerialize/internals/fixed_string.hpp>
 
 namespace zerialize {
 
@@ -157,6 +182,103 @@ concept Writer =
         { w.end_map() }                  -> std::same_as<void>;
     };
 
+//──────────────────────────  Compile-time keys  ─────────────────────────
+//
+// Optional. zmap's keys are known at compile time, so a binary writer can
+// encode each one (length header and bytes) once, at compile time, and emit
+// it with a single copy. key_raw<K>() is equivalent to key(K.view()).
+//
+template<class W>
+concept RawKeyWriter = Writer<W> &&
+    requires (W& w) {
+        { w.template key_raw<fixed_string{"k"}>() } -> std::same_as<void>;
+    };
+
+//────────────────────────────  Typed arrays  ───────────────────────────
+//
+// Optional extension for dense numeric tensors. `dtype` is the zerialize
+// tensor dtype code (tensor_dtype_index in tensor/utils.hpp). A writer may
+// decline a dtype via supports_typed_array(); write_typed_array() then
+// falls back to the portable [dtype, shape, blob] array.
+//
+inline constexpr std::size_t TypedArrayMaxRank = 8;
+
+template<class W>
+concept TypedArrayWriter = Writer<W> &&
+    requires (W& w, int dtype,
+              std::span<const std::uint64_t> shape,
+              std::span<const std::byte> bytes) {
+        { w.supports_typed_array(dtype) }        -> std::same_as<bool>;
+        { w.typed_array(dtype, shape, bytes) }   -> std::same_as<void>;
+    };
+
+// A typed array as seen by a reader: dtype, shape and the raw element bytes.
+// `data` is a non-owning view into the reader's buffer.
+struct TypedArrayView {
+    int dtype = -1;
+    std::uint32_t rank = 0;
+    std::array<std::uint64_t, TypedArrayMaxRank> dims{};
+    std::span<const std::byte> data{};
+
+    std::span<const std::uint64_t> shape() const { return {dims.data(), rank}; }
+};
+
+template<class V>
+concept TypedArrayReader =
+    requires (const V& v) {
+        { v.isTypedArray() } -> std::same_as<bool>;
+        { v.asTypedArray() } -> std::same_as<TypedArrayView>;
+    };
+
+// Optional. A reader that stores blobs encoded (JSON's base64) can decode one
+// into memory the caller owns instead of returning an owning vector:
+// blobSize() is the decoded byte count, and readBlobInto(dst) writes those
+// bytes to the front of dst and returns the count. The tensor helpers use it
+// to decode straight into the tensor's own storage.
+template<class V>
+concept BlobDecodeReader =
+    requires (const V& v, std::span<std::byte> dst) {
+        { v.blobSize() } -> std::same_as<std::size_t>;
+        { v.readBlobInto(dst) } -> std::same_as<std::size_t>;
+    };
+
+//──────────────────────────────  Cursors  ──────────────────────────────
+//
+// Optional sequential access. Readers of length-prefixed formats (MsgPack,
+// CBOR) can only find child i by skipping the i children before it, so a
+// loop over operator[] is quadratic. Such readers expose arrayElements()
+// (a sized forward range of child views) and mapEntries() (a sized forward
+// range of pair<string_view, child view>); generic traversal such as
+// write_value() prefers them when present.
+//
+template<class V>
+concept ArrayCursorReader =
+    requires (const V& v) {
+        { v.arrayElements() } -> std::ranges::forward_range;
+        { v.arrayElements().size() } -> std::convertible_to<std::size_t>;
+    };
+
+template<class V>
+concept MapCursorReader =
+    requires (const V& v) {
+        { v.mapEntries() } -> std::ranges::forward_range;
+        { v.mapEntries().size() } -> std::convertible_to<std::size_t>;
+    };
+
+// Optional. A reader whose maps may carry a hash index (Zera, JSON) exposes its
+// hash function, constexpr so that compile-time keys hash at compile time,
+// and a lookup that takes the hash: find(key, key_hash(key)) returns an
+// optional child view. hasKeyIndex() says whether this map has the index;
+// without it find() is a linear scan like operator[].
+template<class V>
+concept HashedKeyReader =
+    requires (const V& v, std::string_view key, std::uint32_t hash) {
+        { V::key_hash(key) } -> std::same_as<std::uint32_t>;
+        { v.hasKeyIndex() } -> std::same_as<bool>;
+        { v.find(key, hash).has_value() } -> std::same_as<bool>;
+        { *v.find(key, hash) };
+    };
+
 //──────────────────────────────  Builders  ─────────────────────────────
 //
 // A Builder is a callable that emits exactly one value into a Writer.
@@ -183,6 +305,30 @@ concept RootSerializer =
         { rs.finish() } -> std::same_as<ZBuffer>;
     };
 
+// A RootSerializer that can be reused across messages:
+//   reset()       discards the current message but keeps allocated capacity,
+//   finish_view() finalizes and returns the bytes without giving up storage;
+//                 the span is valid until the next reset() or destruction.
+template<class RS>
+concept ReusableRootSerializer =
+    RootSerializer<RS> &&
+    requires (RS& rs) {
+        { rs.reset() };
+        { rs.finish_view() } -> std::same_as<std::span<const std::uint8_t>>;
+    };
+
+// Optional. A RootSerializer that can leave large blobs where they are:
+//   set_blob_reference_threshold(n) blobs of at least n bytes are referenced,
+//   finish_segments()               finalizes into a SegmentedBuffer whose
+//                                   segments point at those blobs.
+template<class RS>
+concept SegmentedRootSerializer =
+    RootSerializer<RS> &&
+    requires (RS& rs, std::size_t n) {
+        { rs.set_blob_reference_threshold(n) };
+        { rs.finish_segments() } -> std::same_as<SegmentedBuffer>;
+    };
+
 // Writer constructible from RootSerializer&.
 template<class S, class RS>
 concept SerializerFor =
@@ -210,4 +356,70 @@ concept Protocol =
     // A human-readable name
     requires { { P::Name } -> std::convertible_to<const char*>; };
 
+// Optional. A protocol whose encoding of one value determines its own length
+// (MsgPack, CBOR) exposes frame_size(bytes): the size of the message at the
+// start of `bytes`. It throws DeserializationError when `bytes` is malformed
+// or ends mid-message, and may return more than bytes.size() for a message
+// whose length is known before its payload has arrived. Such messages can be
+// framed by plain concatenation (see stream.hpp).
+template<class P>
+concept SelfDelimitingProtocol =
+    Protocol<P> &&
+    requires (std::span<const std::uint8_t> b) {
+        { P::frame_size(b) } -> std::convertible_to<std::size_t>;
+    };
+
+// Optional. A protocol whose writer, given the widest value of each scalar
+// kind (int64 min, uint64 max, a double that is not a float, any bool),
+// emits an encoding whose size depends only on the kind. Its readers expose
+// raw_view(), the bytes of the value they view, and P::patch_*(slot, v)
+// overwrite such a slot with a new value of the same kind. They throw
+// SerializationError if `slot` is not a full-width scalar of that kind.
+template<class P>
+concept PatchableProtocol =
+    Protocol<P> &&
+    requires (const typename P::Deserializer& v, std::span<std::uint8_t> slot,
+              std::int64_t i, std::uint64_t u, double d) {
+        { v.raw_view() } -> std::same_as<std::span<const std::uint8_t>>;
+        { P::patch_bool(slot, true) } -> std::same_as<void>;
+        { P::patch_int64(slot, i) }   -> std::same_as<void>;
+        { P::patch_uint64(slot, u) }  -> std::same_as<void>;
+        { P::patch_double(slot, d) }  -> std::same_as<void>;
+    };
+
+// Optional. A protocol that can encode into memory the caller owns:
+//   P::SpanRootSerializer  constructed from a std::span<std::byte>; a
+//                          ReusableRootSerializer whose finish_view() points
+//                          into that span, and throws OutputOverflow (with
+//                          the size the message needs) if it did not fit.
+//                          reset(span) moves it to another span.
+//   P::SpanSerializer      the Writer over it.
+template<class P>
+concept SpanOutputProtocol =
+    Protocol<P> &&
+    requires { typename P::SpanRootSerializer; typename P::SpanSerializer; } &&
+    std::constructible_from<typename P::SpanRootSerializer, std::span<std::byte>> &&
+    SerializerFor<typename P::SpanSerializer, typename P::SpanRootSerializer> &&
+    requires (typename P::SpanRootSerializer& rs, std::span<std::byte> dst) {
+        { rs.reset() };
+        { rs.reset(dst) };
+        { rs.finish_view() } -> std::same_as<std::span<const std::uint8_t>>;
+    };
+
+// Optional. A protocol whose message size follows from the values alone:
+//   P::SizeCounter  a default-constructible Writer that writes nothing and
+//                   whose size() is the byte count the RootSerializer would
+//                   produce for the same calls. It must not allocate (beyond,
+//                   at most, unusually deep nesting).
+template<class P>
+concept MeasurableProtocol =
+    Protocol<P> &&
+    requires { typename P::SizeCounter; } &&
+    std::default_initializable<typename P::SizeCounter> &&
+    Writer<typename P::SizeCounter> &&
+    requires (typename P::SizeCounter& c) {
+        { c.size() } -> std::same_as<std::size_t>;
+        { c.reset() };
+    };
+
 } // namespace zerialize
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <zerialize/concepts.hpp>
+#include <zerialize/errors.hpp>
+#include <zerialize/internals/deserializers.hpp>
+#include <zerialize/internals/fixed_string.hpp>
+
+namespace zerialize {
+
+/*
+ * deserialize.hpp
+ * ---------------
+ * The read side of serialize(): decode a Reader into C++ values.
+ *
+ *   auto v = std::vector<int>{};
+ *   deserialize(reader, v);                       // fill in place
+ *   auto m = deserialize<std::map<std::string, double>>(reader);
+ *
+ * Customization point: a user type T provides
+ *
+ *   template<zerialize::Reader V> void deserialize(const V& v, T& out);
+ *
+ * in T's namespace (found by ADL), exactly like its serialize(). read_map is
+ * the mirror of zmap for writing such overloads:
+ *
+ *   template<zerialize::Reader V>
+ *   void deserialize(const V& v, User& u) {
+ *       zerialize::read_map<"name", "age">(v, u.name, u.age);
+ *   }
+ *
+ * read_map walks the map once, in the order the reader stores it, and
+ * dispatches each key to its field. Reading a struct from MsgPack, CBOR or
+ * Zera (where lookups are linear scans) costs one pass instead of one scan
+ * per field. Entries are usually in field order, so the next expected key is
+ * tried first. The exception is a hash-indexed map (HashedKeyReader: Zera
+ * objects above the index threshold, large JSON objects after
+ * enableKeyIndex()), which is probed once per field with hashes computed at
+ * compile time. Unknown keys are skipped, and a repeated key is read from
+ * its first entry, as operator[] does; a field whose key is absent throws
+ * DeserializationError, unless it is a std::optional, which is reset.
+ */
+
+namespace detail {
+
+template<class T> inline constexpr bool is_optional_v = false;
+template<class T> inline constexpr bool is_optional_v<std::optional<T>> = true;
+
+template<fixed_string... Keys>
+struct key_list {
+    static constexpr std::array<std::string_view, sizeof...(Keys)> views{ Keys.view()... };
+};
+
+} // namespace detail
+
+// Decode `v` into a fresh T (default-constructed, then filled in).
+template<class T, Reader V>
+T deserialize(const V& v) {
+    T out{};
+    using zerialize::deserialize;
+    deserialize(v, out);
+    return out;
+}
+
+// Decode a map with the given compile-time keys into `fields`, in one pass.
+template<fixed_string... Keys, Reader V, class... Ts>
+void read_map(const V& v, Ts&... fields) {
+    static_assert(sizeof...(Keys) == sizeof...(Ts),
+                  "read_map: number of keys must match number of fields");
+
+    constexpr std::size_t N = sizeof...(Keys);
+    using K = detail::key_list<Keys...>;
+    auto targets = std::tie(fields...);
+    std::array<bool, N> seen{};
+
+    bool done = false;
+    if constexpr (HashedKeyReader<V>) {
+        // A hash-indexed map answers each key in one probe, and the hashes of
+        // compile-time keys are constants: cheaper than walking all entries.
+        if (v.hasKeyIndex()) {
+            [&]<std::size_t... I>(std::index_sequence<I...>) {
+                ([&] {
+                    constexpr std::uint32_t hash = V::key_hash(K::views[I]);
+                    if (auto child = v.find(K::views[I], hash)) {
+                        using zerialize::deserialize;
+                        deserialize(*child, std::get<I>(targets));
+                        seen[I] = true;
+                    }
+                }(), ...);
+            }(std::make_index_sequence<N>{});
+            done = true;
+        }
+    }
+
+    if (!done) {
+        std::size_t expect = 0;
+        detail::for_each_entry(v, [&](std::string_view k, const auto& child) {
+            std::size_t idx = N;
+            if (expect < N && K::views[expect] == k) {
+                idx = expect;
+            } else {
+                for (std::size_t i = 0; i < N; ++i) {
+                    if (K::views[i] == k) { idx = i; break; }
+                }
+                if (idx == N) return; // not one of ours
+            }
+            if (seen[idx]) return; // duplicate key: the first wins, as in operator[]
+            seen[idx] = true;
+            expect = idx + 1;
+
+            // Runtime index → compile-time field.
+            [&]<std::size_t... I>(std::index_sequence<I...>) {
+                using zerialize::deserialize;
+                (void)((I == idx ? (deserialize(child, std::get<I>(targets)), true) : false) || ...);
+            }(std::make_index_sequence<N>{});
+        });
+    }
+
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+        ([&] {
+            if (seen[I]) return;
+            auto& field = std::get<I>(targets);
+            if constexpr (detail::is_optional_v<std::remove_cvref_t<decltype(field)>>) {
+                field.reset();
+            } else {
+                throw DeserializationError("read_map: missing key: " + std::string(K::views[I]));
+            }
+        }(), ...);
+    }(std::make_index_sequence<N>{});
+}
+
+} // namespace zerialize
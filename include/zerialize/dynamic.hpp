@@ -33,10 +33,13 @@ struct WriterView {
     void (*end_arr_fn)(void*){};
     void (*begin_map_fn)(void*, std::size_t){};
     void (*end_map_fn)(void*){};
+    // Optional typed-array extension; null when the underlying Writer lacks it.
+    bool (*typed_supported_fn)(void*, int){};
+    void (*typed_fn)(void*, int, std::span<const std::uint64_t>, std::span<const std::byte>){};
 
     template<zerialize::Writer W>
     static WriterView make(W& w) {
-        return WriterView{
+        WriterView v{
             &w,
             [](void* c){ static_cast<W*>(c)->null(); },
             [](void* c, bool b){ static_cast<W*>(c)->boolean(b); },
@@ -51,6 +54,13 @@ struct WriterView {
             [](void* c, std::size_t n){ static_cast<W*>(c)->begin_map(n); },
             [](void* c){ static_cast<W*>(c)->end_map(); }
         };
+        if constexpr (zerialize::TypedArrayWriter<W>) {
+            v.typed_supported_fn = [](void* c, int dtype){ return static_cast<W*>(c)->supports_typed_array(dtype); };
+            v.typed_fn = [](void* c, int dtype, std::span<const std::uint64_t> shape, std::span<const std::byte> bytes){
+                static_cast<W*>(c)->typed_array(dtype, shape, bytes);
+            };
+        }
+        return v;
     }
 
     void null()               { null_fn(ctx); }
@@ -65,6 +75,10 @@ struct WriterView {
     void end_array() { end_arr_fn(ctx); }
     void begin_map(std::size_t n){ begin_map_fn(ctx, n); }
     void end_map(){ end_map_fn(ctx); }
+    bool supports_typed_array(int dtype){ return typed_supported_fn && typed_supported_fn(ctx, dtype); }
+    void typed_array(int dtype, std::span<const std::uint64_t> shape, std::span<const std::byte> bytes){
+        typed_fn(ctx, dtype, shape, bytes);
+    }
 };
 
 // Erased serializable payload that will call serialize(v, WriterView).
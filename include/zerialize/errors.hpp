@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <stdexcept>
 #include <string>
 
@@ -13,6 +14,24 @@ public:
     SerializationError(const std::string& msg) : std::runtime_error(msg) { }
 };
 
+// A message did not fit the caller-provided span it was written into.
+// required() is the size of the whole message, so a retry into a span of at
+// least that size succeeds.
+class OutputOverflow : public SerializationError {
+public:
+    OutputOverflow(std::size_t required, std::size_t available)
+        : SerializationError("output span too small: need " + std::to_string(required) +
+                             " bytes, have " + std::to_string(available))
+        , required_(required), available_(available) { }
+
+    std::size_t required() const { return required_; }
+    std::size_t available() const { return available_; }
+
+private:
+    std::size_t required_;
+    std::size_t available_;
+};
+
 class DeserializationError : public std::runtime_error {
 public:
     DeserializationError(const std::string& msg) : std::runtime_error(msg) { }
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <zerialize/concepts.hpp>
+#include <zerialize/deserialize.hpp>
+#include <zerialize/zbuilders.hpp>
+
+/*
+ * fields.hpp
+ * ----------
+ * ZERIALIZE_FIELDS(Type, field...) declares a struct's fields once and
+ * generates both its serialize() and deserialize() overloads:
+ *
+ *   namespace app {
+ *     struct User { std::string name; int age; };
+ *     ZERIALIZE_FIELDS(User, name, age)
+ *   }
+ *
+ *   auto buf = serialize<MsgPack>(user);                  // {"name":..,"age":..}
+ *   auto u   = deserialize<app::User>(MsgPack::Deserializer(buf.buf()));
+ *
+ * It expands to exactly what you would write by hand:
+ *
+ *   zmap<"name", "age">(v.name, v.age)(w);       // serialize
+ *   read_map<"name", "age">(v, out.name, out.age); // deserialize
+ *
+ * The keys are the member names as compile-time fixed_strings, so both sides
+ * get every key-level optimization of zmap and read_map: no runtime key
+ * strings, a single pass over the map when reading, and compile-time key
+ * hashes for indexed Zera objects.
+ *
+ * Use it at namespace scope, in the type's own namespace (the overloads are
+ * found by ADL). Members may be any type with serialize/deserialize overloads,
+ * including other ZERIALIZE_FIELDS types. Up to 256 fields. The macro is not
+ * exported by the zerialize module; include this header to use it.
+ */
+
+// ZERIALIZE_FOR_EACH(m, a, b, c) → m(a), m(b), m(c)
+#define ZERIALIZE_PARENS_ ()
+#define ZERIALIZE_EXPAND_(...) ZERIALIZE_EXPAND4_(ZERIALIZE_EXPAND4_(ZERIALIZE_EXPAND4_(ZERIALIZE_EXPAND4_(__VA_ARGS__))))
+#define ZERIALIZE_EXPAND4_(...) ZERIALIZE_EXPAND3_(ZERIALIZE_EXPAND3_(ZERIALIZE_EXPAND3_(ZERIALIZE_EXPAND3_(__VA_ARGS__))))
+#define ZERIALIZE_EXPAND3_(...) ZERIALIZE_EXPAND2_(ZERIALIZE_EXPAND2_(ZERIALIZE_EXPAND2_(ZERIALIZE_EXPAND2_(__VA_ARGS__))))
+#define ZERIALIZE_EXPAND2_(...) ZERIALIZE_EXPAND1_(ZERIALIZE_EXPAND1_(ZERIALIZE_EXPAND1_(ZERIALIZE_EXPAND1_(__VA_ARGS__))))
+#define ZERIALIZE_EXPAND1_(...) __VA_ARGS__
+#define ZERIALIZE_FOR_EACH(m, ...) __VA_OPT__(ZERIALIZE_EXPAND_(ZERIALIZE_FOR_EACH_HELPER_(m, __VA_ARGS__)))
+#define ZERIALIZE_FOR_EACH_HELPER_(m, a, ...) m(a) __VA_OPT__(, ZERIALIZE_FOR_EACH_AGAIN_ ZERIALIZE_PARENS_ (m, __VA_ARGS__))
+#define ZERIALIZE_FOR_EACH_AGAIN_() ZERIALIZE_FOR_EACH_HELPER_
+
+#define ZERIALIZE_FIELD_KEY_(f) #f
+#define ZERIALIZE_FIELD_IN_(f) zerialize_in_.f
+#define ZERIALIZE_FIELD_OUT_(f) zerialize_out_.f
+
+#define ZERIALIZE_FIELDS(Type, ...)                                                        \
+    template<::zerialize::Writer ZerializeW_>                                              \
+    void serialize(const Type& zerialize_in_, ZerializeW_& zerialize_w_) {                 \
+        ::zerialize::zmap<ZERIALIZE_FOR_EACH(ZERIALIZE_FIELD_KEY_, __VA_ARGS__)>(          \
+            ZERIALIZE_FOR_EACH(ZERIALIZE_FIELD_IN_, __VA_ARGS__))(zerialize_w_);           \
+    }                                                                                      \
+    template<::zerialize::Reader ZerializeV_>                                              \
+    void deserialize(const ZerializeV_& zerialize_v_, Type& zerialize_out_) {              \
+        ::zerialize::read_map<ZERIALIZE_FOR_EACH(ZERIALIZE_FIELD_KEY_, __VA_ARGS__)>(      \
+            zerialize_v_, ZERIALIZE_FOR_EACH(ZERIALIZE_FIELD_OUT_, __VA_ARGS__));          \
+    }
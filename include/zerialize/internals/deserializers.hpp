@@ -0,0 +1,172 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <list>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include <zerialize/concepts.hpp>
+#include <zerialize/errors.hpp>
+
+//──────────────────────────────────────────────────────────────────────────────
+//  deserializers.hpp
+//
+//  The read-side mirror of serializers.hpp: default `deserialize(reader, out)`
+//  overloads for primitives, strings, blobs and the same STL containers. Each
+//  takes a Reader and assigns into `out`, reusing its storage where it can
+//  (containers are cleared, not reallocated).
+//
+//  User types provide their own `deserialize(const V&, T&)` via ADL, in the
+//  same namespace as T (see read_map in deserialize.hpp). Containers recurse
+//  with `using zerialize::deserialize;` so those overloads are found.
+//──────────────────────────────────────────────────────────────────────────────
+
+namespace zerialize {
+
+namespace detail {
+
+template<class T, Reader V>
+T read_integer(const V& v) {
+    if constexpr (std::is_signed_v<T>) {
+        // Some writers store every non-negative integer as unsigned.
+        if (v.isUInt()) {
+            const std::uint64_t x = v.asUInt64();
+            if (x > static_cast<std::uint64_t>(std::numeric_limits<T>::max())) {
+                throw DeserializationError("deserialize: integer out of range");
+            }
+            return static_cast<T>(x);
+        }
+        const std::int64_t x = v.asInt64();
+        if (x < std::numeric_limits<T>::min() || x > std::numeric_limits<T>::max()) {
+            throw DeserializationError("deserialize: integer out of range");
+        }
+        return static_cast<T>(x);
+    } else {
+        const std::uint64_t x = v.asUInt64();
+        if (x > std::numeric_limits<T>::max()) {
+            throw DeserializationError("deserialize: integer out of range");
+        }
+        return static_cast<T>(x);
+    }
+}
+
+// Integers are accepted where a float is expected: another producer may well
+// have written 2.0 as 2.
+template<Reader V>
+double read_floating(const V& v) {
+    if (v.isFloat()) return v.asDouble();
+    if (v.isUInt()) return static_cast<double>(v.asUInt64());
+    if (v.isInt()) return static_cast<double>(v.asInt64());
+    return v.asDouble(); // throws the reader's type error
+}
+
+// Calls f(child) for each array element, in order.
+template<Reader V, class F>
+void for_each_element(const V& v, F&& f) {
+    if (!v.isArray()) throw DeserializationError("deserialize: value is not an array");
+    if constexpr (ArrayCursorReader<V>) {
+        for (auto&& child : v.arrayElements()) f(child);
+    } else {
+        const std::size_t n = v.arraySize();
+        for (std::size_t i = 0; i < n; ++i) f(v[i]);
+    }
+}
+
+// Calls f(key, child) for each map entry, in the order the reader exposes.
+template<Reader V, class F>
+void for_each_entry(const V& v, F&& f) {
+    if (!v.isMap()) throw DeserializationError("deserialize: value is not a map");
+    if constexpr (MapCursorReader<V>) {
+        for (auto&& [k, child] : v.mapEntries()) f(std::string_view(k), child);
+    } else {
+        for (std::string_view k : v.mapKeys()) f(k, v[k]);
+    }
+}
+
+} // namespace detail
+
+// Primitive deserialize functions
+template<Reader V> void deserialize(const V& v, bool& out) { out = v.asBool(); }
+template<Reader V> void deserialize(const V& v, char& out) { out = detail::read_integer<char>(v); }
+template<Reader V> void deserialize(const V& v, signed char& out) { out = detail::read_integer<signed char>(v); }
+template<Reader V> void deserialize(const V& v, unsigned char& out) { out = detail::read_integer<unsigned char>(v); }
+template<Reader V> void deserialize(const V& v, short& out) { out = detail::read_integer<short>(v); }
+template<Reader V> void deserialize(const V& v, unsigned short& out) { out = detail::read_integer<unsigned short>(v); }
+template<Reader V> void deserialize(const V& v, int& out) { out = detail::read_integer<int>(v); }
+template<Reader V> void deserialize(const V& v, unsigned& out) { out = detail::read_integer<unsigned>(v); }
+template<Reader V> void deserialize(const V& v, long& out) { out = detail::read_integer<long>(v); }
+template<Reader V> void deserialize(const V& v, unsigned long& out) { out = detail::read_integer<unsigned long>(v); }
+template<Reader V> void deserialize(const V& v, long long& out) { out = detail::read_integer<long long>(v); }
+template<Reader V> void deserialize(const V& v, unsigned long long& out) { out = detail::read_integer<unsigned long long>(v); }
+template<Reader V> void deserialize(const V& v, float& out) { out = static_cast<float>(detail::read_floating(v)); }
+template<Reader V> void deserialize(const V& v, double& out) { out = detail::read_floating(v); }
+
+// String types
+template<Reader V> void deserialize(const V& v, std::string& out) { out = v.asString(); }
+
+// Binary data
+template<Reader V>
+void deserialize(const V& v, std::vector<std::byte>& out) {
+    const auto blob = v.asBlob();
+    out.assign(blob.data(), blob.data() + blob.size());
+}
+
+// Null maps to nullopt; anything else to a value.
+template<Reader V, class T>
+void deserialize(const V& v, std::optional<T>& out) {
+    if (v.isNull()) { out.reset(); return; }
+    using zerialize::deserialize;
+    deserialize(v, out.emplace());
+}
+
+// Containers
+template<Reader V, class T>
+void deserialize(const V& v, std::vector<T>& out) {
+    out.clear();
+    if (v.isArray()) out.reserve(v.arraySize());
+    using zerialize::deserialize;
+    detail::for_each_element(v, [&](const auto& child) { deserialize(child, out.emplace_back()); });
+}
+
+template<Reader V, class T>
+void deserialize(const V& v, std::list<T>& out) {
+    out.clear();
+    using zerialize::deserialize;
+    detail::for_each_element(v, [&](const auto& child) { deserialize(child, out.emplace_back()); });
+}
+
+template<Reader V, class T, std::size_t N>
+void deserialize(const V& v, std::array<T, N>& out) {
+    std::size_t i = 0;
+    using zerialize::deserialize;
+    detail::for_each_element(v, [&](const auto& child) {
+        if (i == N) throw DeserializationError("deserialize: array longer than std::array");
+        deserialize(child, out[i++]);
+    });
+    if (i != N) throw DeserializationError("deserialize: array shorter than std::array");
+}
+
+template<Reader V, class K, class T>
+void deserialize(const V& v, std::map<K, T>& out) {
+    static_assert(std::is_constructible_v<K, std::string_view>, "deserialize: map keys must be strings");
+    out.clear();
+    using zerialize::deserialize;
+    detail::for_each_entry(v, [&](std::string_view k, const auto& child) { deserialize(child, out[K(k)]); });
+}
+
+template<Reader V, class K, class T>
+void deserialize(const V& v, std::unordered_map<K, T>& out) {
+    static_assert(std::is_constructible_v<K, std::string_view>, "deserialize: map keys must be strings");
+    out.clear();
+    using zerialize::deserialize;
+    detail::for_each_entry(v, [&](std::string_view k, const auto& child) { deserialize(child, out[K(k)]); });
+}
+
+} // namespace zerialize
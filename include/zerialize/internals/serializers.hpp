@@ -4,6 +4,7 @@
 #include <unordered_map>
 #include <array>
 #include <list>
+#include <optional>
 #include <zerialize/concepts.hpp>
 
 //──────────────────────────────────────────────────────────────────────────────
@@ -52,6 +53,33 @@ template<Writer W> void serialize(const std::string& v, W& w) { w.string(v); }
 template<Writer W> void serialize(const std::vector<std::byte>& v, W& w) { w.binary(v); }
 template<Writer W> void serialize(std::span<const std::byte> v, W& w) { w.binary(v); }
 
+// Optional values: nullopt is null.
+template<Writer W, class T>
+void serialize(const std::optional<T>& v, W& w) {
+    if (!v) { w.null(); return; }
+    using zerialize::serialize;
+    serialize(*v, w);
+}
+
+// Dense tensors. Writers that encode typed arrays natively get one value;
+// everything else gets the portable [dtype, shape, blob] array.
+template<Writer W>
+void write_typed_array(W& w, int dtype, std::span<const std::uint64_t> shape, std::span<const std::byte> bytes) {
+    if constexpr (TypedArrayWriter<W>) {
+        if (shape.size() <= TypedArrayMaxRank && w.supports_typed_array(dtype)) {
+            w.typed_array(dtype, shape, bytes);
+            return;
+        }
+    }
+    w.begin_array(3);
+    w.int64(dtype);
+    w.begin_array(shape.size());
+    for (auto d : shape) w.uint64(d);
+    w.end_array();
+    w.binary(bytes);
+    w.end_array();
+}
+
 // Containers
 template<Writer W, class T>
 void serialize(const std::list<T>& l, W& w) {
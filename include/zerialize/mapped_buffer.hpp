@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <zerialize/zbuffer.hpp>
+
+#if defined(_WIN32)
+  #ifndef NOMINMAX
+    #define NOMINMAX
+  #endif
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace zerialize {
+
+/*
+ * MappedBuffer
+ * ------------
+ * A read-only, memory-mapped view of a whole file (RAII: unmapped on
+ * destruction). Opening costs a few syscalls regardless of file size; pages
+ * are read in as they are touched.
+ *
+ *   auto file = zerialize::MappedBuffer::open("recording.zera");
+ *   zerialize::Zera::Deserializer d(file.buf());   // zero-copy
+ *
+ * buf() can be handed to any protocol's span constructor. The mapping is
+ * page-aligned, so Zera's 16-byte-aligned arena stays aligned and tensor views
+ * need no copy. To hand ownership to code that takes a ZBuffer, use
+ * std::move(file).to_zbuffer(); the mapping is released by ZBuffer's deleter.
+ *
+ * Open failures throw std::system_error. An empty file maps to an empty
+ * buffer. The file must not be truncated while mapped.
+ */
+class MappedBuffer {
+    const std::uint8_t* data_ = nullptr;
+    std::size_t size_ = 0;
+
+    MappedBuffer(const std::uint8_t* data, std::size_t size) : data_(data), size_(size) {}
+
+    static void unmap(const std::uint8_t* data, std::size_t size) noexcept {
+        if (!data) return;
+#if defined(_WIN32)
+        (void)size;
+        ::UnmapViewOfFile(data);
+#else
+        ::munmap(const_cast<std::uint8_t*>(data), size);
+#endif
+    }
+
+#if defined(_WIN32)
+    [[noreturn]] static void fail(const char* what, const std::string& path) {
+        throw std::system_error(static_cast<int>(::GetLastError()), std::system_category(),
+                                std::string("MappedBuffer: ") + what + " " + path);
+    }
+#else
+    [[noreturn]] static void fail(const char* what, const std::string& path) {
+        throw std::system_error(errno, std::generic_category(),
+                                std::string("MappedBuffer: ") + what + " " + path);
+    }
+#endif
+
+public:
+    // How the mapping will be read; a hint to the OS read-ahead.
+    enum class Access { Normal, Sequential, Random };
+
+    MappedBuffer() = default;
+
+    static MappedBuffer open(const std::string& path) {
+#if defined(_WIN32)
+        HANDLE file = ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) fail("cannot open", path);
+        LARGE_INTEGER len{};
+        if (!::GetFileSizeEx(file, &len)) { ::CloseHandle(file); fail("cannot stat", path); }
+        if (len.QuadPart == 0) { ::CloseHandle(file); return MappedBuffer(); }
+        HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        ::CloseHandle(file);
+        if (!mapping) fail("cannot map", path);
+        void* p = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        ::CloseHandle(mapping); // the view keeps the mapping alive
+        if (!p) fail("cannot map", path);
+        return MappedBuffer(static_cast<const std::uint8_t*>(p), static_cast<std::size_t>(len.QuadPart));
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) fail("cannot open", path);
+        struct stat st{};
+        if (::fstat(fd, &st) != 0) { const int e = errno; ::close(fd); errno = e; fail("cannot stat", path); }
+        const auto size = static_cast<std::size_t>(st.st_size);
+        if (size == 0) { ::close(fd); return MappedBuffer(); }
+        void* p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        const int e = errno;
+        ::close(fd); // the mapping keeps the file alive
+        if (p == MAP_FAILED) { errno = e; fail("cannot map", path); }
+        return MappedBuffer(static_cast<const std::uint8_t*>(p), size);
+#endif
+    }
+
+    MappedBuffer(const MappedBuffer&) = delete;
+    MappedBuffer& operator=(const MappedBuffer&) = delete;
+
+    MappedBuffer(MappedBuffer&& o) noexcept
+        : data_(std::exchange(o.data_, nullptr)), size_(std::exchange(o.size_, 0)) {}
+
+    MappedBuffer& operator=(MappedBuffer&& o) noexcept {
+        if (this != &o) {
+            unmap(data_, size_);
+            data_ = std::exchange(o.data_, nullptr);
+            size_ = std::exchange(o.size_, 0);
+        }
+        return *this;
+    }
+
+    ~MappedBuffer() { unmap(data_, size_); }
+
+    [[nodiscard]] const std::uint8_t* data() const noexcept { return data_; }
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+    [[nodiscard]] std::span<const std::uint8_t> buf() const noexcept { return { data_, size_ }; }
+
+    // Read-ahead hint for the whole mapping; a no-op where unsupported.
+    void advise(Access a) const noexcept {
+#if defined(_WIN32)
+        (void)a;
+#else
+        if (!data_) return;
+        const int advice = a == Access::Sequential ? MADV_SEQUENTIAL
+                         : a == Access::Random     ? MADV_RANDOM
+                                                   : MADV_NORMAL;
+        ::madvise(const_cast<std::uint8_t*>(data_), size_, advice);
+#endif
+    }
+
+    // Transfer the mapping into a ZBuffer, which unmaps it when destroyed.
+    ZBuffer to_zbuffer() && {
+        const std::size_t size = std::exchange(size_, 0);
+        auto* p = const_cast<std::uint8_t*>(std::exchange(data_, nullptr));
+        if (!p) return ZBuffer();
+        return ZBuffer(p, size, [size](std::uint8_t* q) { unmap(q, size); });
+    }
+};
+
+} // namespace zerialize
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <zerialize/buffer_pool.hpp>
+#include <zerialize/errors.hpp>
+#include <zerialize/zbuffer.hpp>
+
+namespace zerialize {
+
+/*
+ * Output policies
+ * ---------------
+ * Where a hand-written writer puts its bytes. The writer asks for room at the
+ * write position, fills some of it, and commits what it used:
+ *
+ *   std::uint8_t* room(std::size_t n);   // at least n writable bytes (n <= 16)
+ *   void commit(std::size_t n);          // n bytes were written
+ *   void write(const void* p, std::size_t n); // copy n bytes of any length
+ *   std::size_t size() const;            // bytes committed so far
+ *   std::span<const std::uint8_t> view() const;
+ *   void clear();                        // start over, keeping storage
+ *   ZBuffer take();                      // the bytes as a ZBuffer; starts over
+ *
+ * VectorOutput grows a std::vector: doubling, or straight to a reserve()
+ * hint. Its vectors may come from a BufferPool. take() hands the vector over
+ * without copying.
+ *
+ * SpanOutput writes into memory the caller owns (a ring buffer slot, shared
+ * memory) and never allocates. When the span is full it keeps counting
+ * without writing, and view() and take() throw OutputOverflow carrying the
+ * size the whole message needs. take() has to copy.
+ */
+
+class VectorOutput {
+public:
+    VectorOutput() = default;
+
+    // Vectors come from `pool`, and take() returns ZBuffers that give them back.
+    explicit VectorOutput(BufferPool& pool) : buf_(pool.acquire()), pool_(&pool) {}
+
+    VectorOutput(VectorOutput&& o) noexcept
+        : buf_(std::move(o.buf_)), n_(std::exchange(o.n_, 0)), pool_(o.pool_) {}
+    VectorOutput& operator=(VectorOutput&& o) noexcept {
+        if (this != &o) {
+            if (pool_) pool_->release(std::move(buf_));
+            buf_ = std::move(o.buf_);
+            n_ = std::exchange(o.n_, 0);
+            pool_ = o.pool_;
+        }
+        return *this;
+    }
+    ~VectorOutput() {
+        if (pool_) pool_->release(std::move(buf_));
+    }
+
+    std::uint8_t* room(std::size_t n) {
+        if (buf_.size() - n_ < n) grow(n);
+        return buf_.data() + n_;
+    }
+    void commit(std::size_t n) { n_ += n; }
+
+    void write(const void* p, std::size_t n) {
+        if (n == 0) return;
+        std::memcpy(room(n), p, n);
+        n_ += n;
+    }
+
+    std::size_t size() const { return n_; }
+    std::span<const std::uint8_t> view() const { return {buf_.data(), n_}; }
+    void clear() { n_ = 0; }
+
+    // Make room for `bytes` in total, so a message of that size never regrows.
+    void reserve(std::size_t bytes) {
+        if (buf_.size() < bytes) buf_.resize(bytes);
+    }
+
+    ZBuffer take() {
+        buf_.resize(n_);
+        ZBuffer out = pool_ ? pool_->wrap(std::move(buf_)) : ZBuffer(std::move(buf_));
+        buf_ = pool_ ? pool_->acquire() : std::vector<std::uint8_t>{};
+        n_ = 0;
+        return out;
+    }
+
+private:
+    void grow(std::size_t n) {
+        buf_.resize(std::max({buf_.capacity(), 2 * buf_.size(), n_ + n, std::size_t(256)}));
+    }
+
+    std::vector<std::uint8_t> buf_; // sized ahead of n_; trimmed by take()
+    std::size_t n_ = 0;
+    BufferPool* pool_ = nullptr;
+};
+
+class SpanOutput {
+public:
+    SpanOutput() = default;
+    explicit SpanOutput(std::span<std::uint8_t> dst) : dst_(dst) {}
+    explicit SpanOutput(std::span<std::byte> dst)
+        : dst_(reinterpret_cast<std::uint8_t*>(dst.data()), dst.size()) {}
+
+    // Past the end of the span, writes land in a small sink and are only
+    // counted, so the writer finishes the message and learns its full size.
+    std::uint8_t* room(std::size_t n) {
+        if (!overflow_ && dst_.size() - n_ >= n) return dst_.data() + n_;
+        overflow_ = true;
+        return sink_.data();
+    }
+    void commit(std::size_t n) { n_ += n; }
+
+    void write(const void* p, std::size_t n) {
+        if (!overflow_ && dst_.size() - n_ >= n) {
+            if (n) std::memcpy(dst_.data() + n_, p, n);
+        } else {
+            overflow_ = true;
+        }
+        n_ += n;
+    }
+
+    // Bytes written so far or, after an overflow, the bytes the message needs.
+    std::size_t size() const { return n_; }
+    std::size_t capacity() const { return dst_.size(); }
+    bool overflowed() const { return overflow_; }
+
+    std::span<const std::uint8_t> view() const {
+        if (overflow_) throw OutputOverflow(n_, dst_.size());
+        return {dst_.data(), n_};
+    }
+    void clear() { n_ = 0; overflow_ = false; }
+
+    // Write the next messages into `dst` instead.
+    void reset(std::span<std::uint8_t> dst) { dst_ = dst; clear(); }
+    void reset(std::span<std::byte> dst) {
+        reset(std::span<std::uint8_t>(reinterpret_cast<std::uint8_t*>(dst.data()), dst.size()));
+    }
+
+    ZBuffer take() {
+        const auto bytes = view();
+        ZBuffer out(std::vector<std::uint8_t>(bytes.begin(), bytes.end()));
+        n_ = 0;
+        return out;
+    }
+
+private:
+    std::span<std::uint8_t> dst_{};
+    std::size_t n_ = 0;
+    bool overflow_ = false;
+    std::array<std::uint8_t, 16> sink_{};
+};
+
+// Helpers for writers: copy bytes, or a big-endian argument after a marker.
+template<class Out>
+inline void output_bytes(Out& out, const void* p, std::size_t n) {
+    out.write(p, n);
+}
+
+template<class Out>
+inline void output_be(Out& out, std::uint8_t marker, std::uint64_t v, int n) {
+    std::uint8_t* p = out.room(1 + static_cast<std::size_t>(n));
+    p[0] = marker;
+    for (int i = 0; i < n; ++i) p[1 + i] = static_cast<std::uint8_t>(v >> (8 * (n - 1 - i)));
+    out.commit(1 + static_cast<std::size_t>(n));
+}
+
+} // namespace zerialize
@@ -1,8 +1,10 @@
-// CBOR protocol implemented with jsoncons (reader and writer)
+// CBOR protocol: hand-written reader and writer, no dependencies. A writer
+// backed by jsoncons is available as CBORJsoncons (protocols/cbor_jsoncons.hpp).
 #pragma once
 
 #include <cstdint>
 #include <cstddef>
+#include <deque>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -13,180 +15,513 @@
 #include <cstring>
 #include <limits>
 #include <cmath>
-
-#include <jsoncons/json.hpp>
-#include <jsoncons_ext/cbor/cbor.hpp>
+#include <iterator>
+#include <utility>
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <concepts>
 
 #include <zerialize/zbuffer.hpp>
+#include <zerialize/buffer_pool.hpp>
+#include <zerialize/output.hpp>
 #include <zerialize/errors.hpp>
+#include <zerialize/internals/fixed_string.hpp>
 
 namespace zerialize {
-namespace cborjc {
+namespace cbor {
 
 // ========================== Writer (Serializer) ===============================
-
-struct RootSerializer {
-    std::vector<uint8_t> out_;
-    jsoncons::cbor::cbor_bytes_encoder enc;
+//
+// Hand-written encoder, templated on where the bytes go (see output.hpp):
+// RootSerializer grows a vector, BasicRootSerializer<SpanOutput> writes into
+// a caller-provided span. Every head uses the shortest argument encoding, and
+// arrays and maps are definite-length (the Writer interface always gives
+// counts). Counts are checked as items are
+// written, so end_array()/end_map() and finish() throw on a mismatch instead
+// of producing a corrupt message. Doubles are written as float64 unless float
+// shortening is on, in which case they take the shortest of half, float32 and
+// float64 that holds them exactly (RFC 8949 preferred serialization).
+
+// Head with major type `major` and argument `v`, shortest form; returns its length.
+inline std::size_t cbor_encode_head(uint8_t* p, uint8_t major, uint64_t v) {
+    const uint8_t m = static_cast<uint8_t>(major << 5);
+    if (v < 24)             { p[0] = static_cast<uint8_t>(m | v); return 1; }
+    if (v <= 0xff)          { p[0] = m | 24; p[1] = static_cast<uint8_t>(v); return 2; }
+    if (v <= 0xffff)        { p[0] = m | 25; p[1] = static_cast<uint8_t>(v >> 8); p[2] = static_cast<uint8_t>(v); return 3; }
+    if (v <= 0xffffffffull) {
+        p[0] = m | 26;
+        for (int i = 0; i < 4; ++i) p[1 + i] = static_cast<uint8_t>(v >> (24 - 8 * i));
+        return 5;
+    }
+    p[0] = m | 27;
+    for (int i = 0; i < 8; ++i) p[1 + i] = static_cast<uint8_t>(v >> (56 - 8 * i));
+    return 9;
+}
+
+// Length of the head cbor_encode_head() writes for argument `v`.
+inline std::size_t cbor_head_size(uint64_t v) {
+    return v < 24 ? 1 : v <= 0xff ? 2 : v <= 0xffff ? 3 : v <= 0xffffffffull ? 5 : 9;
+}
+
+// Half-precision bits of `d`, if it converts exactly (NaN becomes the
+// canonical quiet NaN).
+inline std::optional<uint16_t> cbor_exact_half(double d) {
+    if (std::isnan(d)) return uint16_t(0x7e00);
+    const float f = static_cast<float>(d);
+    if (static_cast<double>(f) != d) return std::nullopt;
+    uint32_t bits = 0;
+    std::memcpy(&bits, &f, sizeof(bits));
+    const auto sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+    const int exp = static_cast<int>((bits >> 23) & 0xff);
+    const uint32_t mant = bits & 0x7fffff;
+    if (exp == 0xff) return static_cast<uint16_t>(sign | 0x7c00);  // infinities
+    if (exp == 0 && mant == 0) return sign;                        // zeros
+    const int e = exp - 127;
+    if (e >= -14 && e <= 15) {                                     // normal half
+        if (mant & 0x1fff) return std::nullopt;
+        return static_cast<uint16_t>(sign | ((e + 15) << 10) | (mant >> 13));
+    }
+    if (e >= -24 && e < -14) {                                     // subnormal half
+        const uint32_t full = mant | 0x800000;
+        const int shift = -e - 1;
+        if (full & ((uint32_t(1) << shift) - 1)) return std::nullopt;
+        return static_cast<uint16_t>(sign | (full >> shift));
+    }
+    return std::nullopt;
+}
+
+// Key K as a CBOR text string (head and bytes), encoded at compile time.
+template<fixed_string K>
+inline constexpr auto cbor_encoded_key = [] {
+    constexpr std::size_t n = decltype(K)::size();
+    static_assert(n <= 0xffff, "CBOR: compile-time key too long");
+    constexpr std::size_t h = n < 24 ? 1 : (n < 256 ? 2 : 3);
+    std::array<uint8_t, h + n> out{};
+    if constexpr (h == 1) {
+        out[0] = static_cast<uint8_t>(0x60 | n);
+    } else if constexpr (h == 2) {
+        out[0] = 0x78;
+        out[1] = static_cast<uint8_t>(n);
+    } else {
+        out[0] = 0x79;
+        out[1] = static_cast<uint8_t>(n >> 8);
+        out[2] = static_cast<uint8_t>(n & 0xff);
+    }
+    for (std::size_t i = 0; i < n; ++i) out[h + i] = static_cast<uint8_t>(K.data[i]);
+    return out;
+}();
+
+template<class Out = VectorOutput>
+struct BasicRootSerializer {
+    Out out_;
+    std::vector<uint64_t> open_;   // items still owed by each open container
     bool wrote_root = false;
-
-    RootSerializer()
-        : out_()
-        , enc(out_)
-    {}
+    bool shorten_floats_ = false;
+
+    BasicRootSerializer() = default;
+
+    // Output vectors come from `pool`, and finish() returns ZBuffers that give
+    // them back; see BufferPool.
+    explicit BasicRootSerializer(BufferPool& pool)
+        requires std::constructible_from<Out, BufferPool&>
+        : out_(pool) {}
+
+    // Write into `dst` (SpanOutput); see serialize_to().
+    explicit BasicRootSerializer(std::span<std::uint8_t> dst)
+        requires std::constructible_from<Out, std::span<std::uint8_t>>
+        : out_(dst) {}
+    explicit BasicRootSerializer(std::span<std::byte> dst)
+        requires std::constructible_from<Out, std::span<std::byte>>
+        : out_(dst) {}
+
+    BasicRootSerializer(BasicRootSerializer&&) = default;
+    BasicRootSerializer& operator=(BasicRootSerializer&&) = default;
+
+    // Write doubles as half or float32 when that loses nothing. Off by default,
+    // so every double is a 9-byte float64 (and TemplateMessage can patch it).
+    void set_float_shortening(bool on) { shorten_floats_ = on; }
+
+    // Size hint: a message of up to `bytes` is written without regrowing.
+    void reserve(std::size_t bytes) requires requires (Out& o) { o.reserve(bytes); } {
+        out_.reserve(bytes);
+    }
 
     ZBuffer finish() {
-        if (!wrote_root) {
-            enc.null_value();
+        finalize();
+        ZBuffer result = out_.take();
+        reset();
+        return result;
+    }
+
+    // Finalize in place; the span is valid until the next reset(). With
+    // SpanOutput, throws OutputOverflow if the message did not fit.
+    std::span<const std::uint8_t> finish_view() {
+        finalize();
+        return out_.view();
+    }
+
+    // Discard the current message; the output keeps its capacity.
+    void reset() {
+        out_.clear();
+        open_.clear();
+        wrote_root = false;
+    }
+
+    // Discard the current message and write the next ones into `dst`.
+    void reset(std::span<std::byte> dst) requires requires (Out& o) { o.reset(dst); } {
+        reset();
+        out_.reset(dst);
+    }
+
+    // ---- encoding helpers (called by Serializer) ----
+
+    void finalize() {
+        if (!open_.empty()) throw SerializationError("CBOR: finish() called with unterminated container");
+        if (!wrote_root) put_byte(0xf6); // null
+        wrote_root = true;
+    }
+
+    // Account for one item (a value, or a key) in the enclosing container.
+    void item() {
+        if (open_.empty()) {
+            if (wrote_root) throw SerializationError("CBOR: multiple root values");
             wrote_root = true;
+            return;
         }
-        return ZBuffer(std::move(out_));
+        uint64_t& left = open_.back();
+        if (left == 0) throw SerializationError("CBOR: more items than the container's count");
+        --left;
+    }
+
+    void open(uint64_t items) {
+        if (open_.capacity() == 0) open_.reserve(16);
+        open_.push_back(items);
+    }
+
+    void close() {
+        if (open_.empty()) throw SerializationError("CBOR: end of container without a begin");
+        if (open_.back() != 0) throw SerializationError("CBOR: fewer items than the container's count");
+        open_.pop_back();
+    }
+
+    void put_byte(uint8_t b) { *out_.room(1) = b; out_.commit(1); }
+
+    void put_head(uint8_t major, uint64_t v) {
+        const std::size_t n = cbor_head_size(v);
+        cbor_encode_head(out_.room(n), major, v);
+        out_.commit(n);
     }
+
+    void put_bytes(const void* p, std::size_t n) { output_bytes(out_, p, n); }
+
+    void put_be(uint8_t ib, uint64_t v, int n) { output_be(out_, ib, v, n); }
 };
 
-struct Serializer {
-    RootSerializer* r;
-    explicit Serializer(RootSerializer& rs) : r(&rs) {}
+template<class Out = VectorOutput>
+struct BasicSerializer {
+    BasicRootSerializer<Out>* r;
+    explicit BasicSerializer(BasicRootSerializer<Out>& rs) : r(&rs) {}
 
     // primitives
-    void null()                  { r->enc.null_value(); r->wrote_root = true; }
-    void boolean(bool v)         { r->enc.bool_value(v); r->wrote_root = true; }
-    void int64(std::int64_t v)   { r->enc.int64_value(v); r->wrote_root = true; }
-    void uint64(std::uint64_t v) { r->enc.uint64_value(v); r->wrote_root = true; }
-    void double_(double v)       { r->enc.double_value(v); r->wrote_root = true; }
-    void string(std::string_view sv) { r->enc.string_value(sv); r->wrote_root = true; }
+    void null()                  { r->item(); r->put_byte(0xf6); }
+    void boolean(bool v)         { r->item(); r->put_byte(v ? 0xf5 : 0xf4); }
+    void int64(std::int64_t v) {
+        r->item();
+        if (v >= 0) r->put_head(0, static_cast<uint64_t>(v));
+        else r->put_head(1, ~static_cast<uint64_t>(v)); // -1 - v
+    }
+    void uint64(std::uint64_t v) { r->item(); r->put_head(0, v); }
+    void double_(double v) {
+        r->item();
+        if (r->shorten_floats_) {
+            if (auto h = cbor_exact_half(v)) { r->put_be(0xf9, *h, 2); return; }
+            const float f = static_cast<float>(v);
+            if (static_cast<double>(f) == v) {
+                uint32_t bits = 0;
+                std::memcpy(&bits, &f, sizeof(bits));
+                r->put_be(0xfa, bits, 4);
+                return;
+            }
+        }
+        uint64_t bits = 0;
+        std::memcpy(&bits, &v, sizeof(bits));
+        r->put_be(0xfb, bits, 8);
+    }
+    void string(std::string_view sv) {
+        r->item();
+        r->put_head(3, sv.size());
+        r->put_bytes(sv.data(), sv.size());
+    }
     void binary(std::span<const std::byte> b) {
-        const uint8_t* p = reinterpret_cast<const uint8_t*>(b.data());
-        std::vector<uint8_t> tmp(p, p + b.size());
-        r->enc.byte_string_value(tmp); r->wrote_root = true;
+        r->item();
+        r->put_head(2, b.size());
+        r->put_bytes(b.data(), b.size());
     }
 
     // containers
-    void begin_array(std::size_t n) { r->enc.begin_array(n); r->wrote_root = true; }
-    void end_array()                { r->enc.end_array(); }
-    void begin_map(std::size_t n)   { r->enc.begin_object(n); r->wrote_root = true; }
-    void end_map()                  { r->enc.end_object(); }
-    void key(std::string_view k)    { r->enc.key(k); }
+    void begin_array(std::size_t n) {
+        r->item();
+        r->put_head(4, n);
+        r->open(n);
+    }
+    void end_array() { r->close(); }
+    void begin_map(std::size_t n) {
+        r->item();
+        r->put_head(5, n);
+        r->open(2 * static_cast<uint64_t>(n));
+    }
+    void end_map() { r->close(); }
+    void key(std::string_view k) { string(k); }
+
+    // Pre-encoded compile-time key: one write; see RawKeyWriter.
+    template<fixed_string K>
+    void key_raw() {
+        constexpr auto& enc = cbor_encoded_key<K>;
+        r->item();
+        r->put_bytes(enc.data(), enc.size());
+    }
+};
+
+// Counts the bytes BasicSerializer would write for the same calls, writing
+// nothing and never allocating; see measure(). Set float shortening to match
+// a root serializer that has it on. Container counts are not checked.
+class SizeCounter {
+    std::size_t n_ = 0;
+    bool shorten_floats_ = false;
+public:
+    void set_float_shortening(bool on) { shorten_floats_ = on; }
+
+    // Message size so far; a message with no value is the 1-byte null.
+    std::size_t size() const { return n_ ? n_ : 1; }
+    void reset() { n_ = 0; }
+
+    void null()                  { n_ += 1; }
+    void boolean(bool)           { n_ += 1; }
+    void int64(std::int64_t v) {
+        n_ += cbor_head_size(v >= 0 ? static_cast<uint64_t>(v) : ~static_cast<uint64_t>(v));
+    }
+    void uint64(std::uint64_t v) { n_ += cbor_head_size(v); }
+    void double_(double v) {
+        if (shorten_floats_) {
+            if (cbor_exact_half(v)) { n_ += 3; return; }
+            if (static_cast<double>(static_cast<float>(v)) == v) { n_ += 5; return; }
+        }
+        n_ += 9;
+    }
+    void string(std::string_view sv)          { n_ += cbor_head_size(sv.size()) + sv.size(); }
+    void binary(std::span<const std::byte> b) { n_ += cbor_head_size(b.size()) + b.size(); }
+    void begin_array(std::size_t n)           { n_ += cbor_head_size(n); }
+    void end_array()                          {}
+    void begin_map(std::size_t n)             { n_ += cbor_head_size(n); }
+    void end_map()                            {}
+    void key(std::string_view k)              { string(k); }
+
+    template<fixed_string K>
+    void key_raw() { n_ += cbor_encoded_key<K>.size(); }
 };
 
+using RootSerializer = BasicRootSerializer<>;
+using Serializer     = BasicSerializer<>;
+
 // ========================== Reader (Deserializer) =============================
 
+struct CborHead {
+    uint8_t major;
+    uint8_t addl;
+    uint64_t val;     // argument for majors 0-6; body size in bytes for major 7
+    std::size_t hlen; // header length in bytes
+    bool indefinite;
+};
+
+inline uint64_t cbor_get_be(const uint8_t* p, std::size_t n) {
+    uint64_t v = 0;
+    for (std::size_t i = 0; i < n; ++i) v = (v << 8) | p[i];
+    return v;
+}
+
+inline void cbor_put_be64(uint8_t* p, uint64_t v) {
+    for (int i = 0; i < 8; ++i) p[i] = uint8_t(v >> (56 - 8 * i));
+}
+
+// Rewrite a 9-byte head (8-byte argument) in place: major 0/1 ints, major 7
+// float64. Throws unless `slot` already holds one whose initial byte is
+// accepted by `ok`.
+template<class Ok>
+inline void cbor_patch_head(std::span<uint8_t> slot, Ok ok, uint8_t ib, uint64_t arg) {
+    if (slot.size() != 9 || !ok(slot[0])) throw SerializationError("CBOR: patch slot is not the expected scalar");
+    slot[0] = ib;
+    cbor_put_be64(slot.data() + 1, arg);
+}
+
+// Decode the initial byte and argument at `p`. The only head parser; every
+// read of `b` it makes is bounds-checked.
+inline CborHead cbor_read_head(std::span<const uint8_t> b, std::size_t p) {
+    if (p >= b.size()) throw DeserializationError("CBOR: truncated");
+    const uint8_t ib = b[p];
+    CborHead h{ static_cast<uint8_t>(ib >> 5), static_cast<uint8_t>(ib & 0x1F), 0, 1, false };
+    if (h.major == 7) {
+        // simple/float encoding: the header is the initial byte, except simple(24)
+        if (h.addl == 25) h.val = 2;           // half
+        else if (h.addl == 26) h.val = 4;      // float32
+        else if (h.addl == 27) h.val = 8;      // float64
+        else if (h.addl == 24) {               // simple value in the next byte
+            if (b.size() - p < 2) throw DeserializationError("CBOR: truncated simple(24)");
+            h.hlen = 2;
+        }
+        else if (h.addl == 31) h.indefinite = true; // break
+        else if (h.addl > 24) throw DeserializationError("CBOR: reserved additional info");
+        return h;
+    }
+    // Fast path: the argument is in the initial byte (small ints, short
+    // strings, small containers).
+    if (h.addl < 24) { h.val = h.addl; return h; }
+    if (h.addl <= 27) {
+        const std::size_t n = std::size_t{1} << (h.addl - 24);
+        if (b.size() - p < n + 1) throw DeserializationError("CBOR: truncated argument");
+        h.val = cbor_get_be(&b[p + 1], n);
+        h.hlen = n + 1;
+        return h;
+    }
+    if (h.addl == 31 && h.major >= 2 && h.major <= 5) { h.indefinite = true; return h; }
+    throw DeserializationError("CBOR: reserved additional info");
+}
+
+// Offset just past the item at `p`.
+inline std::size_t cbor_skip(std::span<const uint8_t> b, std::size_t p) {
+    const auto h = cbor_read_head(b, p);
+    std::size_t q = p + h.hlen;
+    switch (h.major) {
+        case 0: // uint
+        case 1: // negint
+            return q;
+        case 2: // bstr
+        case 3: // tstr
+            if (!h.indefinite) {
+                if (h.val > b.size() - q) throw DeserializationError("CBOR: truncated string");
+                return q + static_cast<std::size_t>(h.val);
+            }
+            // chunks terminated by 0xFF
+            for (;;) {
+                if (q >= b.size()) throw DeserializationError("CBOR: truncated indef str");
+                if (b[q] == 0xFF) return q + 1;
+                const auto ch = cbor_read_head(b, q);
+                if (ch.major != h.major) throw DeserializationError("CBOR: wrong chunk type");
+                if (ch.indefinite) throw DeserializationError("CBOR: nested indef chunks not allowed");
+                q += ch.hlen;
+                if (ch.val > b.size() - q) throw DeserializationError("CBOR: truncated chunk");
+                q += static_cast<std::size_t>(ch.val);
+            }
+        case 4: // array
+        case 5: // map
+        {
+            const int per_entry = h.major == 5 ? 2 : 1;
+            if (!h.indefinite) {
+                for (uint64_t i = 0; i < h.val; ++i)
+                    for (int k = 0; k < per_entry; ++k) q = cbor_skip(b, q);
+                return q;
+            }
+            for (;;) {
+                if (q >= b.size()) throw DeserializationError("CBOR: truncated indef container");
+                if (b[q] == 0xFF) return q + 1;
+                for (int k = 0; k < per_entry; ++k) q = cbor_skip(b, q);
+            }
+        }
+        case 6: // tag: skip the tagged value
+            return cbor_skip(b, q);
+        default: // 7: floats/simple
+            if (h.indefinite) throw DeserializationError("CBOR: unexpected break");
+            if (h.val > b.size() - q) throw DeserializationError("CBOR: truncated float");
+            return q + static_cast<std::size_t>(h.val);
+    }
+}
+
+// Map key at `p` as a string_view. Definite text strings point into `b`;
+// chunked ones are joined into `chunked`, which must outlive the result.
+inline std::string_view cbor_map_key(std::span<const uint8_t> b, std::size_t p, std::string& chunked) {
+    const auto h = cbor_read_head(b, p);
+    if (h.major != 3) throw DeserializationError("CBOR: not a string");
+    std::size_t q = p + h.hlen;
+    if (!h.indefinite) {
+        if (h.val > b.size() - q) throw DeserializationError("CBOR: truncated string");
+        return std::string_view(reinterpret_cast<const char*>(b.data() + q), static_cast<std::size_t>(h.val));
+    }
+    chunked.clear();
+    for (;;) {
+        if (q >= b.size()) throw DeserializationError("CBOR: truncated indef tstr");
+        if (b[q] == 0xFF) return chunked;
+        const auto ch = cbor_read_head(b, q);
+        if (ch.major != 3 || ch.indefinite) throw DeserializationError("CBOR: bad tstr chunk");
+        q += ch.hlen;
+        if (ch.val > b.size() - q) throw DeserializationError("CBOR: truncated chunk");
+        chunked.append(reinterpret_cast<const char*>(b.data() + q), static_cast<std::size_t>(ch.val));
+        q += static_cast<std::size_t>(ch.val);
+    }
+}
+
+// Whether the map key at `p` equals `key`. Chunked keys are compared chunk by
+// chunk, without joining them.
+inline bool cbor_key_equals(std::span<const uint8_t> b, std::size_t p, std::string_view key) {
+    const auto h = cbor_read_head(b, p);
+    if (h.major != 3) throw DeserializationError("CBOR: not a string");
+    std::size_t q = p + h.hlen;
+    if (!h.indefinite) {
+        if (h.val > b.size() - q) throw DeserializationError("CBOR: truncated string");
+        return h.val == key.size() && (key.empty() || std::memcmp(b.data() + q, key.data(), key.size()) == 0);
+    }
+    std::size_t matched = 0;
+    for (;;) {
+        if (q >= b.size()) throw DeserializationError("CBOR: truncated indef tstr");
+        if (b[q] == 0xFF) return matched == key.size();
+        const auto ch = cbor_read_head(b, q);
+        if (ch.major != 3 || ch.indefinite) throw DeserializationError("CBOR: bad tstr chunk");
+        q += ch.hlen;
+        if (ch.val > b.size() - q) throw DeserializationError("CBOR: truncated chunk");
+        const std::size_t n = static_cast<std::size_t>(ch.val);
+        if (n > key.size() - matched || (n && std::memcmp(b.data() + q, key.data() + matched, n) != 0)) return false;
+        matched += n;
+        q += n;
+    }
+}
+
 class CborDeserializer {
     std::span<const uint8_t> buf_{};
     std::vector<uint8_t> owned_; // if non-empty, buf_ points into this
     std::size_t pos_ = 0; // start of this view's value
+    // Optional offset table built by indexed(), absolute in buf_. Arrays: start
+    // of each element, then the end. Maps: key and value starts interleaved,
+    // then the end.
+    std::shared_ptr<const std::vector<std::size_t>> index_;
 
     static void ensure(bool cond, const char* msg) {
         if (!cond) throw DeserializationError(msg);
     }
 
-    static uint64_t get_be(const uint8_t* p, std::size_t n) {
-        uint64_t v = 0;
-        for (std::size_t i = 0; i < n; ++i) v = (v << 8) | p[i];
-        return v;
-    }
+    using Head = CborHead;
 
-    struct Head {
-        uint8_t major;
-        uint8_t addl;
-        uint64_t val;   // length/value for definite forms
-        std::size_t hlen; // header length in bytes
-        bool indefinite;
-    };
+    Head read_head(std::size_t p) const { return cbor_read_head(buf_, p); }
+    std::size_t skip(std::size_t p) const { return cbor_skip(buf_, p); }
+    Head head() const { return read_head(pos_); }
 
-    Head read_head(std::size_t p) const {
-        ensure(p < buf_.size(), "CBOR: truncated");
-        uint8_t b = buf_[p];
-        Head h{}; h.major = b >> 5; h.addl = b & 0x1F; h.indefinite = false; h.hlen = 1; h.val = 0;
-        if (h.major == 7) {
-            // simple/float encoding: header is 1 byte for floats; body size depends on addl
-            if (h.addl == 25) { h.val = 2; }           // half (2 bytes)
-            else if (h.addl == 26) { h.val = 4; }      // float32
-            else if (h.addl == 27) { h.val = 8; }      // float64
-            else if (h.addl == 24) {                   // simple value (next 1 byte)
-                ensure(p+2 <= buf_.size(), "CBOR: truncated simple(24)");
-                h.hlen = 2; h.val = 0;
-            } else if (h.addl == 31) {
-                h.indefinite = true;
-            } else {
-                // null/true/false/simple (no body)
-                h.val = 0;
-            }
-            return h;
+    // Number of items in the container whose head `h` starts at `p`, and the
+    // offset of its first item. Indefinite containers are counted in one pass.
+    std::size_t container_info(std::size_t p, const Head& h, std::size_t& first) const {
+        first = p + h.hlen;
+        const int per_entry = h.major == 5 ? 2 : 1;
+        if (!h.indefinite) {
+            // Every item takes at least one byte; reject counts the buffer cannot hold.
+            ensure(h.val <= (buf_.size() - first) / per_entry, "CBOR: container count exceeds buffer");
+            return static_cast<std::size_t>(h.val);
         }
-        if (h.addl < 24) { h.val = h.addl; }
-        else if (h.addl == 24) { ensure(p+2 <= buf_.size(), "CBOR: truncated u8"); h.val = buf_[p+1]; h.hlen = 2; }
-        else if (h.addl == 25) { ensure(p+3 <= buf_.size(), "CBOR: truncated u16"); h.val = get_be(&buf_[p+1],2); h.hlen = 3; }
-        else if (h.addl == 26) { ensure(p+5 <= buf_.size(), "CBOR: truncated u32"); h.val = get_be(&buf_[p+1],4); h.hlen = 5; }
-        else if (h.addl == 27) { ensure(p+9 <= buf_.size(), "CBOR: truncated u64"); h.val = get_be(&buf_[p+1],8); h.hlen = 9; }
-        else if (h.addl == 31) { h.indefinite = true; }
-        else { throw DeserializationError("CBOR: reserved additional info"); }
-        return h;
-    }
-
-    std::size_t skip(std::size_t p) const {
-        auto h = read_head(p);
-        std::size_t q = p + h.hlen;
-        switch (h.major) {
-            case 0: // uint
-            case 1: // negint
-                return q;
-            case 2: // bstr
-            case 3: // tstr
-                if (!h.indefinite) {
-                    ensure(q + h.val <= buf_.size(), "CBOR: truncated string");
-                    return q + static_cast<std::size_t>(h.val);
-                } else {
-                    // chunks terminated by 0xFF
-                    for (;;) {
-                        ensure(q < buf_.size(), "CBOR: truncated indef str");
-                        if (buf_[q] == 0xFF) return q + 1;
-                        auto ch = read_head(q);
-                        ensure(ch.major == h.major, "CBOR: wrong chunk type");
-                        ensure(!ch.indefinite, "CBOR: nested indef chunks not allowed");
-                        q += ch.hlen + static_cast<std::size_t>(ch.val);
-                    }
-                }
-            case 4: // array
-                if (!h.indefinite) {
-                    for (uint64_t i = 0; i < h.val; ++i) q = skip(q);
-                    return q;
-                } else {
-                    for (;;) {
-                        ensure(q < buf_.size(), "CBOR: truncated indef array");
-                        if (buf_[q] == 0xFF) return q + 1;
-                        q = skip(q);
-                    }
-                }
-            case 5: // map
-                if (!h.indefinite) {
-                    for (uint64_t i = 0; i < h.val; ++i) { q = skip(q); q = skip(q); }
-                    return q;
-                } else {
-                    for (;;) {
-                        ensure(q < buf_.size(), "CBOR: truncated indef map");
-                        if (buf_[q] == 0xFF) return q + 1;
-                        q = skip(q); // key
-                        q = skip(q); // value
-                    }
-                }
-            case 6: // tag
-                // skip tag then the tagged value
-                return skip(q);
-            case 7: // floats/simple
-                if (h.addl == 25) { ensure(q+2 <= buf_.size(), "CBOR: truncated f16"); return q+2; }
-                if (h.addl == 26) { ensure(q+4 <= buf_.size(), "CBOR: truncated f32"); return q+4; }
-                if (h.addl == 27) { ensure(q+8 <= buf_.size(), "CBOR: truncated f64"); return q+8; }
-                if (h.addl == 24) { ensure(q+1 <= buf_.size(), "CBOR: truncated simple(24)"); return q+1; }
-                // simple/bool/null (no body): header only
-                return q;
-            default:
-                throw DeserializationError("CBOR: unknown major");
+        std::size_t q = first, c = 0;
+        for (;;) {
+            ensure(q < buf_.size(), "CBOR: truncated indef container");
+            if (buf_[q] == 0xFF) return c;
+            for (int k = 0; k < per_entry; ++k) q = skip(q);
+            ++c;
         }
     }
 
-    Head head() const { return read_head(pos_); }
-
     static double decode_f16(uint16_t h) {
         // Simple IEEE754 half to double conversion
         uint16_t sign = (h >> 15) & 1;
@@ -259,10 +594,10 @@ public:
     float    asFloat()  const { return static_cast<float>(asDouble()); }
     double   asDouble() const {
         auto h = head(); ensure(isFloat(), "CBOR: not a float");
-        std::size_t q = pos_ + h.hlen;
+        std::size_t q = pos_ + h.hlen; ensure(h.val <= buf_.size() - q, "CBOR: truncated float");
         if (h.addl == 25) { uint16_t v = (uint16_t)((buf_[q] << 8) | buf_[q+1]); return decode_f16(v); }
-        if (h.addl == 26) { uint32_t v = (uint32_t)get_be(&buf_[q],4); float f; std::memcpy(&f,&v,4); return static_cast<double>(f); }
-        uint64_t v = get_be(&buf_[q],8); double d; std::memcpy(&d,&v,8); return d;
+        if (h.addl == 26) { uint32_t v = (uint32_t)cbor_get_be(&buf_[q],4); float f; std::memcpy(&f,&v,4); return static_cast<double>(f); }
+        uint64_t v = cbor_get_be(&buf_[q],8); double d; std::memcpy(&d,&v,8); return d;
     }
     bool     asBool()   const { auto h = head(); ensure(h.major==7 && (h.addl==20 || h.addl==21), "CBOR: not a bool"); return h.addl==21; }
 
@@ -321,52 +656,69 @@ public:
         return out;
     }
 
+
     // ---- map interface ----
-    bool contains(std::string_view key) const {
-        auto h = head(); if (!(h.major==5)) return false;
-        std::size_t q = pos_ + h.hlen;
-        if (!h.indefinite) {
-            for (uint64_t i=0;i<h.val;++i) {
-                // key
-                auto kh = read_head(q);
-                std::string_view ksv;
-                if (kh.major==3 && !kh.indefinite) {
-                    ksv = std::string_view(reinterpret_cast<const char*>(&buf_[q+kh.hlen]), static_cast<std::size_t>(kh.val));
+
+    // Chunked (indefinite-length) keys joined by a KeysView or EntriesView.
+    // Joined keys never move, so every key a view yields stays valid as long
+    // as the view does, even after its iterator has moved on.
+    using KeyStore = std::deque<std::string>;
+
+    // Position within a map. The current entry's key, value offset and the
+    // offset of the next entry are each found once, when the cursor arrives.
+    // Chunked keys are joined into the owning view's store, created on the
+    // first one.
+    struct MapCursor {
+        std::span<const uint8_t> buf{};
+        std::size_t i = 0;        // entry index
+        std::size_t n = 0;        // entry count
+        std::size_t key_off = 0;
+        std::size_t val_off = 0;
+        std::size_t next_off = 0;
+        std::string_view key_{};  // into buf, or into *store for chunked keys
+        std::shared_ptr<KeyStore>* store = nullptr;
+
+        MapCursor() = default;
+        MapCursor(std::span<const uint8_t> b, std::size_t idx, std::size_t count, std::size_t off,
+                  std::shared_ptr<KeyStore>* keys)
+            : buf(b), i(idx), n(count), key_off(off), store(keys) { load(); }
+
+        std::string_view key() const { return key_; }
+        void advance() { key_off = next_off; ++i; load(); }
+
+    private:
+        void load() {
+            if (i >= n) return;
+            std::string joined;
+            key_ = cbor_map_key(buf, key_off, joined);
+            if (key_.data() == joined.data()) {
+                if (joined.empty()) {
+                    key_ = {};
                 } else {
-                    // fallback: decode key to string
-                    CborDeserializer keyv(buf_, q);
-                    std::string ks = keyv.asString();
-                    if (ks == key) return true;
-                    q = skip(q); // advance over key
-                    q = skip(q); // skip value
-                    continue;
+                    if (!*store) *store = std::make_shared<KeyStore>();
+                    key_ = (*store)->emplace_back(std::move(joined));
                 }
-                if (ksv == key) return true;
-                q = skip(q); // key
-                q = skip(q); // value
-            }
-            return false;
-        } else {
-            for (;;) {
-                ensure(q < buf_.size(), "CBOR: trunc indef map");
-                if (buf_[q] == 0xFF) return false;
-                std::string k = CborDeserializer(buf_, q).asString();
-                q = skip(q); // key
-                if (k == key) return true;
-                q = skip(q); // value
             }
+            val_off = cbor_skip(buf, key_off);
+            next_off = cbor_skip(buf, val_off);
         }
+    };
+
+    bool contains(std::string_view key) const {
+        auto h = head(); if (!(h.major==5)) return false;
+        return find_value(key) != npos;
     }
 
+    // Keys point into the buffer, or (chunked keys) into the view's store:
+    // they are valid while both the buffer and the view are.
     struct KeysView {
         std::span<const uint8_t> buf;
-        std::size_t start; // pos at start of map head
+        std::size_t count = 0;
+        std::size_t first = 0; // offset of the first key
+        mutable std::shared_ptr<KeyStore> keys{};
+
         struct iterator {
-            std::span<const uint8_t> buf{};
-            std::size_t q = 0; // current cursor (at next key head or break)
-            uint64_t remaining = 0; // for definite maps
-            bool indefinite = false;
-            mutable std::string scratch;
+            MapCursor c{};
 
             using iterator_category = std::forward_iterator_tag;
             using iterator_concept  = std::forward_iterator_tag;
@@ -374,131 +726,182 @@ public:
             using difference_type   = std::ptrdiff_t;
             using reference         = std::string_view;
 
-            struct H { uint8_t major, addl; uint64_t val; std::size_t hlen; bool indefinite; };
-            static H read_head(std::span<const uint8_t> b, std::size_t p) {
-                uint8_t bb = b[p];
-                H h{}; h.major = bb>>5; h.addl=bb&0x1F; h.hlen=1; h.val=0; h.indefinite=false;
-                if (h.major==7) {
-                    if (h.addl==25) { h.val=2; }
-                    else if (h.addl==26) { h.val=4; }
-                    else if (h.addl==27) { h.val=8; }
-                    else if (h.addl==24) { h.hlen=2; }
-                    else if (h.addl==31) { h.indefinite=true; }
-                    return h;
-                }
-                if (h.addl<24) { h.val=h.addl; }
-                else if (h.addl==24) { h.val=b[p+1]; h.hlen=2; }
-                else if (h.addl==25) { h.val=(uint64_t)b[p+1]<<8 | b[p+2]; h.hlen=3; }
-                else if (h.addl==26) { h.val=((uint64_t)b[p+1]<<24)|((uint64_t)b[p+2]<<16)|((uint64_t)b[p+3]<<8)|b[p+4]; h.hlen=5; }
-                else if (h.addl==27) { h.val=((uint64_t)b[p+1]<<56)|((uint64_t)b[p+2]<<48)|((uint64_t)b[p+3]<<40)|((uint64_t)b[p+4]<<32)|((uint64_t)b[p+5]<<24)|((uint64_t)b[p+6]<<16)|((uint64_t)b[p+7]<<8)|b[p+8]; h.hlen=9; }
-                else if (h.addl==31) { h.indefinite=true; }
-                return h;
-            }
-            static std::size_t skip(std::span<const uint8_t> b, std::size_t p) {
-                auto h = read_head(b,p); std::size_t q=p+h.hlen;
-                switch (h.major) {
-                    case 0: case 1: return q;
-                    case 2: case 3:
-                        if (!h.indefinite) return q + (std::size_t)h.val;
-                        for (;;) { if (b[q]==0xFF) return q+1; auto ch=read_head(b,q); q += ch.hlen + (std::size_t)ch.val; }
-                    case 4:
-                        if (!h.indefinite) { for (uint64_t i=0;i<h.val;++i) q=skip(b,q); return q; }
-                        for(;;){ if(b[q]==0xFF) return q+1; q=skip(b,q);}        
-                    case 5:
-                        if (!h.indefinite) { for (uint64_t i=0;i<h.val;++i){ q=skip(b,q); q=skip(b,q);} return q; }
-                        for(;;){ if(b[q]==0xFF) return q+1; q=skip(b,q); q=skip(b,q);} 
-                    case 6: return skip(b,q);
-                    case 7:
-                        if (h.addl==25) return q+2; if (h.addl==26) return q+4; if (h.addl==27) return q+8; return q;
-                }
-                return q;
-            }
-
-            reference operator*() const {
-                auto kh = read_head(buf, q);
-                if (kh.major==3 && !kh.indefinite) {
-                    return std::string_view(reinterpret_cast<const char*>(&buf[q+kh.hlen]), (std::size_t)kh.val);
-                }
-                // fallback: materialize
-                CborDeserializer v(std::span<const uint8_t>(buf.data(), buf.size()), q);
-                scratch = v.asString();
-                return std::string_view(scratch);
-            }
-            iterator& operator++() {
-                if (indefinite) {
-                    if (buf[q]==0xFF) return *this; // already at end
-                    q = skip(buf,q); // key
-                    q = skip(buf,q); // value
-                } else {
-                    if (remaining==0) return *this;
-                    q = skip(buf,q); // key
-                    q = skip(buf,q); // value
-                    --remaining;
-                }
-                return *this;
-            }
+            reference operator*() const { return c.key(); }
+            iterator& operator++() { c.advance(); return *this; }
             iterator operator++(int) { auto t=*this; ++(*this); return t; }
-            friend bool operator==(const iterator& a, const iterator& b){ return a.q==b.q && a.buf.data()==b.buf.data(); }
+            // Iterators over one map are ordered by entry index alone.
+            friend bool operator==(const iterator& a, const iterator& b){ return a.c.i==b.c.i && a.c.buf.data()==b.c.buf.data(); }
         };
 
-        iterator begin() const {
-            iterator it; it.buf = buf; auto h = iterator::read_head(buf, start); std::size_t q = start + h.hlen; it.q = q; it.indefinite = h.indefinite; it.remaining = h.indefinite ? 0 : (uint64_t)h.val; return it;
-        }
-        iterator end()   const {
-            iterator it; it.buf = buf; auto h = iterator::read_head(buf, start); if (!h.indefinite) {
-                // compute end pos
-                std::size_t q = start + h.hlen; for (uint64_t i=0;i<h.val;++i){ q = iterator::skip(buf,q); q = iterator::skip(buf,q);} it.q = q; it.indefinite=false; it.remaining=0; return it;
-            } else {
-                // find break
-                std::size_t q = start + h.hlen; for(;;){ if (buf[q]==0xFF){ it.q=q+1; break; } q = iterator::skip(buf,q); q = iterator::skip(buf,q);} it.indefinite=true; return it;
-            }
-        }
+        iterator begin() const { return iterator{ MapCursor(buf, 0, count, first, &keys) }; }
+        iterator end()   const { return iterator{ MapCursor(buf, count, count, 0, nullptr) }; }
     };
 
-    KeysView mapKeys() const { auto h=head(); ensure(h.major==5, "CBOR: not a map"); return KeysView{ buf_, pos_ }; }
+    KeysView mapKeys() const {
+        auto h = head(); ensure(h.major==5, "CBOR: not a map");
+        std::size_t first = 0;
+        const std::size_t n = container_info(pos_, h, first);
+        return KeysView{ buf_, n, first };
+    }
 
     CborDeserializer operator[](std::string_view key) const {
         auto h = head(); ensure(h.major==5, "CBOR: not a map");
-        std::size_t q = pos_ + h.hlen;
-        if (!h.indefinite) {
-            for (uint64_t i=0;i<h.val;++i) {
-                CborDeserializer kview(buf_, q);
-                std::string k = kview.asString();
-                q = skip(q);
-                if (k == key) return CborDeserializer(buf_, q);
-                q = skip(q);
-            }
-        } else {
-            for(;;){ ensure(q<buf_.size(), "CBOR: trunc indef map"); if(buf_[q]==0xFF) break; CborDeserializer kview(buf_, q); std::string k = kview.asString(); q = skip(q); if (k==key) return CborDeserializer(buf_, q); q = skip(q);}        
-        }
-        throw DeserializationError("CBOR: key not found: " + std::string(key));
+        const std::size_t q = find_value(key);
+        if (q == npos) throw DeserializationError("CBOR: key not found: " + std::string(key));
+        return CborDeserializer(buf_, q);
+    }
+
+    // One-pass iteration over (key, value) pairs; see MapCursorReader. Keys
+    // live as long as KeysView keys do.
+    struct EntriesView {
+        std::span<const uint8_t> buf;
+        std::size_t count = 0;
+        std::size_t first = 0;
+        mutable std::shared_ptr<KeyStore> keys{};
+
+        struct iterator {
+            MapCursor c{};
+
+            using iterator_category = std::forward_iterator_tag;
+            using iterator_concept  = std::forward_iterator_tag;
+            using value_type        = std::pair<std::string_view, CborDeserializer>;
+            using difference_type   = std::ptrdiff_t;
+            using reference         = value_type;
+
+            reference operator*() const { return { c.key(), CborDeserializer(c.buf, c.val_off) }; }
+            iterator& operator++() { c.advance(); return *this; }
+            iterator operator++(int) { auto t=*this; ++(*this); return t; }
+            friend bool operator==(const iterator& a, const iterator& b){ return a.c.i==b.c.i && a.c.buf.data()==b.c.buf.data(); }
+        };
+
+        std::size_t size() const { return count; }
+        iterator begin() const { return iterator{ MapCursor(buf, 0, count, first, &keys) }; }
+        iterator end()   const { return iterator{ MapCursor(buf, count, count, 0, nullptr) }; }
+    };
+
+    EntriesView mapEntries() const {
+        auto h = head(); ensure(h.major==5, "CBOR: not a map");
+        std::size_t first = 0;
+        const std::size_t n = container_info(pos_, h, first);
+        return EntriesView{ buf_, n, first };
     }
 
     // ---- array interface ----
     std::size_t arraySize() const {
         auto h = head(); ensure(h.major==4, "CBOR: not an array");
         if (!h.indefinite) return static_cast<std::size_t>(h.val);
-        std::size_t q = pos_ + h.hlen; std::size_t c=0; for(;;){ ensure(q<buf_.size(), "CBOR: trunc indef arr"); if(buf_[q]==0xFF) break; q = skip(q); ++c; } return c;
+        std::size_t first = 0;
+        return container_info(pos_, h, first);
     }
+
+    // O(idx) unless this view came from indexed(). For full traversal use arrayElements().
     CborDeserializer operator[](std::size_t idx) const {
         auto h = head(); ensure(h.major==4, "CBOR: not an array");
+        if (index_) {
+            const auto& ix = *index_;
+            if (idx + 1 >= ix.size()) throw DeserializationError("CBOR: index OOB");
+            return CborDeserializer(buf_, ix[idx]);
+        }
         std::size_t q = pos_ + h.hlen;
         if (!h.indefinite) {
             if (idx >= h.val) throw DeserializationError("CBOR: index OOB");
             for (std::size_t i=0;i<idx;++i) q = skip(q);
             return CborDeserializer(buf_, q);
         } else {
-            for (std::size_t i=0;;++i){ ensure(q<buf_.size(), "CBOR: trunc indef arr"); if (buf_[q]==0xFF) break; if (i==idx) return CborDeserializer(buf_, q); q = skip(q);}            
+            for (std::size_t i=0;;++i){ ensure(q<buf_.size(), "CBOR: trunc indef arr"); if (buf_[q]==0xFF) break; if (i==idx) return CborDeserializer(buf_, q); q = skip(q);}
             throw DeserializationError("CBOR: index OOB");
         }
     }
 
+    // One-pass iteration over array elements; see ArrayCursorReader.
+    struct ElementsView {
+        std::span<const uint8_t> buf;
+        std::size_t count = 0;
+        std::size_t first = 0;
+
+        struct iterator {
+            std::span<const uint8_t> buf{};
+            std::size_t i = 0;
+            std::size_t off = 0; // offset of the current element
+
+            using iterator_category = std::forward_iterator_tag;
+            using iterator_concept  = std::forward_iterator_tag;
+            using value_type        = CborDeserializer;
+            using difference_type   = std::ptrdiff_t;
+            using reference         = CborDeserializer;
+
+            reference operator*() const { return CborDeserializer(buf, off); }
+            iterator& operator++() { off = cbor_skip(buf, off); ++i; return *this; }
+            iterator operator++(int) { auto t=*this; ++(*this); return t; }
+            friend bool operator==(const iterator& a, const iterator& b){ return a.i==b.i && a.buf.data()==b.buf.data(); }
+        };
+
+        std::size_t size() const { return count; }
+        iterator begin() const { return iterator{ buf, 0, first }; }
+        iterator end()   const { return iterator{ buf, count, 0 }; }
+    };
+
+    ElementsView arrayElements() const {
+        auto h = head(); ensure(h.major==4, "CBOR: not an array");
+        std::size_t first = 0;
+        const std::size_t n = container_info(pos_, h, first);
+        return ElementsView{ buf_, n, first };
+    }
+
+    // Returns a view of this array or map with an offset table, built in one
+    // pass: operator[](size_t) becomes O(1), and key lookups compare keys
+    // without re-skipping values. Copies of the returned view share the table;
+    // child views are not indexed. Like any subview, it borrows this view's bytes.
+    CborDeserializer indexed() const {
+        auto h = head(); ensure(h.major==4 || h.major==5, "CBOR: not an array or map");
+        std::size_t q = 0;
+        const std::size_t n = container_info(pos_, h, q);
+        const std::size_t slots = h.major==5 ? 2 * n : n;
+        auto ix = std::make_shared<std::vector<std::size_t>>();
+        ix->reserve(slots + 1);
+        for (std::size_t i = 0; i < slots; ++i) {
+            ix->push_back(q);
+            q = skip(q);
+        }
+        ix->push_back(q);
+        CborDeserializer out(buf_, pos_);
+        out.index_ = std::move(ix);
+        return out;
+    }
+
+    // The encoded bytes of this value.
+    std::span<const uint8_t> raw_view() const { return buf_.subspan(pos_, skip(pos_) - pos_); }
+
     // ---- debug ----
     std::string to_string() const {
         std::ostringstream os; dump_rec(os, pos_, 0); return os.str();
     }
 private:
-    static void indent(std::ostringstream& os, int n){ for(int i=0;i<n;++i) os.put(' ');}    
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    // Offset of the value for `key` (first match), or npos.
+    std::size_t find_value(std::string_view key) const {
+        if (index_) {
+            const auto& ix = *index_;
+            for (std::size_t k = 0; k + 2 < ix.size(); k += 2) {
+                if (cbor_key_equals(buf_, ix[k], key)) return ix[k + 1];
+            }
+            return npos;
+        }
+        auto h = head();
+        std::size_t q = pos_ + h.hlen;
+        for (uint64_t i = 0; h.indefinite || i < h.val; ++i) {
+            ensure(q < buf_.size(), "CBOR: truncated map");
+            if (h.indefinite && buf_[q] == 0xFF) break;
+            const bool match = cbor_key_equals(buf_, q, key);
+            q = skip(q); // key
+            if (match) return q;
+            q = skip(q); // value
+        }
+        return npos;
+    }
+
+    static void indent(std::ostringstream& os, int n){ for(int i=0;i<n;++i) os.put(' ');}
     const char* type_code(std::size_t p) const {
         auto h = read_head(p);
         switch (h.major){
@@ -508,23 +911,35 @@ private:
         }
     }
     void dump_rec(std::ostringstream& os, std::size_t p, int pad) const {
-        auto h = read_head(p); auto t = type_code(p); std::size_t q = p + h.hlen;
+        auto h = read_head(p); auto t = type_code(p);
+        CborDeserializer v(buf_, p);
         if (h.major==0) { os << t << '|' << h.val; }
         else if (h.major==1) { long long x = -1 - (long long)h.val; os << t << '|' << x; }
-        else if (h.major==7 && (h.addl==25||h.addl==26||h.addl==27)) { os << t << '|' << CborDeserializer(buf_, p).asDouble(); }
+        else if (h.major==7 && (h.addl==25||h.addl==26||h.addl==27)) { os << t << '|' << v.asDouble(); }
         else if (h.major==7 && (h.addl==20||h.addl==21)) { os << t << "| " << (h.addl==21?"true":"false"); }
         else if (h.major==7 && h.addl==22) { os << t << "|null"; }
-        else if (h.major==3) {
-            if (!h.indefinite) { os << t << "|\"" << std::string(reinterpret_cast<const char*>(&buf_[q]), (std::size_t)h.val) << '"'; }
-            else { os << t << "|\"" << CborDeserializer(buf_, p).asString() << '"'; }
-        } else if (h.major==2) {
-            std::size_t total = 0; if (!h.indefinite) total = (std::size_t)h.val; else { for(;;){ if(buf_[q]==0xFF) break; auto ch = read_head(q); total += (std::size_t)ch.val; q += ch.hlen + (std::size_t)ch.val; } }
-            os << t << "[size=" << total << "]";
-        } else if (h.major==4) {
-            os << t << " [\n"; std::size_t n = arraySize(); std::size_t e = p + h.hlen; for (std::size_t i=0;i<n;++i){ indent(os, pad+2); dump_rec(os, e, pad+2); if (i+1<n) os << ","; os << "\n"; e = skip(e);} indent(os, pad); os << ']';
+        else if (h.major==3) { os << t << "|\"" << v.asString() << '"'; }
+        else if (h.major==2) { os << t << "[size=" << v.asBlobVec().size() << "]"; }
+        else if (h.major==4) {
+            os << t << " [\n";
+            auto elems = v.arrayElements();
+            std::size_t i = 0, n = elems.size();
+            for (auto it = elems.begin(); it != elems.end(); ++it) {
+                indent(os, pad+2); dump_rec(os, it.off, pad+2);
+                if (++i < n) os << ",";
+                os << "\n";
+            }
+            indent(os, pad); os << ']';
         } else if (h.major==5) {
-            os << t << " {\n"; std::size_t q2 = p + h.hlen; std::size_t count = h.indefinite ? arraySize() : (std::size_t)h.val; // rough
-            std::size_t i=0; while (true){ if (h.indefinite && buf_[q2]==0xFF) { q2++; break; } indent(os, pad+2); os << '"' << CborDeserializer(buf_, q2).asString() << "\": "; q2 = skip(q2); dump_rec(os, q2, pad+2); q2 = skip(q2); if (++i < count) os << ","; os << "\n"; if (!h.indefinite && i>=count) break; }
+            os << t << " {\n";
+            auto entries = v.mapEntries();
+            std::size_t i = 0, n = entries.size();
+            for (auto it = entries.begin(); it != entries.end(); ++it) {
+                indent(os, pad+2); os << '"' << it.c.key() << "\": ";
+                dump_rec(os, it.c.val_off, pad+2);
+                if (++i < n) os << ",";
+                os << "\n";
+            }
             indent(os, pad); os << '}';
         } else {
             os << t;
@@ -532,13 +947,41 @@ private:
     }
 };
 
-} // namespace cborjc
+} // namespace cbor
 
 struct CBOR {
     static inline constexpr const char* Name = "CBOR";
-    using Deserializer   = cborjc::CborDeserializer;
-    using RootSerializer = cborjc::RootSerializer;
-    using Serializer     = cborjc::Serializer;
+    using Deserializer   = cbor::CborDeserializer;
+    using RootSerializer = cbor::RootSerializer;
+    using Serializer     = cbor::Serializer;
+    using SpanRootSerializer = cbor::BasicRootSerializer<SpanOutput>;
+    using SpanSerializer     = cbor::BasicSerializer<SpanOutput>;
+    using SizeCounter        = cbor::SizeCounter;
+
+    // Size of the message at the start of `b`; see SelfDelimitingProtocol.
+    static std::size_t frame_size(std::span<const uint8_t> b) { return cbor::cbor_skip(b, 0); }
+
+    // Overwrite a scalar in place; see PatchableProtocol. Numeric slots carry
+    // an 8-byte argument; an int64 slot flips between majors 0 and 1 with the
+    // sign of the value.
+    static void patch_bool(std::span<uint8_t> slot, bool v) {
+        if (slot.size() != 1 || (slot[0] != 0xf4 && slot[0] != 0xf5))
+            throw SerializationError("CBOR: patch slot is not the expected scalar");
+        slot[0] = v ? 0xf5 : 0xf4;
+    }
+    static void patch_int64(std::span<uint8_t> slot, std::int64_t v) {
+        const auto is_int = [](uint8_t ib) { return ib == 0x1b || ib == 0x3b; };
+        if (v >= 0) cbor::cbor_patch_head(slot, is_int, 0x1b, static_cast<uint64_t>(v));
+        else cbor::cbor_patch_head(slot, is_int, 0x3b, ~static_cast<uint64_t>(v)); // -1 - v
+    }
+    static void patch_uint64(std::span<uint8_t> slot, std::uint64_t v) {
+        cbor::cbor_patch_head(slot, [](uint8_t ib) { return ib == 0x1b; }, 0x1b, v);
+    }
+    static void patch_double(std::span<uint8_t> slot, double v) {
+        uint64_t bits = 0;
+        std::memcpy(&bits, &v, sizeof(bits));
+        cbor::cbor_patch_head(slot, [](uint8_t ib) { return ib == 0xfb; }, 0xfb, bits);
+    }
 };
 
 } // namespace zerialize
@@ -0,0 +1,110 @@
+// CBOR written through jsoncons' cbor_bytes_encoder, read by the native reader.
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+
+#include <zerialize/protocols/cbor.hpp>
+
+namespace zerialize {
+namespace cbor {
+
+/*
+ * CBORJsoncons is CBOR with jsoncons as the writer. The bytes are the same
+ * CBOR, and the reader, frame_size and patch functions are the same as CBOR's.
+ * Use it only when a build already depends on jsoncons and wants its encoder.
+ * The native CBOR writer has no dependencies, is faster, and is the default.
+ */
+struct JsonconsRootSerializer {
+    std::vector<uint8_t> out_;
+    jsoncons::cbor::cbor_bytes_encoder enc;
+    bool wrote_root = false;
+    BufferPool* pool_ = nullptr;
+
+    JsonconsRootSerializer()
+        : out_()
+        , enc(out_)
+    {}
+
+    // Output vectors come from `pool`, and finish() returns ZBuffers that give
+    // them back; see BufferPool.
+    explicit JsonconsRootSerializer(BufferPool& pool)
+        : out_(pool.acquire())
+        , enc(out_)
+        , pool_(&pool)
+    {}
+
+    JsonconsRootSerializer(const JsonconsRootSerializer&) = delete;
+    JsonconsRootSerializer& operator=(const JsonconsRootSerializer&) = delete;
+    ~JsonconsRootSerializer() {
+        if (pool_) pool_->release(std::move(out_));
+    }
+
+    ZBuffer finish() {
+        if (!wrote_root) {
+            enc.null_value();
+            wrote_root = true;
+        }
+        if (!pool_) return ZBuffer(std::move(out_));
+        ZBuffer result = pool_->wrap(std::move(out_));
+        out_ = pool_->acquire();
+        reset();
+        return result;
+    }
+
+    // Finalize in place; the span is valid until the next reset().
+    std::span<const std::uint8_t> finish_view() {
+        if (!wrote_root) {
+            enc.null_value();
+            wrote_root = true;
+        }
+        return std::span<const std::uint8_t>(out_);
+    }
+
+    // Discard the current message; the output vector keeps its capacity.
+    void reset() {
+        out_.clear();
+        enc.reset();
+        wrote_root = false;
+    }
+};
+
+struct JsonconsSerializer {
+    JsonconsRootSerializer* r;
+    explicit JsonconsSerializer(JsonconsRootSerializer& rs) : r(&rs) {}
+
+    // primitives
+    void null()                  { r->enc.null_value(); r->wrote_root = true; }
+    void boolean(bool v)         { r->enc.bool_value(v); r->wrote_root = true; }
+    void int64(std::int64_t v)   { r->enc.int64_value(v); r->wrote_root = true; }
+    void uint64(std::uint64_t v) { r->enc.uint64_value(v); r->wrote_root = true; }
+    void double_(double v)       { r->enc.double_value(v); r->wrote_root = true; }
+    void string(std::string_view sv) { r->enc.string_value(sv); r->wrote_root = true; }
+    void binary(std::span<const std::byte> b) {
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(b.data());
+        r->enc.byte_string_value(jsoncons::byte_string_view(p, b.size())); r->wrote_root = true;
+    }
+
+    // containers
+    void begin_array(std::size_t n) { r->enc.begin_array(n); r->wrote_root = true; }
+    void end_array()                { r->enc.end_array(); }
+    void begin_map(std::size_t n)   { r->enc.begin_object(n); r->wrote_root = true; }
+    void end_map()                  { r->enc.end_object(); }
+    void key(std::string_view k)    { r->enc.key(k); }
+};
+
+} // namespace cbor
+
+struct CBORJsoncons : CBOR {
+    using RootSerializer = cbor::JsonconsRootSerializer;
+    using Serializer     = cbor::JsonconsSerializer;
+};
+
+} // namespace zerialize
@@ -30,6 +30,11 @@ struct RootSerializer {
 
     RootSerializer() = default;
 
+    // Key sharing (the flexbuffers default) keeps a std::set of keys that is
+    // rebuilt per message; pass BUILDER_FLAG_NONE for allocation-free reuse.
+    explicit RootSerializer(::flexbuffers::BuilderFlag flags, std::size_t initial_size = 256)
+        : fbb(initial_size, flags) {}
+
     ZBuffer finish() {
         if (!finished_) {
             if (!wrote_root_) fbb.Null();  // ensure we wrote a root
@@ -41,6 +46,25 @@ struct RootSerializer {
         auto& hack = const_cast<std::vector<uint8_t>&>(buf);
         return ZBuffer(std::move(hack));
     }
+
+    // Finalize in place; the span is valid until the next reset().
+    std::span<const std::uint8_t> finish_view() {
+        if (!finished_) {
+            if (!wrote_root_) fbb.Null();
+            fbb.Finish();
+            finished_ = true;
+        }
+        const std::vector<uint8_t>& buf = fbb.GetBuffer();
+        return std::span<const std::uint8_t>(buf.data(), buf.size());
+    }
+
+    // Discard the current message; the builder keeps its buffer capacity.
+    void reset() {
+        fbb.Clear();
+        finished_ = false;
+        wrote_root_ = false;
+        st.clear();
+    }
 };
 
 struct Serializer {
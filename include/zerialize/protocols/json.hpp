@@ -1,5 +1,12 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstring>
 #include <string>
 #include <string_view>
 #include <span>
@@ -7,12 +14,26 @@
 #include <iterator>
 #include <cstddef>
 #include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+#include <new>
+#include <stdexcept>
 #include <type_traits>
+#include <utility>
 #include <yyjson.h>
 #include <zerialize/zbuffer.hpp>
 #include <zerialize/errors.hpp>
 #include <zerialize/concepts.hpp>
+#include <zerialize/output.hpp>
 #include <zerialize/internals/base64.hpp>
+#include <zerialize/internals/fixed_string.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
 
 namespace zerialize {
 namespace json {
@@ -77,10 +98,218 @@ struct KeysView {
 inline KeysView::iterator begin(const KeysView& kv) noexcept { return kv.begin(); }
 inline KeysView::iterator end  (const KeysView& kv) noexcept { return kv.end();   }
 
+/*
+ * Reading without malloc
+ * ----------------------
+ * By default each JsonDeserializer root mallocs a yyjson document and a copy
+ * of the text for its strings, and frees both when it is destroyed. Two
+ * opt-ins remove that work for repeated reads:
+ *
+ *   - A ReadAllocator (a yyjson dynamic allocator) keeps the chunks of freed
+ *     documents and hands them to the next document that fits. After a few
+ *     documents of similar size, reading no longer calls malloc.
+ *     ReadAllocator::local() is one per thread: documents read with it must
+ *     be destroyed on that thread, before it exits.
+ *
+ *   - JsonDeserializer::insitu() parses a mutable buffer the caller owns.
+ *     yyjson unescapes strings in place, so no copy of the text is made, and
+ *     asStringView() points into the buffer. The buffer needs InsituPadding
+ *     bytes after the JSON (they are zeroed) and must outlive the reader.
+ *
+ *   std::string text = receive();
+ *   const std::size_t n = text.size();
+ *   text.resize(n + json::InsituPadding);
+ *   auto doc = JSON::Deserializer::insitu(text, n, json::ReadAllocator::local());
+ */
+
+inline constexpr std::size_t InsituPadding = YYJSON_PADDING_SIZE;
+
+class ReadAllocator {
+public:
+    ReadAllocator() : alc_(yyjson_alc_dyn_new()) {
+        if (!alc_) throw std::bad_alloc{};
+    }
+    ~ReadAllocator() { yyjson_alc_dyn_free(alc_); }
+    ReadAllocator(const ReadAllocator&) = delete;
+    ReadAllocator& operator=(const ReadAllocator&) = delete;
+
+    // This thread's allocator (not locked). Its documents must be freed on this thread.
+    static ReadAllocator& local() {
+        thread_local ReadAllocator alc;
+        return alc;
+    }
+
+    const yyjson_alc* get() const noexcept { return alc_; }
+
+private:
+    yyjson_alc* alc_;
+};
+
+/*
+ * Key index
+ * ---------
+ * yyjson objects are lists: operator[](key) compares keys one by one, so
+ * reading every field of a 5,000-key object by name is quadratic. After
+ * enableKeyIndex() on a root reader, lookups in objects of at least MinKeys
+ * keys are counted per object. Past `after_lookups` lookups the object gets a
+ * hash table from key to value, and later lookups are one probe. Smaller
+ * objects, and objects only read a few times, are still scanned.
+ *
+ * The tables live with the document: every view of it (operator[], cursors)
+ * shares them, and they are freed with the root. Finished tables are found
+ * without locking; a mutex guards only the counts and building a table, so
+ * views can still be read from several threads. Lookups are counted in a
+ * fixed set of counters shared by objects that hash alike, so an object read
+ * once costs no allocation, and a collision only builds a table sooner.
+ * Duplicate keys resolve to the first, as yyjson_obj_getn does.
+ */
+
+// FNV-1a, 32-bit (as Zera's key_hash); constexpr for compile-time keys.
+constexpr std::uint32_t key_hash(std::string_view k) {
+    std::uint32_t h = 2166136261u;
+    for (char ch : k) {
+        h ^= static_cast<std::uint8_t>(ch);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+class KeyIndex {
+public:
+    static constexpr std::size_t MinKeys = 16;
+    static constexpr std::uint32_t DefaultAfterLookups = 8;
+
+    // A finished table; immutable once published, so read without the lock.
+    class Table {
+    public:
+        explicit Table(yyjson_val* obj) {
+            const std::size_t n = yyjson_obj_size(obj);
+            std::size_t cap = 16;
+            while (cap < 2 * n) cap <<= 1;
+            slots_.resize(cap);
+            mask_ = cap - 1;
+
+            yyjson_obj_iter it;
+            yyjson_obj_iter_init(obj, &it);
+            while (yyjson_val* k = yyjson_obj_iter_next(&it)) {
+                const std::string_view key(yyjson_get_str(k), yyjson_get_len(k));
+                const std::uint32_t hash = key_hash(key);
+                std::size_t i = hash & mask_;
+                while (slots_[i].key && !(slots_[i].hash == hash && key_of(slots_[i]) == key)) i = (i + 1) & mask_;
+                if (!slots_[i].key) slots_[i] = Slot{hash, k}; // else a duplicate: the first one wins
+            }
+        }
+
+        // The value for `key`, or nullptr; `hash` must be key_hash(key).
+        yyjson_val* find(std::string_view key, std::uint32_t hash) const {
+            for (std::size_t i = hash & mask_; slots_[i].key; i = (i + 1) & mask_) {
+                if (slots_[i].hash == hash && key_of(slots_[i]) == key) return yyjson_obj_iter_get_val(slots_[i].key);
+            }
+            return nullptr;
+        }
+
+    private:
+        struct Slot {
+            std::uint32_t hash = 0;
+            yyjson_val* key = nullptr; // nullptr == empty
+        };
+        static std::string_view key_of(const Slot& s) {
+            return std::string_view(yyjson_get_str(s.key), yyjson_get_len(s.key));
+        }
+
+        std::vector<Slot> slots_;
+        std::size_t mask_ = 0;
+    };
+
+    explicit KeyIndex(std::uint32_t after_lookups) : after_(after_lookups) {}
+
+    // Count a lookup in `obj`, which has at least MinKeys keys, and return
+    // its table once it has one; nullptr means scan it.
+    const Table* lookup(yyjson_val* obj) {
+        if (const Table* t = published(dir_.load(std::memory_order_acquire), obj)) return t;
+
+        std::lock_guard<std::mutex> lock(mu_);
+        Directory* dir = dir_.load(std::memory_order_relaxed);
+        if (const Table* t = published(dir, obj)) return t; // built while we waited
+        if (++counts_[hash_of(obj) % counts_.size()] <= after_) return nullptr;
+
+        tables_.push_back(std::make_unique<Table>(obj));
+        publish(dir, obj, tables_.back().get());
+        return tables_.back().get();
+    }
+
+private:
+    // Published tables by object: open addressing, filled under the lock
+    // and probed without it. A slot's table is stored before its object
+    // (release), so a reader that sees the object sees the table.
+    struct Directory {
+        struct Slot {
+            std::atomic<yyjson_val*> obj{nullptr};
+            std::atomic<const Table*> table{nullptr};
+        };
+        explicit Directory(std::size_t cap) : slots(new Slot[cap]), mask(cap - 1) {}
+        std::unique_ptr<Slot[]> slots;
+        std::size_t mask;
+        std::size_t used = 0;
+    };
+
+    static std::size_t hash_of(yyjson_val* obj) {
+        std::uint64_t h = reinterpret_cast<std::uintptr_t>(obj) >> 4;
+        h *= 0x9E3779B97F4A7C15ull;
+        return static_cast<std::size_t>(h ^ (h >> 32));
+    }
+
+    static const Table* published(const Directory* dir, yyjson_val* obj) {
+        if (!dir) return nullptr;
+        for (std::size_t i = hash_of(obj) & dir->mask;; i = (i + 1) & dir->mask) {
+            yyjson_val* o = dir->slots[i].obj.load(std::memory_order_acquire);
+            if (o == obj) return dir->slots[i].table.load(std::memory_order_relaxed);
+            if (!o) return nullptr;
+        }
+    }
+
+    static void insert(Directory& dir, yyjson_val* obj, const Table* t) {
+        std::size_t i = hash_of(obj) & dir.mask;
+        while (dir.slots[i].obj.load(std::memory_order_relaxed)) i = (i + 1) & dir.mask;
+        dir.slots[i].table.store(t, std::memory_order_relaxed);
+        dir.slots[i].obj.store(obj, std::memory_order_release);
+        ++dir.used;
+    }
+
+    // Add a table, moving to a directory twice the size when this one is
+    // half full. Readers may still be probing the old one, so directories
+    // are kept until the KeyIndex goes.
+    void publish(Directory* dir, yyjson_val* obj, const Table* t) {
+        if (!dir || 2 * (dir->used + 1) > dir->mask + 1) {
+            auto bigger = std::make_unique<Directory>(dir ? 2 * (dir->mask + 1) : 16);
+            if (dir) {
+                for (std::size_t i = 0; i <= dir->mask; ++i) {
+                    if (yyjson_val* o = dir->slots[i].obj.load(std::memory_order_relaxed))
+                        insert(*bigger, o, dir->slots[i].table.load(std::memory_order_relaxed));
+                }
+            }
+            insert(*bigger, obj, t);
+            dir_.store(bigger.get(), std::memory_order_release);
+            dirs_.push_back(std::move(bigger));
+            return;
+        }
+        insert(*dir, obj, t);
+    }
+
+    std::atomic<Directory*> dir_{nullptr};
+    std::mutex mu_;
+    std::array<std::uint32_t, 256> counts_{};
+    std::vector<std::unique_ptr<Table>> tables_;
+    std::vector<std::unique_ptr<Directory>> dirs_;
+    std::uint32_t after_;
+};
+
 class JsonDeserializer {
     yyjson_doc* doc_ = nullptr;         // owned when owns_doc_==true
     yyjson_val* cur_ = nullptr;          // view into doc_
     bool owns_doc_ = false;
+    std::unique_ptr<KeyIndex> own_index_; // the root's, after enableKeyIndex()
+    KeyIndex* index_ = nullptr;          // shared by the document's views
 
     static void ensure(bool cond, const char* msg) {
         if (!cond) throw DeserializationError(msg);
@@ -93,17 +322,39 @@ class JsonDeserializer {
             throw DeserializationError(std::string("Value is not a ") + what);
     }
 
-public:
-    // --- ctors: root (owning) ---
-    explicit JsonDeserializer(std::string_view json) {
+    static char* padded(std::span<char> buffer, std::size_t length) {
+        if (buffer.size() < length || buffer.size() - length < InsituPadding) {
+            throw DeserializationError("json: in-situ buffer needs " + std::to_string(InsituPadding) +
+                                       " bytes of padding after the text");
+        }
+        std::memset(buffer.data() + length, 0, InsituPadding);
+        return buffer.data();
+    }
+
+    // The value for `key` in this object, through its key index if it has
+    // one; `hash` is key_hash(key) when the caller has it.
+    yyjson_val* lookup(std::string_view key, const std::uint32_t* hash) const {
+        if (index_ && yyjson_obj_size(cur_) >= KeyIndex::MinKeys) {
+            if (const KeyIndex::Table* t = index_->lookup(cur_)) return t->find(key, hash ? *hash : key_hash(key));
+        }
+        return yyjson_obj_getn(cur_, key.data(), key.size());
+    }
+
+    // Without YYJSON_READ_INSITU yyjson only reads `text`, despite the char*.
+    JsonDeserializer(char* text, std::size_t n, yyjson_read_flag flags, const yyjson_alc* alc) {
         static_assert(Reader<JsonDeserializer>, "Derived must satisfy Reader concept");
 
-        doc_ = yyjson_read(json.data(), json.size(), 0);
+        doc_ = yyjson_read_opts(text, n, flags, alc, nullptr);
         ensure(doc_, "Failed to parse JSON");
         cur_ = yyjson_doc_get_root(doc_);
         ensure(cur_, "Failed to get JSON root");
         owns_doc_ = true;
     }
+
+public:
+    // --- ctors: root (owning) ---
+    explicit JsonDeserializer(std::string_view json)
+        : JsonDeserializer(const_cast<char*>(json.data()), json.size(), 0, nullptr) {}
     explicit JsonDeserializer(const uint8_t* data, std::size_t n)
         : JsonDeserializer(std::string_view(reinterpret_cast<const char*>(data), n)) {}
 
@@ -111,12 +362,25 @@ public:
         : JsonDeserializer(std::string_view(reinterpret_cast<const char*>(bytes.data()),
                                         bytes.size())) {}
 
+    // The document's memory comes from `alc`, which must outlive it.
+    JsonDeserializer(std::string_view json, ReadAllocator& alc)
+        : JsonDeserializer(const_cast<char*>(json.data()), json.size(), 0, alc.get()) {}
+
     // default: empty object {}
     JsonDeserializer() : JsonDeserializer(std::string_view("{}", 2)) {}
 
+    // Parse the first `length` bytes of `buffer` in place; buffer.size() must
+    // be at least length + InsituPadding. Strings are views into the buffer.
+    static JsonDeserializer insitu(std::span<char> buffer, std::size_t length) {
+        return JsonDeserializer(padded(buffer, length), length, YYJSON_READ_INSITU, nullptr);
+    }
+    static JsonDeserializer insitu(std::span<char> buffer, std::size_t length, ReadAllocator& alc) {
+        return JsonDeserializer(padded(buffer, length), length, YYJSON_READ_INSITU, alc.get());
+    }
+
     // --- view ctor (non-owning) ---
-    JsonDeserializer(yyjson_val* v, yyjson_doc* d)
-        : doc_(d), cur_(v), owns_doc_(false) { ensure(doc_ && cur_, "Null view"); }
+    JsonDeserializer(yyjson_val* v, yyjson_doc* d, KeyIndex* index = nullptr)
+        : doc_(d), cur_(v), owns_doc_(false), index_(index) { ensure(doc_ && cur_, "Null view"); }
 
     // --- dtor / move only ---
     ~JsonDeserializer() {
@@ -126,18 +390,29 @@ public:
     JsonDeserializer& operator=(const JsonDeserializer&) = delete;
 
     JsonDeserializer(JsonDeserializer&& o) noexcept
-        : doc_(o.doc_), cur_(o.cur_), owns_doc_(o.owns_doc_) {
-        o.doc_ = nullptr; o.cur_ = nullptr; o.owns_doc_ = false;
+        : doc_(o.doc_), cur_(o.cur_), owns_doc_(o.owns_doc_),
+          own_index_(std::move(o.own_index_)), index_(o.index_) {
+        o.doc_ = nullptr; o.cur_ = nullptr; o.owns_doc_ = false; o.index_ = nullptr;
     }
     JsonDeserializer& operator=(JsonDeserializer&& o) noexcept {
         if (this != &o) {
             if (owns_doc_ && doc_) yyjson_doc_free(doc_);
             doc_ = o.doc_; cur_ = o.cur_; owns_doc_ = o.owns_doc_;
-            o.doc_ = nullptr; o.cur_ = nullptr; o.owns_doc_ = false;
+            own_index_ = std::move(o.own_index_); index_ = o.index_;
+            o.doc_ = nullptr; o.cur_ = nullptr; o.owns_doc_ = false; o.index_ = nullptr;
         }
         return *this;
     }
 
+    // Give this document's large objects hash tables once they have been
+    // looked up more than `after_lookups` times (see "Key index" above).
+    // Root readers only, before taking the views that should use them.
+    void enableKeyIndex(std::uint32_t after_lookups = KeyIndex::DefaultAfterLookups) {
+        ensure(owns_doc_, "enableKeyIndex() on a view");
+        own_index_ = std::make_unique<KeyIndex>(after_lookups);
+        index_ = own_index_.get();
+    }
+
     // --- predicates (strict bool) ---
     bool isNull()   const { return cur_ && yyjson_is_null(cur_); }
     bool isBool()   const { return cur_ && yyjson_is_bool(cur_); }
@@ -185,10 +460,21 @@ public:
         return base64Decode((*this)[1].asStringView());
     }
 
+    // Decode a blob into caller memory instead (see BlobDecodeReader), e.g.
+    // straight into a tensor's storage: blobSize() bytes, no vector.
+    std::size_t blobSize() const {
+        ensure(isBlob(), "not a blob");
+        return base64DecodedSize((*this)[1].asStringView());
+    }
+    std::size_t readBlobInto(std::span<std::byte> dst) const {
+        ensure(isBlob(), "not a blob");
+        return base64DecodeTo((*this)[1].asStringView(), dst);
+    }
+
     // --- map interface ---
     bool contains(std::string_view key) const {
         if (!isMap()) return false;
-        return yyjson_obj_getn(cur_, key.data(), key.size()) != nullptr;
+        return lookup(key, nullptr) != nullptr;
     }
 
     KeysView mapKeys() const {
@@ -198,9 +484,19 @@ public:
 
     JsonDeserializer operator[](std::string_view key) const {
         check(yyjson_is_obj, "map/object");
-        yyjson_val* v = yyjson_obj_getn(cur_, key.data(), key.size());
+        yyjson_val* v = lookup(key, nullptr);
         if (!v) throw DeserializationError("Key not found: " + std::string(key));
-        return JsonDeserializer(v, doc_); // view
+        return JsonDeserializer(v, doc_, index_); // view
+    }
+
+    // Lookup with a precomputed hash; see HashedKeyReader. Only objects
+    // that can have a key index say so, and only after enableKeyIndex().
+    static constexpr std::uint32_t key_hash(std::string_view k) { return json::key_hash(k); }
+    bool hasKeyIndex() const { return index_ && isMap() && yyjson_obj_size(cur_) >= KeyIndex::MinKeys; }
+    std::optional<JsonDeserializer> find(std::string_view key, std::uint32_t hash) const { // hash == key_hash(key)
+        check(yyjson_is_obj, "map/object");
+        if (yyjson_val* v = lookup(key, &hash)) return JsonDeserializer(v, doc_, index_);
+        return std::nullopt;
     }
 
     // --- array interface ---
@@ -212,7 +508,89 @@ public:
         check(yyjson_is_arr, "array");
         yyjson_val* v = yyjson_arr_get(cur_, idx);
         if (!v) throw DeserializationError("Array index out of range");
-        return JsonDeserializer(v, doc_); // view
+        return JsonDeserializer(v, doc_, index_); // view
+    }
+
+    // --- cursors (see ArrayCursorReader / MapCursorReader) ---
+    // yyjson_arr_get and yyjson_obj_getn walk the container from the front,
+    // so full traversal goes through yyjson's iterators instead.
+    struct EntriesView {
+        yyjson_val* obj;
+        yyjson_doc* doc;
+        KeyIndex*   index;
+
+        struct iterator {
+            yyjson_doc*     doc = nullptr;
+            KeyIndex*       index = nullptr;
+            yyjson_obj_iter it{};
+            yyjson_val*     key = nullptr; // nullptr == end
+
+            using iterator_concept  = std::forward_iterator_tag;
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = std::pair<std::string_view, JsonDeserializer>;
+            using difference_type   = std::ptrdiff_t;
+            using reference         = value_type;
+
+            reference operator*() const {
+                return { std::string_view(yyjson_get_str(key), yyjson_get_len(key)),
+                         JsonDeserializer(yyjson_obj_iter_get_val(key), doc, index) };
+            }
+            iterator& operator++() { key = yyjson_obj_iter_next(&it); return *this; }
+            iterator operator++(int) { iterator tmp = *this; ++(*this); return tmp; }
+            friend bool operator==(const iterator& a, const iterator& b) { return a.key == b.key; }
+        };
+
+        std::size_t size() const { return yyjson_obj_size(obj); }
+        iterator begin() const {
+            iterator i{doc, index};
+            yyjson_obj_iter_init(obj, &i.it);
+            i.key = yyjson_obj_iter_next(&i.it);
+            return i;
+        }
+        iterator end() const { return iterator{doc}; }
+    };
+
+    EntriesView mapEntries() const {
+        check(yyjson_is_obj, "map/object");
+        return EntriesView{cur_, doc_, index_};
+    }
+
+    struct ElementsView {
+        yyjson_val* arr;
+        yyjson_doc* doc;
+        KeyIndex*   index;
+
+        struct iterator {
+            yyjson_doc*     doc = nullptr;
+            KeyIndex*       index = nullptr;
+            yyjson_arr_iter it{};
+            yyjson_val*     val = nullptr; // nullptr == end
+
+            using iterator_concept  = std::forward_iterator_tag;
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = JsonDeserializer;
+            using difference_type   = std::ptrdiff_t;
+            using reference         = JsonDeserializer;
+
+            reference operator*() const { return JsonDeserializer(val, doc, index); }
+            iterator& operator++() { val = yyjson_arr_iter_next(&it); return *this; }
+            iterator operator++(int) { iterator tmp = *this; ++(*this); return tmp; }
+            friend bool operator==(const iterator& a, const iterator& b) { return a.val == b.val; }
+        };
+
+        std::size_t size() const { return yyjson_arr_size(arr); }
+        iterator begin() const {
+            iterator i{doc, index};
+            yyjson_arr_iter_init(arr, &i.it);
+            i.val = yyjson_arr_iter_next(&i.it);
+            return i;
+        }
+        iterator end() const { return iterator{doc}; }
+    };
+
+    ElementsView arrayElements() const {
+        check(yyjson_is_arr, "array");
+        return ElementsView{cur_, doc_, index_};
     }
 
     // --- debug helper ---
@@ -233,6 +611,92 @@ public:
 
 
 
+/*
+ * WritePool is the RootSerializer's reuse allocator. Blocks given back by
+ * yyjson are kept and handed out again for any request that fits, so a
+ * serializer that is reset between messages of similar shape stops
+ * allocating after warm-up. Fresh blocks come from a base allocator (malloc
+ * when none is given), which makes the remaining allocations observable.
+ */
+class WritePool {
+public:
+    explicit WritePool(const yyjson_alc* base)
+        : base_(base ? *base : yyjson_alc{&sys_malloc, &sys_realloc, &sys_free, nullptr}),
+          alc_{&pool_malloc, &pool_realloc, &pool_free, this} {}
+    ~WritePool() {
+        for (const Block& b : free_) base_.free(base_.ctx, raw(b.p));
+    }
+    WritePool(const WritePool&) = delete;
+    WritePool& operator=(const WritePool&) = delete;
+
+    const yyjson_alc* get() const noexcept { return &alc_; }
+
+private:
+    // Each block is preceded by its capacity, padded to keep malloc alignment.
+    static constexpr std::size_t Header = alignof(std::max_align_t);
+    static_assert(Header >= sizeof(std::size_t));
+    static constexpr std::size_t MinBlock = 64;
+
+    struct Block { void* p; std::size_t cap; };
+
+    static void* raw(void* p) noexcept { return static_cast<char*>(p) - Header; }
+    static std::size_t& cap(void* p) noexcept { return *static_cast<std::size_t*>(raw(p)); }
+
+    static void* sys_malloc(void*, std::size_t n) { return std::malloc(n); }
+    static void* sys_realloc(void*, void* p, std::size_t, std::size_t n) { return std::realloc(p, n); }
+    static void sys_free(void*, void* p) { std::free(p); }
+
+    static void* pool_malloc(void* ctx, std::size_t n) {
+        auto& self = *static_cast<WritePool*>(ctx);
+        // Best fit keeps large blocks for the requests that need them.
+        std::size_t best = self.free_.size();
+        for (std::size_t i = 0; i < self.free_.size(); ++i) {
+            if (self.free_[i].cap >= n && (best == self.free_.size() || self.free_[i].cap < self.free_[best].cap))
+                best = i;
+        }
+        if (best != self.free_.size()) {
+            void* p = self.free_[best].p;
+            self.free_[best] = self.free_.back();
+            self.free_.pop_back();
+            return p;
+        }
+        // Round fresh blocks up to a power of two, so a message that grows
+        // by a few bytes still fits in a block from an earlier one.
+        if (n > (SIZE_MAX >> 1) - Header) return nullptr;
+        const std::size_t size = std::bit_ceil(std::max(n + Header, MinBlock));
+        void* r = self.base_.malloc(self.base_.ctx, size);
+        if (!r) return nullptr;
+        void* p = static_cast<char*>(r) + Header;
+        cap(p) = size - Header;
+        return p;
+    }
+
+    static void* pool_realloc(void* ctx, void* p, std::size_t old_size, std::size_t n) {
+        if (!p) return pool_malloc(ctx, n);
+        if (cap(p) >= n) return p;
+        void* q = pool_malloc(ctx, n);
+        if (!q) return nullptr;
+        std::memcpy(q, p, std::min(old_size, n));
+        pool_free(ctx, p);
+        return q;
+    }
+
+    static void pool_free(void* ctx, void* p) {
+        if (!p) return;
+        auto& self = *static_cast<WritePool*>(ctx);
+        // Called from C: a block that cannot be kept goes back to the base.
+        try {
+            self.free_.push_back(Block{p, cap(p)});
+        } catch (...) {
+            self.base_.free(self.base_.ctx, raw(p));
+        }
+    }
+
+    yyjson_alc base_;
+    yyjson_alc alc_;
+    std::vector<Block> free_;
+};
+
 struct RootSerializer {
     yyjson_mut_doc* doc = nullptr;
     yyjson_mut_val* root = nullptr;
@@ -241,20 +705,33 @@ struct RootSerializer {
     struct Ctx {
         enum K { Arr, Obj } k;
         yyjson_mut_val* node;        // array or object node
-        std::string pending_key;     // for objects: set by key(), consumed by next value
+        yyjson_mut_val* pending_key; // for objects: set by key(), consumed by next value
     };
     std::vector<Ctx> st;
+    std::string blob_text;           // base64 of the last binary(), reused
+
+    // Reuse state (see reset()/finish_view()). The pool keeps the document
+    // pools and write buffers alive across messages.
+    const yyjson_alc* base = nullptr;  // where memory comes from (malloc when null)
+    std::optional<WritePool> pool;
+    char* view = nullptr;            // last finish_view() output, owned by pool (or base)
 
-    RootSerializer() : doc(yyjson_mut_doc_new(nullptr)) {
+    RootSerializer() : RootSerializer(nullptr) {}
+    // `base_alc` must outlive the serializer.
+    explicit RootSerializer(const yyjson_alc* base_alc)
+        : doc(yyjson_mut_doc_new(base_alc)), base(base_alc) {
         if (!doc) throw std::bad_alloc{};
     }
+    ~RootSerializer() {
+        release_view();
+        if (doc) yyjson_mut_doc_free(doc);
+    }
+    RootSerializer(const RootSerializer&) = delete;
+    RootSerializer& operator=(const RootSerializer&) = delete;
 
     // Consume and produce the final buffer.
     ZBuffer finish() {
-        if (!root) {
-            root = yyjson_mut_null(doc);
-            yyjson_mut_doc_set_root(doc, root);
-        }
+        set_default_root();
 
         size_t len = 0;
         char* s = yyjson_mut_write(doc, 0, &len);
@@ -270,6 +747,48 @@ struct RootSerializer {
         doc = nullptr;
         return ZBuffer(static_cast<void*>(s), len, ZBuffer::Deleters::Free);
     }
+
+    // Produce the bytes without giving up the serializer's memory. The view
+    // stays valid until the next reset() (or destruction).
+    std::span<const std::uint8_t> finish_view() {
+        if (!doc) throw std::logic_error("finish_view() after finish()");
+        set_default_root();
+        release_view();
+        size_t len = 0;
+        view = yyjson_mut_write_opts(doc, 0, pool ? pool->get() : base, &len, nullptr);
+        if (!view) throw std::runtime_error("yyjson_mut_write failed");
+        return std::span<const std::uint8_t>(reinterpret_cast<const std::uint8_t*>(view), len);
+    }
+
+    // Discard the current message. After the first reset the document is
+    // allocated from a pool that keeps its blocks, so steady-state messages
+    // don't touch the base allocator.
+    void reset() {
+        release_view();
+        if (!pool) pool.emplace(base);
+        if (doc) yyjson_mut_doc_free(doc);
+        doc = yyjson_mut_doc_new(pool->get());
+        if (!doc) throw std::bad_alloc{};
+        root = nullptr;
+        wrote_root = false;
+        st.clear();
+    }
+
+private:
+    void set_default_root() {
+        if (!root) {
+            root = yyjson_mut_null(doc);
+            yyjson_mut_doc_set_root(doc, root);
+        }
+    }
+
+    void release_view() {
+        if (!view) return;
+        const yyjson_alc* a = pool ? pool->get() : base;
+        if (a) a->free(a->ctx, view);
+        else std::free(view);
+        view = nullptr;
+    }
 };
 
 struct Serializer {
@@ -286,15 +805,24 @@ struct Serializer {
     void string(std::string_view sv) {
         push_value(yyjson_mut_strn(doc(), sv.data(), sv.size()));
     }
-    // Encode binary as array of 0..255
+    // A blob is the array ["~b", <base64 text>, "base64"]. The text is
+    // encoded into the serializer's scratch string, which keeps its capacity,
+    // and copied into the document's string pool once.
     void binary(std::span<const std::byte> b) {
-        std::string s = base64Encode(b);
+        const std::size_t n = base64EncodedSize(b.size());
+        std::string& text = r->blob_text;
+        text.resize(n);
+        base64EncodeTo(b, text.data());
+        yyjson_mut_val* v = yyjson_mut_strncpy(doc(), text.data(), n);
+        if (!v) throw std::bad_alloc{};
+#ifdef YYJSON_SUBTYPE_NOESC
+        // Base64 never needs escaping, so the writer can copy it as is.
+        if (v) yyjson_mut_set_str_noesc(v, true);
+#endif
 
-        // A 'binary' will actually be an array, the first element 
-        // will be a string with the magic string "~b"
         begin_array(3);
         this->string(blobTag);
-        push_value(yyjson_mut_strncpy(doc(), s.data(), s.size()));
+        push_value(v);
         this->string(blobEncoding);
         end_array();
     }
@@ -304,7 +832,7 @@ struct Serializer {
         yyjson_mut_val* arr = yyjson_mut_arr(doc());
         if (!arr) throw std::bad_alloc{};
         push_value(arr);                       // attach to parent/root first
-        r->st.push_back({RootSerializer::Ctx::Arr, arr, {}}); // then track context
+        r->st.push_back({RootSerializer::Ctx::Arr, arr, nullptr}); // then track context
     }
     void end_array() {
         ensure_in(RootSerializer::Ctx::Arr, "end_array");
@@ -315,11 +843,11 @@ struct Serializer {
         yyjson_mut_val* obj = yyjson_mut_obj(doc());
         if (!obj) throw std::bad_alloc{};
         push_value(obj);
-        r->st.push_back({RootSerializer::Ctx::Obj, obj, {}});
+        r->st.push_back({RootSerializer::Ctx::Obj, obj, nullptr});
     }
     void end_map() {
         ensure_in(RootSerializer::Ctx::Obj, "end_map");
-        if (!r->st.back().pending_key.empty())
+        if (r->st.back().pending_key)
             throw std::logic_error("end_map() while awaiting value for key()");
         r->st.pop_back();
     }
@@ -327,10 +855,12 @@ struct Serializer {
     void key(std::string_view k) {
         ensure_in(RootSerializer::Ctx::Obj, "key");
         auto& c = r->st.back();
-        if (!c.pending_key.empty())
+        if (c.pending_key)
             throw std::logic_error("key() called twice without value");
-        c.pending_key.assign(k.data(), k.size());
-     }
+        // Copied into the document's string pool right away, so no per-key std::string.
+        c.pending_key = yyjson_mut_strncpy(doc(), k.data(), k.size());
+        if (!c.pending_key) throw std::bad_alloc{};
+    }
 
 private:
     yyjson_mut_doc* doc() const { return r->doc; }
@@ -353,31 +883,12 @@ private:
                 throw std::bad_alloc{};
         } else {
 
-            // current: c.pending_key holds a std::string we set in key()
-            // auto& c = r->st.back();
-            if (c.pending_key.empty())
+            if (!c.pending_key)
                 throw std::logic_error("value added to object without key()");
-    
-            // optional sanity check during debug
-            #ifndef NDEBUG
-            if (c.pending_key.find('\0') != std::string::npos) {
-                throw std::logic_error("embedded NUL in key() input");
-            }
-            #endif
-    
-            // EITHER use the convenience helper if your yyjson has it:
-            #if defined(YYJSON_VERSION_HEX) && (YYJSON_VERSION_HEX >= 0x000e00) // 0.14.0+
-            if (!yyjson_mut_obj_add_str(doc(), c.node, c.pending_key.c_str(), v))
-                throw std::bad_alloc{};
-            #else
-            // OR the portable two-step using a *cpy* string node (always null-terminated):
-            yyjson_mut_val* k = yyjson_mut_strcpy(doc(), c.pending_key.c_str());
-            if (!k || !yyjson_mut_obj_add(c.node, k, v))
+            if (!yyjson_mut_obj_add(c.node, c.pending_key, v))
                 throw std::bad_alloc{};
-            #endif
-    
-            c.pending_key.clear();
-    }
+            c.pending_key = nullptr;
+        }
     }
 
     void ensure_in(RootSerializer::Ctx::K want, const char* fn) const {
@@ -386,6 +897,414 @@ private:
     }
 };
 
+/*
+ * Direct writer (JSONDirect)
+ * --------------------------
+ * Writes JSON text into an output policy (output.hpp) as the Writer calls
+ * arrive: no document, no nodes, no string pool. A ',' or ':' goes in front
+ * of each value according to the container it is in. Integers use
+ * std::to_chars. Doubles use the shortest round-trip digits, laid out as
+ * yyjson lays them out. Strings are copied in 16-byte blocks up to the next
+ * byte that needs an escape or a UTF-8 check. The bytes are the same as
+ * json::RootSerializer's (yyjson_mut_write, no flags), with two differences
+ * in timing: NaN, infinity and invalid UTF-8 throw SerializationError as
+ * they are written, where the DOM writer fails in finish().
+ */
+namespace text {
+
+// What a byte needs inside a JSON string: 0 copy, 1 short escape (\n),
+// 2 \u00XX, 3 the start of a UTF-8 sequence to check.
+inline constexpr std::array<std::uint8_t, 256> byte_class = [] {
+    std::array<std::uint8_t, 256> t{};
+    for (int c = 0; c < 0x20; ++c) t[c] = 2;
+    for (int c : {'\b', '\t', '\n', '\f', '\r', '"', '\\'}) t[c] = 1;
+    for (int c = 0x80; c < 0x100; ++c) t[c] = 3;
+    return t;
+}();
+
+constexpr char short_escape(unsigned char c) {
+    switch (c) {
+        case '\b': return 'b';
+        case '\t': return 't';
+        case '\n': return 'n';
+        case '\f': return 'f';
+        case '\r': return 'r';
+        default:   return static_cast<char>(c); // '"' and '\\'
+    }
+}
+
+// Length of the valid UTF-8 sequence at the start of p[0, n), or 0. Rejects
+// overlong forms, surrogates and code points past U+10FFFF, as yyjson does.
+constexpr std::size_t utf8_length(const unsigned char* p, std::size_t n) {
+    auto cont = [&](std::size_t i) { return i < n && (p[i] & 0xC0) == 0x80; };
+    const unsigned char c = p[0];
+    if (c >= 0xC2 && c <= 0xDF) return cont(1) ? 2 : 0;
+    if (c >= 0xE0 && c <= 0xEF) {
+        if (!cont(1) || !cont(2)) return 0;
+        if ((c == 0xE0 && p[1] < 0xA0) || (c == 0xED && p[1] >= 0xA0)) return 0;
+        return 3;
+    }
+    if (c >= 0xF0 && c <= 0xF4) {
+        if (!cont(1) || !cont(2) || !cont(3)) return 0;
+        if ((c == 0xF0 && p[1] < 0x90) || (c == 0xF4 && p[1] >= 0x90)) return 0;
+        return 4;
+    }
+    return 0;
+}
+
+constexpr bool utf8_valid(std::string_view s) {
+    for (std::size_t i = 0; i < s.size();) {
+        if (static_cast<unsigned char>(s[i]) < 0x80) { ++i; continue; }
+        unsigned char u[4] = {};
+        const std::size_t m = s.size() - i < 4 ? s.size() - i : 4;
+        for (std::size_t j = 0; j < m; ++j) u[j] = static_cast<unsigned char>(s[i + j]);
+        const std::size_t len = utf8_length(u, m);
+        if (len == 0) return false;
+        i += len;
+    }
+    return true;
+}
+
+// Leading bytes of p[0, n) that are copied as they are.
+inline std::size_t plain_prefix(const char* p, std::size_t n) {
+    std::size_t i = 0;
+#if defined(__SSE2__) || defined(_M_X64)
+    // One signed compare finds both control bytes (< 0x20) and non-ASCII (>= 0x80).
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i space = _mm_set1_epi8(0x20);
+    for (; n - i >= 16; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        const __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+                                         _mm_cmplt_epi8(v, space));
+        if (const int mask = _mm_movemask_epi8(hit)) {
+            int k = 0;
+            while (!(mask & (1 << k))) ++k;
+            return i + static_cast<std::size_t>(k);
+        }
+    }
+#endif
+    while (i < n && byte_class[static_cast<unsigned char>(p[i])] == 0) ++i;
+    return i;
+}
+
+// Size of `s` written as a JSON string, quotes included (s must be valid UTF-8).
+constexpr std::size_t quoted_size(std::string_view s) {
+    std::size_t n = 2;
+    for (char ch : s) {
+        const std::uint8_t k = byte_class[static_cast<unsigned char>(ch)];
+        n += k == 1 ? 2 : k == 2 ? 6 : 1;
+    }
+    return n;
+}
+
+inline constexpr char hex_digits[] = "0123456789ABCDEF";
+
+// Key K as `"K":`, escaped at compile time; see RawKeyWriter.
+template<fixed_string K>
+inline constexpr auto encoded_key = [] {
+    constexpr std::string_view k = K.view();
+    static_assert(utf8_valid(k), "JSON: compile-time key is not valid UTF-8");
+    std::array<char, quoted_size(k) + 1> out{};
+    std::size_t o = 0;
+    out[o++] = '"';
+    for (char ch : k) {
+        const auto c = static_cast<unsigned char>(ch);
+        const std::uint8_t cls = byte_class[c];
+        if (cls == 1) {
+            out[o++] = '\\';
+            out[o++] = short_escape(c);
+        } else if (cls == 2) {
+            for (char e : {'\\', 'u', '0', '0', hex_digits[c >> 4], hex_digits[c & 15]}) out[o++] = e;
+        } else {
+            out[o++] = ch;
+        }
+    }
+    out[o++] = '"';
+    out[o++] = ':';
+    return out;
+}();
+
+// `v` as yyjson writes a double: the shortest digits that read back as v,
+// plain from 1e-6 up to 1e21 (with ".0" if there is no fraction), and as
+// d.ddde[-]x outside that range. Returns the length (at most 25).
+inline std::size_t format_double(double v, char* out) {
+    char* p = out;
+    if (std::signbit(v)) { *p++ = '-'; v = -v; }
+    if (v == 0) {
+        std::memcpy(p, "0.0", 3);
+        return static_cast<std::size_t>(p + 3 - out);
+    }
+
+    char sci[32];
+    const char* end = std::to_chars(sci, sci + sizeof(sci), v, std::chars_format::scientific).ptr;
+    char digits[17];
+    int n = 0;
+    const char* s = sci;
+    digits[n++] = *s++;
+    if (*s == '.') for (++s; *s != 'e'; ++s) digits[n++] = *s;
+    ++s;                                   // 'e'
+    const bool neg_exp = *s++ == '-';
+    int e = 0;
+    for (; s < end; ++s) e = e * 10 + (*s - '0');
+    if (neg_exp) e = -e;
+
+    const int dot = e + 1;                 // decimal point, relative to the first digit
+    if (-6 < dot && dot <= 21) {
+        if (dot <= 0) {
+            *p++ = '0';
+            *p++ = '.';
+            for (int i = dot; i < 0; ++i) *p++ = '0';
+            std::memcpy(p, digits, n);
+            p += n;
+        } else if (n <= dot) {
+            std::memcpy(p, digits, n);
+            p += n;
+            for (int i = n; i < dot; ++i) *p++ = '0';
+            *p++ = '.';
+            *p++ = '0';
+        } else {
+            std::memcpy(p, digits, dot);
+            p += dot;
+            *p++ = '.';
+            std::memcpy(p, digits + dot, n - dot);
+            p += n - dot;
+        }
+    } else {
+        *p++ = digits[0];
+        if (n > 1) {
+            *p++ = '.';
+            std::memcpy(p, digits + 1, n - 1);
+            p += n - 1;
+        }
+        *p++ = 'e';
+        if (e < 0) { *p++ = '-'; e = -e; }
+        p = std::to_chars(p, p + 3, e).ptr;
+    }
+    return static_cast<std::size_t>(p - out);
+}
+
+} // namespace text
+
+template<class Out = VectorOutput>
+class BasicDirectRootSerializer {
+public:
+    Out out_;
+    std::vector<std::uint8_t> open_;  // '[' or '{' for each open container
+    bool comma_ = false;              // the next value or key follows a sibling
+    bool key_done_ = false;           // in an object: a key was written, its value is next
+    bool wrote_root_ = false;
+
+    BasicDirectRootSerializer() = default;
+
+    // Vectors come from `pool`; finish() returns ZBuffers that give them back.
+    explicit BasicDirectRootSerializer(BufferPool& pool)
+        requires std::constructible_from<Out, BufferPool&>
+        : out_(pool) {}
+
+    // Write into `dst` (SpanOutput); see serialize_to().
+    explicit BasicDirectRootSerializer(std::span<std::uint8_t> dst)
+        requires std::constructible_from<Out, std::span<std::uint8_t>>
+        : out_(dst) {}
+    explicit BasicDirectRootSerializer(std::span<std::byte> dst)
+        requires std::constructible_from<Out, std::span<std::byte>>
+        : out_(dst) {}
+
+    BasicDirectRootSerializer(BasicDirectRootSerializer&&) = default;
+    BasicDirectRootSerializer& operator=(BasicDirectRootSerializer&&) = default;
+
+    // Size hint: a message of up to `bytes` is written without regrowing.
+    void reserve(std::size_t bytes) requires requires (Out& o) { o.reserve(bytes); } {
+        out_.reserve(bytes);
+    }
+
+    ZBuffer finish() {
+        finalize();
+        ZBuffer result = out_.take();
+        reset();
+        return result;
+    }
+
+    // Bytes written so far; valid until the next reset(). With SpanOutput,
+    // throws OutputOverflow if the message did not fit.
+    std::span<const std::uint8_t> finish_view() {
+        finalize();
+        return out_.view();
+    }
+
+    // Discard the current message, keeping the output storage.
+    void reset() {
+        out_.clear();
+        open_.clear();
+        comma_ = key_done_ = wrote_root_ = false;
+    }
+
+    // Discard the current message and write the next ones into `dst`.
+    void reset(std::span<std::byte> dst) requires requires (Out& o) { o.reset(dst); } {
+        reset();
+        out_.reset(dst);
+    }
+
+    // ---- encoding helpers (called by the Serializer) ----
+
+    void finalize() {
+        if (!open_.empty()) throw SerializationError("json: finish() called with unterminated container");
+        if (!wrote_root_) put_bytes("null", 4);
+        wrote_root_ = true;
+    }
+
+    // Before a value: its separator, or the check that a key came first.
+    void value() {
+        if (open_.empty()) {
+            if (wrote_root_) throw SerializationError("json: multiple root values");
+            wrote_root_ = true;
+            return;
+        }
+        if (open_.back() == '{') {
+            if (!key_done_) throw SerializationError("json: value added to object without key()");
+            key_done_ = false;
+        } else if (comma_) {
+            put_byte(',');
+        }
+        comma_ = true;
+    }
+
+    void key_start() {
+        if (open_.empty() || open_.back() != '{') throw SerializationError("json: key() called outside an object");
+        if (key_done_) throw SerializationError("json: key() called twice without value");
+        if (comma_) put_byte(',');
+        key_done_ = true;
+    }
+
+    void open(std::uint8_t bracket) {
+        if (open_.capacity() == 0) open_.reserve(16);
+        open_.push_back(bracket);
+        put_byte(bracket);
+        comma_ = false;
+    }
+
+    void close(std::uint8_t bracket) {
+        if (open_.empty() || open_.back() != bracket) {
+            throw SerializationError(bracket == '[' ? "json: end_array() outside an array"
+                                                    : "json: end_map() outside an object");
+        }
+        if (key_done_) throw SerializationError("json: end_map() while awaiting value for key()");
+        open_.pop_back();
+        put_byte(bracket == '[' ? ']' : '}');
+        comma_ = true;
+    }
+
+    void put_byte(std::uint8_t b) { *out_.room(1) = b; out_.commit(1); }
+    void put_bytes(const void* p, std::size_t n) { output_bytes(out_, p, n); }
+
+    template<class Int>
+    void put_int(Int v) {
+        char buf[24];
+        put_bytes(buf, static_cast<std::size_t>(std::to_chars(buf, buf + sizeof(buf), v).ptr - buf));
+    }
+
+    void put_double(double v) {
+        if (!std::isfinite(v)) throw SerializationError("json: NaN and infinity have no JSON form");
+        char buf[32];
+        put_bytes(buf, text::format_double(v, buf));
+    }
+
+    void put_string(std::string_view s) {
+        const char* p = s.data();
+        const std::size_t n = s.size();
+        put_byte('"');
+        std::size_t run = 0;   // start of the bytes not yet copied
+        std::size_t i = 0;
+        while (i < n) {
+            i += text::plain_prefix(p + i, n - i);
+            if (i == n) break;
+            const auto c = static_cast<unsigned char>(p[i]);
+            if (c >= 0x80) {
+                const std::size_t len = text::utf8_length(reinterpret_cast<const unsigned char*>(p + i), n - i);
+                if (len == 0) throw SerializationError("json: invalid UTF-8 in string");
+                i += len;       // copied with the run
+                continue;
+            }
+            put_bytes(p + run, i - run);
+            if (text::byte_class[c] == 1) {
+                const char e[2] = {'\\', text::short_escape(c)};
+                put_bytes(e, 2);
+            } else {
+                const char e[6] = {'\\', 'u', '0', '0', text::hex_digits[c >> 4], text::hex_digits[c & 15]};
+                put_bytes(e, 6);
+            }
+            run = ++i;
+        }
+        put_bytes(p + run, n - run);
+        put_byte('"');
+    }
+
+    // Base64 text goes straight into a growable output; other outputs take
+    // it through a small buffer, since room() is only for short writes.
+    void put_base64(std::span<const std::byte> b) {
+        if constexpr (std::is_same_v<Out, VectorOutput>) {
+            const std::size_t n = base64EncodedSize(b.size());
+            base64EncodeTo(b, reinterpret_cast<char*>(out_.room(n)));
+            out_.commit(n);
+        } else {
+            char buf[4096];
+            for (std::size_t i = 0; i < b.size(); i += 3072) {
+                const auto part = b.subspan(i, std::min<std::size_t>(3072, b.size() - i));
+                base64EncodeTo(part, buf);
+                put_bytes(buf, base64EncodedSize(part.size()));
+            }
+        }
+    }
+};
+
+template<class Out = VectorOutput>
+class BasicDirectSerializer {
+    BasicDirectRootSerializer<Out>* r_;
+public:
+    explicit BasicDirectSerializer(BasicDirectRootSerializer<Out>& rs) : r_(&rs) {}
+
+    // primitives
+    void null()                  { r_->value(); r_->put_bytes("null", 4); }
+    void boolean(bool v)         { r_->value(); v ? r_->put_bytes("true", 4) : r_->put_bytes("false", 5); }
+    void int64(std::int64_t v)   { r_->value(); r_->put_int(v); }
+    void uint64(std::uint64_t v) { r_->value(); r_->put_int(v); }
+    void double_(double v)       { r_->value(); r_->put_double(v); }
+    void string(std::string_view sv) { r_->value(); r_->put_string(sv); }
+
+    // Same layout as Serializer::binary: ["~b", <base64 text>, "base64"].
+    void binary(std::span<const std::byte> b) {
+        static constexpr std::string_view head = R"(["~b",")";
+        static constexpr std::string_view tail = R"(","base64"])";
+        r_->value();
+        r_->put_bytes(head.data(), head.size());
+        r_->put_base64(b);
+        r_->put_bytes(tail.data(), tail.size());
+    }
+
+    // structures
+    void begin_array(std::size_t /*n*/) { r_->value(); r_->open('['); }
+    void end_array()                    { r_->close('['); }
+    void begin_map(std::size_t /*n*/)   { r_->value(); r_->open('{'); }
+    void end_map()                      { r_->close('{'); }
+
+    void key(std::string_view k) {
+        r_->key_start();
+        r_->put_string(k);
+        r_->put_byte(':');
+    }
+
+    // Pre-encoded compile-time key, `"K":` in one write; see RawKeyWriter.
+    template<fixed_string K>
+    void key_raw() {
+        constexpr auto& enc = text::encoded_key<K>;
+        r_->key_start();
+        r_->put_bytes(enc.data(), enc.size());
+    }
+};
+
+using DirectRootSerializer = BasicDirectRootSerializer<>;
+using DirectSerializer     = BasicDirectSerializer<>;
+
 } // namespace json
 
 struct JSON {
@@ -395,4 +1314,13 @@ struct JSON {
     using Serializer     = json::Serializer;
 };
 
+// JSON written straight to text by the direct writer, read by the same
+// yyjson reader. The output is byte-for-byte JSON's.
+struct JSONDirect : JSON {
+    using RootSerializer     = json::DirectRootSerializer;
+    using Serializer         = json::DirectSerializer;
+    using SpanRootSerializer = json::BasicDirectRootSerializer<SpanOutput>;
+    using SpanSerializer     = json::BasicDirectSerializer<SpanOutput>;
+};
+
 } // namespace zerialize
@@ -0,0 +1,882 @@
+// JSON read on demand from a structural index, without building a document.
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <zerialize/protocols/json.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+namespace zerialize {
+namespace json {
+
+/*
+ * On-demand JSON
+ * --------------
+ * JsonDeserializer parses the whole input into a yyjson document: every
+ * number is converted and every string copied, even if the caller reads
+ * three fields. LazyDeserializer reads the same JSON in two steps:
+ *
+ *   1. Indexing. One pass over the text, 64 bytes at a time (AVX2 when
+ *      the CPU has it, else SSE2), finds the structural characters
+ *      ({ } [ ] : ,) and the first byte of each string and scalar,
+ *      ignoring what is inside strings.
+ *   2. Navigation. operator[], contains() and the cursors walk the index,
+ *      checking the grammar as they go. The first time a container is
+ *      skipped or sized, its brackets and those inside it are linked, so
+ *      after that it is skipped in one step. Numbers, literals and strings
+ *      are checked and converted only when they are read.
+ *
+ * Strings without escapes are views into the input. Strings with escapes are
+ * decoded once, the first time they are read, into storage owned by the
+ * root deserializer; keys are compared without decoding. The input text must
+ * outlive the root deserializer, as for the binary readers.
+ *
+ * The reader accepts what JsonDeserializer accepts and reports the same
+ * types. Errors in parts that are never read, such as a malformed number,
+ * invalid UTF-8 or a missing comma, are not reported. Reading links
+ * brackets and decodes escaped strings into the root's storage, so one
+ * document is not read from several threads at once.
+ */
+
+namespace structural {
+
+// 64-bit masks over one 64-byte block.
+struct Block {
+    std::uint64_t quote = 0;
+    std::uint64_t backslash = 0;
+    std::uint64_t op = 0;        // { } [ ] : ,
+    std::uint64_t space = 0;     // JSON whitespace
+};
+
+inline Block classify(const unsigned char* p) {
+    Block b;
+#if defined(__SSE2__) || defined(_M_X64)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    // '[' and ']' are '{' and '}' without bit 0x20.
+    const __m128i lower = _mm_set1_epi8(0x20);
+    const __m128i open = _mm_set1_epi8('{'), close = _mm_set1_epi8('}');
+    const __m128i colon = _mm_set1_epi8(':'), comma = _mm_set1_epi8(',');
+    const __m128i sp = _mm_set1_epi8(' '), tab = _mm_set1_epi8('\t');
+    const __m128i lf = _mm_set1_epi8('\n'), cr = _mm_set1_epi8('\r');
+    for (int i = 0; i < 4; ++i) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * i));
+        const __m128i l = _mm_or_si128(v, lower);
+        const __m128i op = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(l, open), _mm_cmpeq_epi8(l, close)),
+                                        _mm_or_si128(_mm_cmpeq_epi8(v, colon), _mm_cmpeq_epi8(v, comma)));
+        const __m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, sp), _mm_cmpeq_epi8(v, tab)),
+                                        _mm_or_si128(_mm_cmpeq_epi8(v, lf), _mm_cmpeq_epi8(v, cr)));
+        const int shift = 16 * i;
+        b.quote |= std::uint64_t(std::uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v, quote)))) << shift;
+        b.backslash |= std::uint64_t(std::uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v, backslash)))) << shift;
+        b.op |= std::uint64_t(std::uint16_t(_mm_movemask_epi8(op))) << shift;
+        b.space |= std::uint64_t(std::uint16_t(_mm_movemask_epi8(ws))) << shift;
+    }
+#else
+    for (int i = 0; i < 64; ++i) {
+        const std::uint64_t bit = std::uint64_t(1) << i;
+        switch (p[i]) {
+            case '"':  b.quote |= bit; break;
+            case '\\': b.backslash |= bit; break;
+            case '{': case '}': case '[': case ']': case ':': case ',': b.op |= bit; break;
+            case ' ': case '\t': case '\n': case '\r': b.space |= bit; break;
+            default: break;
+        }
+    }
+#endif
+    return b;
+}
+
+#if defined(ZERIALIZE_BASE64_X86)
+__attribute__((target("avx2")))
+inline Block classify_avx2(const unsigned char* p) {
+    Block b;
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i lower = _mm256_set1_epi8(0x20);
+    const __m256i open = _mm256_set1_epi8('{'), close = _mm256_set1_epi8('}');
+    const __m256i colon = _mm256_set1_epi8(':'), comma = _mm256_set1_epi8(',');
+    const __m256i sp = _mm256_set1_epi8(' '), tab = _mm256_set1_epi8('\t');
+    const __m256i lf = _mm256_set1_epi8('\n'), cr = _mm256_set1_epi8('\r');
+    for (int i = 0; i < 2; ++i) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32 * i));
+        const __m256i l = _mm256_or_si256(v, lower);
+        const __m256i op = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(l, open), _mm256_cmpeq_epi8(l, close)),
+                                           _mm256_or_si256(_mm256_cmpeq_epi8(v, colon), _mm256_cmpeq_epi8(v, comma)));
+        const __m256i ws = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, sp), _mm256_cmpeq_epi8(v, tab)),
+                                           _mm256_or_si256(_mm256_cmpeq_epi8(v, lf), _mm256_cmpeq_epi8(v, cr)));
+        const int shift = 32 * i;
+        b.quote |= std::uint64_t(std::uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, quote)))) << shift;
+        b.backslash |= std::uint64_t(std::uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, backslash)))) << shift;
+        b.op |= std::uint64_t(std::uint32_t(_mm256_movemask_epi8(op))) << shift;
+        b.space |= std::uint64_t(std::uint32_t(_mm256_movemask_epi8(ws))) << shift;
+    }
+    return b;
+}
+#endif
+
+// Bit i of the result is the XOR of bits 0..i of x.
+constexpr std::uint64_t prefix_xor(std::uint64_t x) {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+// Characters escaped by a backslash, given the backslashes in a block.
+// Runs of backslashes pair up: in \\\" the quote is escaped, in \\" it is
+// not. `carry` is whether the first byte of the block is escaped.
+inline std::uint64_t escaped_bits(std::uint64_t backslash, std::uint64_t& carry) {
+    constexpr std::uint64_t odd = 0xAAAAAAAAAAAAAAAAull;
+    if (!backslash) {
+        const std::uint64_t escaped = carry;
+        carry = 0;
+        return escaped;
+    }
+    const std::uint64_t starts = backslash & ~carry;
+    // Subtracting each run from the bit after it marks the escaping
+    // backslashes (and the byte they escape) with the run's parity.
+    const std::uint64_t code = (((starts << 1) | odd) - starts) ^ odd;
+    const std::uint64_t escaped = code ^ (backslash | carry);
+    carry = (code & backslash) >> 63;
+    return escaped;
+}
+
+// The index of one document. Tokens are the structural characters and the
+// first bytes of strings and scalars. Brackets are linked when a container
+// is first skipped or sized: link[open] is the token of its partner, and
+// link[close] the number of elements (or members). 0 is not linked yet.
+struct Index {
+    std::string_view text;
+    std::unique_ptr<std::uint32_t[]> pos;
+    std::unique_ptr<std::uint32_t[]> link;       // filled in by scan(), from const readers too
+    std::uint32_t count = 0;
+    mutable std::unordered_map<std::uint32_t, std::string> decoded; // by token; handed out as views
+
+    char at(std::uint32_t t) const { return text[pos[t]]; }
+
+    // The closing token of the container opening at token t.
+    std::uint32_t close(std::uint32_t t) const {
+        if (!link[t]) scan(t);
+        return link[t];
+    }
+
+    // The number of elements (or members) of the container opening at t.
+    std::uint32_t size(std::uint32_t t) const { return link[close(t)]; }
+
+    // The token after the value starting at token t.
+    std::uint32_t skip(std::uint32_t t) const {
+        const char c = at(t);
+        return (c == '{' || c == '[') ? close(t) + 1 : t + 1;
+    }
+
+    // The text of the string or scalar at token t: up to the next token or
+    // the end, less trailing whitespace.
+    std::string_view token_text(std::uint32_t t) const {
+        std::size_t end = t + 1 < count ? pos[t + 1] : text.size();
+        while (end > pos[t] && (text[end - 1] == ' ' || text[end - 1] == '\t' ||
+                                text[end - 1] == '\n' || text[end - 1] == '\r')) --end;
+        return text.substr(pos[t], end - pos[t]);
+    }
+
+    // ---- walking a container, checking the grammar on the way ----
+
+    // t, if a value starts there.
+    std::uint32_t value(std::uint32_t t) const {
+        if (t >= count || is_punctuation(at(t))) malformed(t);
+        return t;
+    }
+
+    // t, if a member (key, colon, value) starts there.
+    std::uint32_t member(std::uint32_t t) const {
+        if (t + 2 >= count || at(t) != '"' || at(t + 1) != ':') malformed(t);
+        value(t + 2);
+        return t;
+    }
+
+    // The first element (or key) token of the container at t, 0 if empty.
+    std::uint32_t first(std::uint32_t t) const {
+        const bool object = at(t) == '{';
+        if (at(t + 1) == (object ? '}' : ']')) return 0;
+        return object ? member(t + 1) : value(t + 1);
+    }
+
+    // The element (or key) token after the value at t, 0 at the end of the
+    // container, which is an object if `object`.
+    std::uint32_t next(std::uint32_t t, bool object) const {
+        t = skip(t);
+        if (t < count) {
+            if (at(t) == ',') return object ? member(t + 1) : value(t + 1);
+            if (at(t) == (object ? '}' : ']')) return 0;
+        }
+        malformed(t);
+    }
+
+private:
+    static bool is_punctuation(char c) {
+        return c == ',' || c == ':' || c == '}' || c == ']';
+    }
+
+    [[noreturn]] void malformed(std::uint32_t t) const {
+        if (t >= count) throw DeserializationError("json: unexpected end of input");
+        throw DeserializationError("json: unexpected '" + std::string(1, at(t)) +
+                                   "' at offset " + std::to_string(pos[t]));
+    }
+
+    // Link the container at t, and those inside it, in one pass over its
+    // tokens. Containers linked before are jumped over.
+    void scan(std::uint32_t t) const {
+        open_.clear();
+        const char* s = text.data();
+        const std::uint32_t* p = pos.get();
+        std::uint32_t* ln = link.get();
+        for (std::uint32_t u = t; u < count; ++u) {
+            const char c = s[p[u]];
+            const std::uint8_t k = scan_class[static_cast<unsigned char>(c)];
+            if (k == 0) continue;
+            if (k == 1) {
+                if (!open_.empty()) ++open_.back().commas;
+            } else if (k == 2) {
+                if (ln[u]) { u = ln[u]; continue; }
+                open_.push_back({u, 0});
+            } else {
+                if (open_.empty() || s[p[open_.back().tok]] != (c == '}' ? '{' : '[')) break;
+                const Open o = open_.back();
+                open_.pop_back();
+                ln[o.tok] = u;
+                ln[u] = u == o.tok + 1 ? 0 : o.commas + 1;
+                if (open_.empty()) {
+                    // The root container must end the document.
+                    if (t == 0 && u != count - 1) malformed(u + 1);
+                    return;
+                }
+            }
+        }
+        throw DeserializationError("json: unbalanced brackets at offset " + std::to_string(pos[t]));
+    }
+
+    // 1 a comma, 2 an opening bracket, 3 a closing one, 0 anything else.
+    static constexpr std::array<std::uint8_t, 256> scan_class = [] {
+        std::array<std::uint8_t, 256> k{};
+        k[','] = 1;
+        k['{'] = k['['] = 2;
+        k['}'] = k[']'] = 3;
+        return k;
+    }();
+
+    struct Open { std::uint32_t tok, commas; };
+    mutable std::vector<Open> open_;            // scan()'s stack, kept for its capacity
+};
+
+// Positions of all tokens, 64 bytes of text at a time. Always inlined, so
+// that in find_tokens_avx2() Classify is compiled and inlined for AVX2.
+template<Block (*Classify)(const unsigned char*)>
+#if defined(ZERIALIZE_BASE64_X86)
+__attribute__((always_inline))
+#endif
+inline void find_tokens_with(Index& ix) {
+    const auto* text = reinterpret_cast<const unsigned char*>(ix.text.data());
+    const std::size_t n = ix.text.size();
+    // Typical JSON has a token every four bytes or so; grown if needed. The
+    // slack lets each block store positions eight at a time.
+    std::size_t cap = n / 3 + 256;
+    ix.pos.reset(new std::uint32_t[cap]);
+    std::size_t count = 0;
+
+    std::uint64_t escape_carry = 0, in_string_carry = 0, scalar_carry = 0;
+    unsigned char tail[64];
+    for (std::size_t base = 0; base < n; base += 64) {
+        const unsigned char* p = text + base;
+        if (n - base < 64) {
+            std::memset(tail, ' ', sizeof(tail));
+            std::memcpy(tail, p, n - base);
+            p = tail;
+        }
+        const Block b = Classify(p);
+
+        const std::uint64_t quote = b.quote & ~escaped_bits(b.backslash, escape_carry);
+        // In a string: from its opening quote up to, not including, the closing one.
+        const std::uint64_t in_string = prefix_xor(quote) ^ in_string_carry;
+        in_string_carry = static_cast<std::uint64_t>(static_cast<std::int64_t>(in_string) >> 63);
+
+        // A scalar starts at a byte that is neither structural nor space and
+        // does not follow another such byte. Quotes start strings.
+        const std::uint64_t scalar = ~(b.op | b.space);
+        const std::uint64_t nonquote_scalar = scalar & ~quote;
+        const std::uint64_t follows_scalar = (nonquote_scalar << 1) | scalar_carry;
+        scalar_carry = nonquote_scalar >> 63;
+        const std::uint64_t string_tail = in_string ^ quote;
+        std::uint64_t bits = (b.op | (scalar & ~follows_scalar)) & ~string_tail;
+
+        if (cap - count < 64 + 8) {
+            cap *= 2;
+            std::unique_ptr<std::uint32_t[]> grown(new std::uint32_t[cap]);
+            std::memcpy(grown.get(), ix.pos.get(), count * sizeof(std::uint32_t));
+            ix.pos = std::move(grown);
+        }
+        std::uint32_t* out = ix.pos.get() + count;
+        const auto at = static_cast<std::uint32_t>(base);
+        const int found = std::popcount(bits);
+        // Eight at a time, most blocks in one or two rounds; the extra
+        // positions written are garbage past `count`, overwritten later.
+        for (int i = 0; i < found; i += 8) {
+            for (int k = 0; k < 8; ++k) {
+                out[i + k] = at + static_cast<std::uint32_t>(std::countr_zero(bits));
+                bits &= bits - 1;
+            }
+        }
+        count += static_cast<std::size_t>(found);
+    }
+    if (in_string_carry) throw DeserializationError("json: unterminated string");
+    ix.count = static_cast<std::uint32_t>(count);
+}
+
+#if defined(ZERIALIZE_BASE64_X86)
+__attribute__((target("avx2")))
+inline void find_tokens_avx2(Index& ix) { find_tokens_with<classify_avx2>(ix); }
+#endif
+
+// AVX2 when the CPU has it (the check base64 makes), SSE2 otherwise.
+inline void find_tokens(Index& ix) {
+#if defined(ZERIALIZE_BASE64_X86)
+    if (base64_detail::best_isa() == base64_detail::Isa::AVX2) return find_tokens_avx2(ix);
+#endif
+    find_tokens_with<classify>(ix);
+}
+
+inline std::unique_ptr<Index> build(std::string_view text) {
+    if (text.size() >= std::numeric_limits<std::uint32_t>::max()) {
+        throw DeserializationError("json: document of " + std::to_string(text.size()) +
+                                   " bytes is too large to index");
+    }
+    auto ix = std::make_unique<Index>();
+    ix->text = text;
+    find_tokens(*ix);
+    if (ix->count == 0) throw DeserializationError("json: empty document");
+    ix->link.reset(new std::uint32_t[ix->count]());
+    // One root value: a single token, or a container ending at the last
+    // one. A container's end is checked when it is first scanned.
+    const char first = ix->at(ix->value(0));
+    const char last = ix->at(ix->count - 1);
+    if ((first == '{' || first == '[') ? last != (first == '{' ? '}' : ']') : ix->count != 1) {
+        throw DeserializationError("json: expected one root value");
+    }
+    return ix;
+}
+
+// ---- values, converted when read ----
+
+struct Number {
+    enum Kind { Invalid, Sint, Uint, Real } kind = Invalid;
+    std::uint64_t u = 0;                  // Sint: the two's complement bits
+    double d = 0;
+};
+
+// A JSON number, typed as yyjson types it: negative integers are signed,
+// other integers unsigned, and integers too large for 64 bits are reals.
+inline Number parse_number(std::string_view s) {
+    const char* p = s.data();
+    const char* end = p + s.size();
+    auto digit = [&](const char* q) { return q < end && *q >= '0' && *q <= '9'; };
+    const bool neg = p < end && *p == '-';
+    const char* q = p + neg;
+    if (!digit(q)) return {};
+    if (*q == '0') ++q;
+    else while (digit(q)) ++q;
+    const char* int_end = q;
+    bool real = false;
+    if (q < end && *q == '.') {
+        if (!digit(++q)) return {};
+        while (digit(q)) ++q;
+        real = true;
+    }
+    if (q < end && (*q == 'e' || *q == 'E')) {
+        ++q;
+        if (q < end && (*q == '+' || *q == '-')) ++q;
+        if (!digit(q)) return {};
+        while (digit(q)) ++q;
+        real = true;
+    }
+    if (q != end) return {};
+
+    if (!real) {
+        std::uint64_t v = 0;
+        bool fits = true;
+        for (const char* r = p + neg; r < int_end && fits; ++r) {
+            const auto d = static_cast<std::uint64_t>(*r - '0');
+            if (v > (std::numeric_limits<std::uint64_t>::max() - d) / 10) fits = false;
+            else v = v * 10 + d;
+        }
+        if (fits && !neg) return {Number::Uint, v, 0};
+        if (fits && v <= (std::uint64_t(1) << 63)) return {Number::Sint, ~v + 1, 0};
+    }
+
+    Number r{Number::Real, 0, 0};
+    const auto [ptr, ec] = std::from_chars(p, end, r.d);
+    if (ec == std::errc::result_out_of_range) {
+        // Too small rounds to zero, as in yyjson; too large is an error.
+        long exp10 = 0;
+        const char* e = std::find_if(p, end, [](char ch) { return ch == 'e' || ch == 'E'; });
+        if (e != end) {
+            long x = 0;
+            const bool eneg = e[1] == '-';
+            for (const char* r2 = e + 1 + (e[1] == '-' || e[1] == '+'); r2 < end && x < 100000; ++r2) x = x * 10 + (*r2 - '0');
+            exp10 = eneg ? -x : x;
+        }
+        const char* first = p + neg;
+        while (first < e && (*first == '0' || *first == '.')) ++first;   // first significant digit
+        const char* dot = std::find(p, e, '.');
+        exp10 += first < dot ? dot - first - 1 : dot - first;
+        if (exp10 >= 0) return {};
+        r.d = neg ? -0.0 : 0.0;
+    } else if (ec != std::errc() || ptr != end) {
+        return {};
+    }
+    return r;
+}
+
+inline int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+template<class Out>
+void append_utf8(Out& out, std::uint32_t cp) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+// Compares decoded text with `key` as unescape() produces it, storing
+// nothing; unescape() stops at the first difference.
+struct KeyMatch {
+    std::string_view key;
+    std::size_t at = 0;
+    bool differs = false;
+
+    void append(const char* p, std::size_t n) {
+        if (differs || key.size() - at < n || std::memcmp(key.data() + at, p, n) != 0) {
+            differs = true;
+            return;
+        }
+        at += n;
+    }
+    KeyMatch& operator+=(char c) {
+        append(&c, 1);
+        return *this;
+    }
+    bool matches() const { return !differs && at == key.size(); }
+};
+
+// Escapes of raw[i, n) decoded onto `out` (a std::string or a KeyMatch);
+// raw[0, i) is already there.
+template<class Out>
+void unescape(std::string_view raw, std::size_t i, Out& out) {
+    const char* p = raw.data();
+    const std::size_t n = raw.size();
+    auto hex4 = [&](std::size_t at) {
+        if (n - at < 4) throw DeserializationError("json: truncated \\u escape");
+        std::uint32_t v = 0;
+        for (std::size_t k = 0; k < 4; ++k) {
+            const int h = hex_value(p[at + k]);
+            if (h < 0) throw DeserializationError("json: invalid \\u escape");
+            v = v << 4 | static_cast<std::uint32_t>(h);
+        }
+        return v;
+    };
+    while (i < n) {
+        if constexpr (std::is_same_v<Out, KeyMatch>) {
+            if (out.differs) return;
+        }
+        const std::size_t run = i + text::plain_prefix(p + i, n - i);
+        out.append(p + i, run - i);
+        i = run;
+        if (i == n) break;
+        const auto c = static_cast<unsigned char>(p[i]);
+        if (c >= 0x80) {
+            const std::size_t len = text::utf8_length(reinterpret_cast<const unsigned char*>(p + i), n - i);
+            if (len == 0) throw DeserializationError("json: invalid UTF-8 in string");
+            out.append(p + i, len);
+            i += len;
+            continue;
+        }
+        if (c != '\\') throw DeserializationError("json: control character in string");
+        if (++i == n) throw DeserializationError("json: truncated escape");
+        switch (p[i++]) {
+            case '"':  out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/':  out += '/'; break;
+            case 'b':  out += '\b'; break;
+            case 'f':  out += '\f'; break;
+            case 'n':  out += '\n'; break;
+            case 'r':  out += '\r'; break;
+            case 't':  out += '\t'; break;
+            case 'u': {
+                std::uint32_t cp = hex4(i);
+                i += 4;
+                if (cp >= 0xD800 && cp <= 0xDBFF) {
+                    if (n - i < 6 || p[i] != '\\' || p[i + 1] != 'u') {
+                        throw DeserializationError("json: unpaired surrogate in \\u escape");
+                    }
+                    const std::uint32_t lo = hex4(i + 2);
+                    if (lo < 0xDC00 || lo > 0xDFFF) throw DeserializationError("json: unpaired surrogate in \\u escape");
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                    i += 6;
+                } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                    throw DeserializationError("json: unpaired surrogate in \\u escape");
+                }
+                append_utf8(out, cp);
+                break;
+            }
+            default:
+                throw DeserializationError("json: invalid escape in string");
+        }
+    }
+}
+
+} // namespace structural
+
+class LazyDeserializer {
+    std::unique_ptr<structural::Index> owned_;   // set on the root only
+    const structural::Index* ix_ = nullptr;
+    std::uint32_t tok_ = 0;
+
+    static void ensure(bool cond, const char* msg) {
+        if (!cond) throw DeserializationError(msg);
+    }
+
+    void check(bool ok, const char* what) const {
+        if (!ok) throw DeserializationError(std::string("Value is not a ") + what);
+    }
+
+    char kind() const { return ix_->at(tok_); }
+
+    structural::Number number() const {
+        const char c = kind();
+        if (c != '-' && (c < '0' || c > '9')) return {};
+        return structural::parse_number(ix_->token_text(tok_));
+    }
+
+    // The bytes between the quotes of the string at token t.
+    static std::string_view raw_string(const structural::Index* ix, std::uint32_t t) {
+        const std::string_view s = ix->token_text(t);
+        ensure(s.size() >= 2 && s.back() == '"', "json: malformed string");
+        return s.substr(1, s.size() - 2);
+    }
+
+    // The string at token t, checked, with its escapes decoded.
+    static std::string_view string_at(const structural::Index* ix, std::uint32_t t) {
+        const std::string_view raw = raw_string(ix, t);
+        const char* p = raw.data();
+        const std::size_t n = raw.size();
+        for (std::size_t i = 0; i < n;) {
+            i += text::plain_prefix(p + i, n - i);
+            if (i == n) break;
+            const auto c = static_cast<unsigned char>(p[i]);
+            if (c == '\\') {
+                // Decoded once per token; later reads return the same view.
+                if (auto it = ix->decoded.find(t); it != ix->decoded.end()) return it->second;
+                std::string out(p, i);
+                structural::unescape(raw, i, out);
+                return ix->decoded.emplace(t, std::move(out)).first->second;
+            }
+            if (c < 0x80) throw DeserializationError("json: control character in string");
+            const std::size_t len = text::utf8_length(reinterpret_cast<const unsigned char*>(p + i), n - i);
+            if (len == 0) throw DeserializationError("json: invalid UTF-8 in string");
+            i += len;
+        }
+        return raw;
+    }
+
+    bool key_is(std::uint32_t t, std::string_view key) const {
+        const std::string_view raw = raw_string(ix_, t);
+        if (raw.size() == key.size()) {
+            return std::memcmp(raw.data(), key.data(), key.size()) == 0 &&
+                   std::memchr(raw.data(), '\\', raw.size()) == nullptr;
+        }
+        // Escapes only make a key shorter than its text. Compare the plain
+        // prefix, then decode the rest against the key without storing it.
+        const void* esc = raw.size() < key.size() ? nullptr : std::memchr(raw.data(), '\\', raw.size());
+        if (!esc) return false;
+        const std::size_t i = static_cast<std::size_t>(static_cast<const char*>(esc) - raw.data());
+        if (i > key.size() || std::memcmp(raw.data(), key.data(), i) != 0) return false;
+        structural::KeyMatch m{key, i};
+        structural::unescape(raw, i, m);
+        return m.matches();
+    }
+
+    // The value token of the first member with this key, or 0.
+    std::uint32_t find(std::string_view key) const {
+        for (std::uint32_t t = ix_->first(tok_); t; t = ix_->next(t + 2, true)) {
+            if (key_is(t, key)) return t + 2;
+        }
+        return 0;
+    }
+
+public:
+    // --- ctors: root (owning the index, viewing the text) ---
+    explicit LazyDeserializer(std::string_view json)
+        : owned_(structural::build(json)), ix_(owned_.get()) {
+        static_assert(Reader<LazyDeserializer>, "Derived must satisfy Reader concept");
+    }
+    explicit LazyDeserializer(const uint8_t* data, std::size_t n)
+        : LazyDeserializer(std::string_view(reinterpret_cast<const char*>(data), n)) {}
+
+    explicit LazyDeserializer(std::span<const uint8_t> bytes)
+        : LazyDeserializer(std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size())) {}
+
+    // default: empty object {}
+    LazyDeserializer() : LazyDeserializer(std::string_view("{}", 2)) {}
+
+    // --- view ctor (non-owning) ---
+    LazyDeserializer(const structural::Index* ix, std::uint32_t tok) : ix_(ix), tok_(tok) {}
+
+    LazyDeserializer(const LazyDeserializer&) = delete;
+    LazyDeserializer& operator=(const LazyDeserializer&) = delete;
+    LazyDeserializer(LazyDeserializer&&) noexcept = default;
+    LazyDeserializer& operator=(LazyDeserializer&&) noexcept = default;
+
+    // --- predicates (strict bool) ---
+    bool isNull()   const { return ix_->token_text(tok_) == "null"; }
+    bool isBool()   const { const auto s = ix_->token_text(tok_); return s == "true" || s == "false"; }
+    bool isInt()    const { const auto k = number().kind; return k == structural::Number::Sint || k == structural::Number::Uint; }
+    bool isUInt()   const { return number().kind == structural::Number::Uint; }
+    bool isFloat()  const { return number().kind == structural::Number::Real; }
+    bool isString() const { return kind() == '"'; }
+    bool isMap()    const { return kind() == '{'; }
+    bool isArray()  const { return kind() == '['; }
+    // Blob policy: base64 string
+    bool isBlob()   const {
+        return isArray() && arraySize() == 3 &&
+            (*this)[0].isString() && (*this)[0].asStringView() == blobTag &&
+            (*this)[1].isString() &&
+            (*this)[2].isString() && (*this)[2].asStringView() == blobEncoding;
+    }
+
+    // --- scalars ---
+    int8_t   asInt8()   const { return static_cast<int8_t>(asInt64()); }
+    int16_t  asInt16()  const { return static_cast<int16_t>(asInt64()); }
+    int32_t  asInt32()  const { return static_cast<int32_t>(asInt64()); }
+    int64_t  asInt64()  const {
+        const auto n = number();
+        check(n.kind == structural::Number::Sint || n.kind == structural::Number::Uint, "signed integer");
+        return static_cast<int64_t>(n.u);
+    }
+
+    uint8_t  asUInt8()  const { return static_cast<uint8_t>(asUInt64()); }
+    uint16_t asUInt16() const { return static_cast<uint16_t>(asUInt64()); }
+    uint32_t asUInt32() const { return static_cast<uint32_t>(asUInt64()); }
+    uint64_t asUInt64() const {
+        const auto n = number();
+        check(n.kind == structural::Number::Uint, "unsigned integer");
+        return n.u;
+    }
+
+    float    asFloat()  const { return static_cast<float>(asDouble()); }
+    double   asDouble() const {
+        const auto n = number();
+        check(n.kind == structural::Number::Real, "float");
+        return n.d;
+    }
+
+    bool     asBool()   const {
+        const auto s = ix_->token_text(tok_);
+        check(s == "true" || s == "false", "boolean");
+        return s == "true";
+    }
+
+    std::string asString() const { return std::string(asStringView()); }
+    std::string_view asStringView() const {
+        check(isString(), "string");
+        return string_at(ix_, tok_);
+    }
+
+    std::vector<std::byte> asBlob() const {
+        ensure(isBlob(), "not a blob");
+        return base64Decode((*this)[1].asStringView());
+    }
+
+    // Decode a blob into caller memory instead (see BlobDecodeReader).
+    std::size_t blobSize() const {
+        ensure(isBlob(), "not a blob");
+        return base64DecodedSize((*this)[1].asStringView());
+    }
+    std::size_t readBlobInto(std::span<std::byte> dst) const {
+        ensure(isBlob(), "not a blob");
+        return base64DecodeTo((*this)[1].asStringView(), dst);
+    }
+
+    // --- map interface ---
+    bool contains(std::string_view key) const {
+        return isMap() && find(key) != 0;
+    }
+
+    struct KeysView {
+        const structural::Index* ix;
+        std::uint32_t first;               // first key token, 0 if none
+
+        struct iterator {
+            const structural::Index* ix = nullptr;
+            std::uint32_t key = 0;         // 0 == end
+
+            using iterator_concept  = std::forward_iterator_tag;
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = std::string_view;
+            using difference_type   = std::ptrdiff_t;
+            using reference         = std::string_view;
+
+            reference operator*() const { return string_at(ix, key); }
+            iterator& operator++() { key = ix->next(key + 2, true); return *this; }
+            iterator operator++(int) { iterator tmp = *this; ++(*this); return tmp; }
+            friend bool operator==(const iterator& a, const iterator& b) { return a.key == b.key; }
+        };
+
+        iterator begin() const { return iterator{ix, first}; }
+        iterator end() const { return iterator{ix, 0}; }
+    };
+
+    KeysView mapKeys() const {
+        check(isMap(), "map/object");
+        return KeysView{ix_, ix_->first(tok_)};
+    }
+
+    LazyDeserializer operator[](std::string_view key) const {
+        check(isMap(), "map/object");
+        const std::uint32_t v = find(key);
+        if (!v) throw DeserializationError("Key not found: " + std::string(key));
+        return LazyDeserializer(ix_, v); // view
+    }
+
+    // --- array interface ---
+    std::size_t arraySize() const {
+        check(isArray(), "array");
+        return ix_->size(tok_);
+    }
+    LazyDeserializer operator[](std::size_t idx) const {
+        check(isArray(), "array");
+        std::uint32_t t = ix_->first(tok_);
+        for (; t && idx; --idx) t = ix_->next(t, false);
+        if (!t) throw DeserializationError("Array index out of range");
+        return LazyDeserializer(ix_, t); // view
+    }
+
+    // --- cursors (see ArrayCursorReader / MapCursorReader) ---
+    struct EntriesView {
+        const structural::Index* ix;
+        std::uint32_t first;               // first key token, 0 if none
+        std::size_t n;
+
+        struct iterator {
+            const structural::Index* ix = nullptr;
+            std::uint32_t key = 0;         // 0 == end
+
+            using iterator_concept  = std::forward_iterator_tag;
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = std::pair<std::string_view, LazyDeserializer>;
+            using difference_type   = std::ptrdiff_t;
+            using reference         = value_type;
+
+            reference operator*() const { return { string_at(ix, key), LazyDeserializer(ix, key + 2) }; }
+            iterator& operator++() { key = ix->next(key + 2, true); return *this; }
+            iterator operator++(int) { iterator tmp = *this; ++(*this); return tmp; }
+            friend bool operator==(const iterator& a, const iterator& b) { return a.key == b.key; }
+        };
+
+        std::size_t size() const { return n; }
+        iterator begin() const { return iterator{ix, first}; }
+        iterator end() const { return iterator{ix, 0}; }
+    };
+
+    EntriesView mapEntries() const {
+        check(isMap(), "map/object");
+        return EntriesView{ix_, ix_->first(tok_), ix_->size(tok_)};
+    }
+
+    struct ElementsView {
+        const structural::Index* ix;
+        std::uint32_t first;               // first element token, 0 if none
+        std::size_t n;
+
+        struct iterator {
+            const structural::Index* ix = nullptr;
+            std::uint32_t val = 0;         // 0 == end
+
+            using iterator_concept  = std::forward_iterator_tag;
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = LazyDeserializer;
+            using difference_type   = std::ptrdiff_t;
+            using reference         = LazyDeserializer;
+
+            reference operator*() const { return LazyDeserializer(ix, val); }
+            iterator& operator++() { val = ix->next(val, false); return *this; }
+            iterator operator++(int) { iterator tmp = *this; ++(*this); return tmp; }
+            friend bool operator==(const iterator& a, const iterator& b) { return a.val == b.val; }
+        };
+
+        std::size_t size() const { return n; }
+        iterator begin() const { return iterator{ix, first}; }
+        iterator end() const { return iterator{ix, 0}; }
+    };
+
+    ElementsView arrayElements() const {
+        check(isArray(), "array");
+        return ElementsView{ix_, ix_->first(tok_), ix_->size(tok_)};
+    }
+
+    // --- debug helper: the value's text as it is in the input ---
+    std::string to_string(bool /*pretty*/ = true) const {
+        if (!isMap() && !isArray()) return std::string(ix_->token_text(tok_));
+        const std::uint32_t from = ix_->pos[tok_];
+        return std::string(ix_->text.substr(from, ix_->pos[ix_->close(tok_)] + 1 - from));
+    }
+};
+
+// ADL helpers make std::ranges::begin/end unambiguous on all lib implementations.
+inline LazyDeserializer::KeysView::iterator begin(const LazyDeserializer::KeysView& kv) noexcept { return kv.begin(); }
+inline LazyDeserializer::KeysView::iterator end  (const LazyDeserializer::KeysView& kv) noexcept { return kv.end();   }
+
+} // namespace json
+
+// JSON written by the yyjson writer and read on demand from a structural
+// index; see LazyDeserializer.
+struct JSONLazy : JSON {
+    using Deserializer = json::LazyDeserializer;
+};
+
+} // namespace zerialize
@@ -1,4 +1,6 @@
 #pragma once
+#include <array>
+#include <concepts>
 #include <cstdint>
 #include <cstddef>
 #include <cstring>
@@ -10,11 +12,16 @@
 #include <stdexcept>
 #include <sstream>
 #include <iterator>
+#include <limits>
+#include <memory>
+#include <utility>
 #include <type_traits>
 
-#include <msgpack.h> // for the writer
 #include <zerialize/zbuffer.hpp>
+#include <zerialize/buffer_pool.hpp>
+#include <zerialize/output.hpp>
 #include <zerialize/errors.hpp>
+#include <zerialize/internals/fixed_string.hpp>
 
 
 namespace zerialize {
@@ -31,9 +38,21 @@ inline uint64_t mp_read_be64(const uint8_t* p) {
            (uint64_t(p[4]) << 24) | (uint64_t(p[5]) << 16) | (uint64_t(p[6]) << 8) | uint64_t(p[7]);
 }
 
+inline void mp_write_be64(uint8_t* p, uint64_t v) {
+    for (int i = 0; i < 8; ++i) p[i] = uint8_t(v >> (56 - 8 * i));
+}
+
 // Forward decl
 inline size_t mp_skip(std::span<const uint8_t>);
 
+// Size of the element starting at `off`, checked against the end of `v`.
+inline size_t mp_child_size(std::span<const uint8_t> v, size_t off) {
+    if (off >= v.size()) throw DeserializationError("msgpack: truncated container");
+    const size_t sz = mp_skip(v.subspan(off));
+    if (sz > v.size() - off) throw DeserializationError("msgpack: truncated element");
+    return sz;
+}
+
 // ===== minimal element skipper (for iterators / indexing) ====================
 inline size_t mp_skip(std::span<const uint8_t> v) {
     if (v.empty()) throw DeserializationError("msgpack: empty in skip");
@@ -47,15 +66,15 @@ inline size_t mp_skip(std::span<const uint8_t> v) {
     // fixarray
     if ((m & 0xf0) == 0x90) {
         size_t n = m & 0x0f, off = 1;
-        for (size_t i = 0; i < n; ++i) { auto s = mp_skip(v.subspan(off)); off += s; }
+        for (size_t i = 0; i < n; ++i) off += mp_child_size(v, off);
         return off;
     }
     // fixmap
     if ((m & 0xf0) == 0x80) {
         size_t n = m & 0x0f, off = 1;
         for (size_t i = 0; i < n; ++i) {
-            auto ks = mp_skip(v.subspan(off)); off += ks;
-            auto vs = mp_skip(v.subspan(off)); off += vs;
+            off += mp_child_size(v, off);
+            off += mp_child_size(v, off);
         }
         return off;
     }
@@ -81,24 +100,28 @@ inline size_t mp_skip(std::span<const uint8_t> v) {
         case 0xdc: {
             if (v.size() < 3) throw DeserializationError("array16");
             size_t n = mp_read_be16(v.data()+1), off = 3;
-            for (size_t i=0;i<n;++i){ auto s=mp_skip(v.subspan(off)); off+=s; } return off;
+            for (size_t i=0;i<n;++i) off += mp_child_size(v, off);
+            return off;
         }
         case 0xdd: {
             if (v.size() < 5) throw DeserializationError("array32");
             size_t n = mp_read_be32(v.data()+1), off = 5;
-            for (size_t i=0;i<n;++i){ auto s=mp_skip(v.subspan(off)); off+=s; } return off;
+            for (size_t i=0;i<n;++i) off += mp_child_size(v, off);
+            return off;
         }
 
         // maps
         case 0xde: {
             if (v.size() < 3) throw DeserializationError("map16");
             size_t n = mp_read_be16(v.data()+1), off = 3;
-            for (size_t i=0;i<n;++i){ auto ks=mp_skip(v.subspan(off)); off+=ks; auto vs=mp_skip(v.subspan(off)); off+=vs; } return off;
+            for (size_t i=0;i<n;++i){ off += mp_child_size(v, off); off += mp_child_size(v, off); }
+            return off;
         }
         case 0xdf: {
             if (v.size() < 5) throw DeserializationError("map32");
             size_t n = mp_read_be32(v.data()+1), off = 5;
-            for (size_t i=0;i<n;++i){ auto ks=mp_skip(v.subspan(off)); off+=ks; auto vs=mp_skip(v.subspan(off)); off+=vs; } return off;
+            for (size_t i=0;i<n;++i){ off += mp_child_size(v, off); off += mp_child_size(v, off); }
+            return off;
         }
         default: break;
     }
@@ -111,6 +134,9 @@ class MsgPackDeserializer {
     std::vector<uint8_t> owned_;
     // view over current element
     std::span<const uint8_t> view_{};
+    // Optional offset table built by indexed(). Arrays: start of each element,
+    // then the end. Maps: key and value starts interleaved, then the end.
+    std::shared_ptr<const std::vector<size_t>> index_;
 
     // helpers: decode headers
     static void str_info(std::span<const uint8_t> v, const uint8_t*& p, size_t& len) {
@@ -181,16 +207,13 @@ class MsgPackDeserializer {
         if (v.isBlob()){ auto b=v.asBlob(); os << "bin[size="<<b.size()<<"]"; return; }
         if (v.isMap()){
             os << "map {\n";
-            size_t n=0, off=0; v.map_info(v.view_, n, off);
-            for(size_t i=0;i<n;++i){
-                MsgPackDeserializer k(v.view_.subspan(off, mp_skip(v.view_.subspan(off))));
-                off += mp_skip(v.view_.subspan(off));
-                MsgPackDeserializer val(v.view_.subspan(off, mp_skip(v.view_.subspan(off))));
-                off += mp_skip(v.view_.subspan(off));
+            auto entries = v.mapEntries();
+            size_t i = 0, n = entries.size();
+            for (auto [k, val] : entries) {
                 ind(pad+2);
-                os << '"' << esc(k.asStringView()) << "\": ";
+                os << '"' << esc(k) << "\": ";
                 dump(os, val, pad+2);
-                if (i+1<n) os << ',';
+                if (++i<n) os << ',';
                 os << '\n';
             }
             ind(pad); os << '}';
@@ -198,12 +221,11 @@ class MsgPackDeserializer {
         }
         if (v.isArray()){
             os << "arr [\n";
-            size_t n=0, off=0; v.arr_info(v.view_, n, off);
-            for(size_t i=0;i<n;++i){
-                MsgPackDeserializer e(v.view_.subspan(off, mp_skip(v.view_.subspan(off))));
-                off += mp_skip(v.view_.subspan(off));
+            auto elems = v.arrayElements();
+            size_t i = 0, n = elems.size();
+            for (auto e : elems) {
                 ind(pad+2); dump(os, e, pad+2);
-                if (i+1<n) os << ',';
+                if (++i<n) os << ',';
                 os << '\n';
             }
             ind(pad); os << ']';
@@ -392,41 +414,28 @@ public:
                 : v(vv), i(idx), off(start_off) {}
 
             reference operator*() const {
-                // key at off
-                auto key_span = v.subspan(off);
-                size_t key_sz = mp_skip(key_span);
-                MsgPackDeserializer kd(key_span.first(key_sz), true);
-                // keys must be strings in our concept
+                // key at off; keys must be strings in our concept
+                MsgPackDeserializer kd(v.subspan(off, mp_child_size(v, off)), true);
                 return kd.asStringView();
             }
             iterator& operator++() {
                 // advance past key and value
-                auto key_span = v.subspan(off);
-                size_t key_sz = mp_skip(key_span);
-                size_t val_sz = mp_skip(v.subspan(off + key_sz));
-                off += key_sz + val_sz;
+                off += mp_child_size(v, off);
+                off += mp_child_size(v, off);
                 ++i;
                 return *this;
             }
             iterator operator++(int){ auto tmp=*this; ++(*this); return tmp; }
 
+            // Iterators over one map are ordered by entry index alone, so
+            // end() does not need the byte offset past the last entry.
             friend bool operator==(const iterator& a, const iterator& b) {
-                return a.v.data()==b.v.data() && a.i==b.i && a.off==b.off;
+                return a.v.data()==b.v.data() && a.i==b.i;
             }
         };
 
         iterator begin() const { return iterator{ v, 0, payload_off }; }
-        iterator end()   const {
-            // compute byte offset of end by walking all entries
-            size_t off = payload_off;
-            for (size_t i=0;i<count;++i) {
-                size_t ks = mp_skip(v.subspan(off));
-                off += ks;
-                size_t vs = mp_skip(v.subspan(off));
-                off += vs;
-            }
-            return iterator{ v, count, off };
-        }
+        iterator end()   const { return iterator{ v, count, 0 }; }
     };
 
     KeysView mapKeys() const {
@@ -437,38 +446,73 @@ public:
 
     bool contains(std::string_view key) const {
         if (!isMap()) return false;
-        size_t n=0, off=0; map_info(view_, n, off);
-        for (size_t i=0;i<n;++i) {
-            auto kspan = view_.subspan(off);
-            size_t ksz = mp_skip(kspan);
-            MsgPackDeserializer kd(kspan.first(ksz), true);
-            off += ksz;
-            auto vspan = view_.subspan(off);
-            size_t vsz = mp_skip(vspan);
-            if (kd.isString() && kd.asStringView() == key) {
-                return true;
-            }
-            off += vsz;
-        }
-        return false;
+        return !find_value(key).empty();
     }
 
     MsgPackDeserializer operator[](std::string_view key) const {
         if (!isMap()) throw DeserializationError("not map");
-        size_t n=0, off=0; map_info(view_, n, off);
-        for (size_t i=0;i<n;++i) {
-            auto kspan = view_.subspan(off);
-            size_t ksz = mp_skip(kspan);
-            MsgPackDeserializer kd(kspan.first(ksz), true);
-            off += ksz;
-            auto vspan = view_.subspan(off);
-            size_t vsz = mp_skip(vspan);
-            if (kd.isString() && kd.asStringView() == key) {
-                return MsgPackDeserializer(vspan.first(vsz), true);
+        auto vspan = find_value(key);
+        if (vspan.empty()) throw DeserializationError("key not found: " + std::string(key));
+        return MsgPackDeserializer(vspan, true);
+    }
+
+    // One-pass iteration over (key, value) pairs; see MapCursorReader.
+    struct EntriesView {
+        std::span<const uint8_t> v{};
+        size_t count = 0;
+        size_t payload_off = 0;
+
+        struct iterator {
+            std::span<const uint8_t> v{};
+            size_t i = 0;
+            size_t n = 0;
+            size_t off = 0;    // byte offset of the current key
+            size_t key_sz = 0; // sizes of the current entry, measured once
+            size_t val_sz = 0;
+
+            using iterator_category = std::forward_iterator_tag;
+            using iterator_concept  = std::forward_iterator_tag;
+            using value_type        = std::pair<std::string_view, MsgPackDeserializer>;
+            using difference_type   = std::ptrdiff_t;
+            using reference         = value_type;
+
+            iterator() = default;
+            iterator(std::span<const uint8_t> vv, size_t idx, size_t count, size_t start_off)
+                : v(vv), i(idx), n(count), off(start_off) { measure(); }
+
+            reference operator*() const {
+                MsgPackDeserializer kd(v.subspan(off, key_sz), true);
+                return { kd.asStringView(), MsgPackDeserializer(v.subspan(off + key_sz, val_sz), true) };
             }
-            off += vsz;
-        }
-        throw DeserializationError("key not found: " + std::string(key));
+            iterator& operator++() {
+                off += key_sz + val_sz;
+                ++i;
+                measure();
+                return *this;
+            }
+            iterator operator++(int){ auto tmp=*this; ++(*this); return tmp; }
+
+            friend bool operator==(const iterator& a, const iterator& b) {
+                return a.v.data()==b.v.data() && a.i==b.i;
+            }
+
+        private:
+            void measure() {
+                if (i >= n) return;
+                key_sz = mp_child_size(v, off);
+                val_sz = mp_child_size(v, off + key_sz);
+            }
+        };
+
+        size_t size() const { return count; }
+        iterator begin() const { return iterator{ v, 0, count, payload_off }; }
+        iterator end()   const { return iterator{ v, count, count, 0 }; }
+    };
+
+    EntriesView mapEntries() const {
+        if (!isMap()) throw DeserializationError("not map");
+        size_t n=0, off=0; map_info(view_, n, off);
+        return EntriesView{ view_, n, off };
     }
 
     // ---- array interface ----
@@ -476,12 +520,85 @@ public:
         size_t n=0, off=0; arr_info(view_, n, off); (void)off; return n;
     }
 
+    // O(idx) unless this view came from indexed(). For full traversal use arrayElements().
     MsgPackDeserializer operator[](size_t idx) const {
+        if (index_) {
+            if (!isArray()) throw DeserializationError("msgpack: not an array");
+            const auto& ix = *index_;
+            if (idx + 1 >= ix.size()) throw DeserializationError("index OOB");
+            return MsgPackDeserializer(view_.subspan(ix[idx], ix[idx + 1] - ix[idx]), true);
+        }
         size_t n=0, off=0; arr_info(view_, n, off);
         if (idx >= n) throw DeserializationError("index OOB");
-        for (size_t i=0;i<idx;++i) off += mp_skip(view_.subspan(off));
-        size_t sz = mp_skip(view_.subspan(off));
-        return MsgPackDeserializer(view_.subspan(off, sz), true);
+        for (size_t i=0;i<idx;++i) off += mp_child_size(view_, off);
+        return MsgPackDeserializer(view_.subspan(off, mp_child_size(view_, off)), true);
+    }
+
+    // One-pass iteration over array elements; see ArrayCursorReader.
+    struct ElementsView {
+        std::span<const uint8_t> v{};
+        size_t count = 0;
+        size_t payload_off = 0;
+
+        struct iterator {
+            std::span<const uint8_t> v{};
+            size_t i = 0;
+            size_t n = 0;
+            size_t off = 0; // byte offset of the current element
+            size_t sz = 0;  // its size, measured once
+
+            using iterator_category = std::forward_iterator_tag;
+            using iterator_concept  = std::forward_iterator_tag;
+            using value_type        = MsgPackDeserializer;
+            using difference_type   = std::ptrdiff_t;
+            using reference         = MsgPackDeserializer;
+
+            iterator() = default;
+            iterator(std::span<const uint8_t> vv, size_t idx, size_t count, size_t start_off)
+                : v(vv), i(idx), n(count), off(start_off) { if (i < n) sz = mp_child_size(v, off); }
+
+            reference operator*() const { return MsgPackDeserializer(v.subspan(off, sz), true); }
+            iterator& operator++() {
+                off += sz;
+                if (++i < n) sz = mp_child_size(v, off);
+                return *this;
+            }
+            iterator operator++(int){ auto tmp=*this; ++(*this); return tmp; }
+
+            friend bool operator==(const iterator& a, const iterator& b) {
+                return a.v.data()==b.v.data() && a.i==b.i;
+            }
+        };
+
+        size_t size() const { return count; }
+        iterator begin() const { return iterator{ v, 0, count, payload_off }; }
+        iterator end()   const { return iterator{ v, count, count, 0 }; }
+    };
+
+    ElementsView arrayElements() const {
+        size_t n=0, off=0; arr_info(view_, n, off);
+        return ElementsView{ view_, n, off };
+    }
+
+    // Returns a view of this array or map with an offset table, built in one
+    // pass: operator[](size_t) becomes O(1), and key lookups compare keys
+    // without re-skipping values. Copies of the returned view share the table;
+    // child views are not indexed. Like any subview, it borrows this view's bytes.
+    MsgPackDeserializer indexed() const {
+        size_t n=0, off=0;
+        const bool map = isMap();
+        if (map) map_info(view_, n, off); else arr_info(view_, n, off);
+        const size_t slots = map ? 2 * n : n;
+        auto ix = std::make_shared<std::vector<size_t>>();
+        ix->reserve(slots + 1);
+        for (size_t i = 0; i < slots; ++i) {
+            ix->push_back(off);
+            off += mp_child_size(view_, off);
+        }
+        ix->push_back(off);
+        MsgPackDeserializer out(view_, true);
+        out.index_ = std::move(ix);
+        return out;
     }
 
     // ---- debug ----
@@ -491,66 +608,323 @@ public:
 
     // expose raw view if you need it
     std::span<const uint8_t> raw_view() const { return view_; }
+
+private:
+    // Value bytes for `key` (first match), or an empty span. Values are never
+    // empty, so empty means "not found".
+    std::span<const uint8_t> find_value(std::string_view key) const {
+        if (index_) {
+            const auto& ix = *index_;
+            for (size_t k = 0; k + 2 < ix.size(); k += 2) {
+                MsgPackDeserializer kd(view_.subspan(ix[k], ix[k + 1] - ix[k]), true);
+                if (kd.isString() && kd.asStringView() == key)
+                    return view_.subspan(ix[k + 1], ix[k + 2] - ix[k + 1]);
+            }
+            return {};
+        }
+        size_t n=0, off=0; map_info(view_, n, off);
+        for (size_t i=0;i<n;++i) {
+            const size_t ksz = mp_child_size(view_, off);
+            MsgPackDeserializer kd(view_.subspan(off, ksz), true);
+            off += ksz;
+            const size_t vsz = mp_child_size(view_, off);
+            if (kd.isString() && kd.asStringView() == key) {
+                return view_.subspan(off, vsz);
+            }
+            off += vsz;
+        }
+        return {};
+    }
 };
 
-// ===== Writer (msgpack-c) =====================================================
-class MsgPackRootSerializer {
+// ===== Writer ================================================================
+//
+// Hand-written encoder, templated on where the bytes go (see output.hpp):
+// MsgPackRootSerializer grows a vector (optionally from a BufferPool, with a
+// reserve() size hint); BasicMsgPackRootSerializer<SpanOutput> writes into a
+// caller-provided span, and once reused allocates nothing at all. Integers
+// take their smallest encoding, doubles are float64, and containers are
+// checked against their counts as items are written. The bytes are the same
+// as msgpack-c's.
+
+// Key K as a MsgPack str (header and bytes), encoded at compile time.
+template<fixed_string K>
+inline constexpr auto mp_encoded_key = [] {
+    constexpr std::size_t n = decltype(K)::size();
+    static_assert(n <= 0xffff, "MsgPack: compile-time key too long");
+    constexpr std::size_t h = n < 32 ? 1 : (n < 256 ? 2 : 3);
+    std::array<char, h + n> out{};
+    if constexpr (h == 1) {
+        out[0] = static_cast<char>(0xa0 | n);
+    } else if constexpr (h == 2) {
+        out[0] = static_cast<char>(0xd9);
+        out[1] = static_cast<char>(n);
+    } else {
+        out[0] = static_cast<char>(0xda);
+        out[1] = static_cast<char>(n >> 8);
+        out[2] = static_cast<char>(n & 0xff);
+    }
+    for (std::size_t i = 0; i < n; ++i) out[h + i] = K.data[i];
+    return out;
+}();
+
+template<class Out = VectorOutput>
+class BasicMsgPackRootSerializer {
 public:
-    msgpack_sbuffer sbuf{};
-    msgpack_packer  pk{};
+    Out out_;
+    std::vector<std::uint64_t> open_; // items still owed by each open container
+    bool wrote_root_ = false;
+
+    BasicMsgPackRootSerializer() = default;
+
+    // Vectors come from `pool`; finish() returns ZBuffers that give them back.
+    explicit BasicMsgPackRootSerializer(BufferPool& pool)
+        requires std::constructible_from<Out, BufferPool&>
+        : out_(pool) {}
 
-    MsgPackRootSerializer() {
-        msgpack_sbuffer_init(&sbuf);
-        msgpack_packer_init(&pk, &sbuf, msgpack_sbuffer_write);
+    // Write into `dst` (SpanOutput); see serialize_to().
+    explicit BasicMsgPackRootSerializer(std::span<std::uint8_t> dst)
+        requires std::constructible_from<Out, std::span<std::uint8_t>>
+        : out_(dst) {}
+    explicit BasicMsgPackRootSerializer(std::span<std::byte> dst)
+        requires std::constructible_from<Out, std::span<std::byte>>
+        : out_(dst) {}
+
+    BasicMsgPackRootSerializer(BasicMsgPackRootSerializer&&) = default;
+    BasicMsgPackRootSerializer& operator=(BasicMsgPackRootSerializer&&) = default;
+
+    // Size hint: a message of up to `bytes` is written without regrowing.
+    void reserve(std::size_t bytes) requires requires (Out& o) { o.reserve(bytes); } {
+        out_.reserve(bytes);
     }
-    ~MsgPackRootSerializer() { msgpack_sbuffer_destroy(&sbuf); }
 
     ZBuffer finish() {
-        if (sbuf.size == 0) return ZBuffer();
-        // steal buffer
-        size_t n = sbuf.size;
-        char*  d = sbuf.data;
-        sbuf.data = nullptr; sbuf.size = 0; sbuf.alloc = 0;
-        return ZBuffer(d, n, ZBuffer::Deleters::Free);
+        finalize();
+        ZBuffer result = out_.take();
+        reset();
+        return result;
+    }
+
+    // Bytes written so far; valid until the next reset(). With SpanOutput,
+    // throws OutputOverflow if the message did not fit.
+    std::span<const std::uint8_t> finish_view() {
+        finalize();
+        return out_.view();
+    }
+
+    // Discard the current message, keeping the output storage.
+    void reset() {
+        out_.clear();
+        open_.clear();
+        wrote_root_ = false;
+    }
+
+    // Discard the current message and write the next ones into `dst`.
+    void reset(std::span<std::byte> dst) requires requires (Out& o) { o.reset(dst); } {
+        reset();
+        out_.reset(dst);
+    }
+
+    // ---- encoding helpers (called by the Serializer) ----
+
+    void finalize() {
+        if (!open_.empty()) throw SerializationError("msgpack: finish() called with unterminated container");
+        if (!wrote_root_) put_byte(0xc0); // nil
+        wrote_root_ = true;
+    }
+
+    // Account for one item (a value, or a key) in the enclosing container.
+    void item() {
+        if (open_.empty()) {
+            if (wrote_root_) throw SerializationError("msgpack: multiple root values");
+            wrote_root_ = true;
+            return;
+        }
+        std::uint64_t& left = open_.back();
+        if (left == 0) throw SerializationError("msgpack: more items than the container's count");
+        --left;
+    }
+
+    void open(std::uint64_t items) {
+        if (open_.capacity() == 0) open_.reserve(16);
+        open_.push_back(items);
+    }
+
+    void close() {
+        if (open_.empty()) throw SerializationError("msgpack: end of container without a begin");
+        if (open_.back() != 0) throw SerializationError("msgpack: fewer items than the container's count");
+        open_.pop_back();
+    }
+
+    void put_byte(std::uint8_t b) { *out_.room(1) = b; out_.commit(1); }
+    void put_be(std::uint8_t marker, std::uint64_t v, int n) { output_be(out_, marker, v, n); }
+    void put_bytes(const void* p, std::size_t n) { output_bytes(out_, p, n); }
+
+    void put_uint(std::uint64_t v) {
+        if (v < 0x80)             put_byte(static_cast<std::uint8_t>(v));
+        else if (v <= 0xff)       put_be(0xcc, v, 1);
+        else if (v <= 0xffff)     put_be(0xcd, v, 2);
+        else if (v <= 0xffffffff) put_be(0xce, v, 4);
+        else                      put_be(0xcf, v, 8);
+    }
+
+    void put_int(std::int64_t v) {
+        if (v >= 0) { put_uint(static_cast<std::uint64_t>(v)); return; }
+        const auto u = static_cast<std::uint64_t>(v);
+        if (v >= -32)                 put_byte(static_cast<std::uint8_t>(u));
+        else if (v >= INT8_MIN)       put_be(0xd0, u, 1);
+        else if (v >= INT16_MIN)      put_be(0xd1, u, 2);
+        else if (v >= INT32_MIN)      put_be(0xd2, u, 4);
+        else                          put_be(0xd3, u, 8);
+    }
+
+    // Header of a str/bin/array/map: fix form (if any) below `fix_limit`, then 8/16/32-bit lengths.
+    void put_len(std::uint8_t fix, std::size_t fix_limit, std::uint8_t m8, std::uint8_t m16, std::uint8_t m32, std::uint64_t n) {
+        if (n < fix_limit)          put_byte(static_cast<std::uint8_t>(fix | n));
+        else if (m8 && n <= 0xff)   put_be(m8, n, 1);
+        else if (n <= 0xffff)       put_be(m16, n, 2);
+        else if (n <= 0xffffffff)   put_be(m32, n, 4);
+        else throw SerializationError("msgpack: length exceeds 2^32-1");
     }
 };
 
-class MsgPackSerializer {
-    msgpack_packer& pk_;
+template<class Out = VectorOutput>
+class BasicMsgPackSerializer {
+    BasicMsgPackRootSerializer<Out>* r_;
 public:
-    explicit MsgPackSerializer(MsgPackRootSerializer& rs) : pk_(rs.pk) {}
+    explicit BasicMsgPackSerializer(BasicMsgPackRootSerializer<Out>& rs) : r_(&rs) {}
 
     // primitives
-    void null()                 { msgpack_pack_nil(&pk_); }
-    void boolean(bool v)        { v ? msgpack_pack_true(&pk_) : msgpack_pack_false(&pk_); }
-    void int64(std::int64_t v)  { msgpack_pack_int64(&pk_, v); }
-    void uint64(std::uint64_t v){ msgpack_pack_uint64(&pk_, v); }
-    void double_(double v)      { msgpack_pack_double(&pk_, v); }
+    void null()                  { r_->item(); r_->put_byte(0xc0); }
+    void boolean(bool v)         { r_->item(); r_->put_byte(v ? 0xc3 : 0xc2); }
+    void int64(std::int64_t v)   { r_->item(); r_->put_int(v); }
+    void uint64(std::uint64_t v) { r_->item(); r_->put_uint(v); }
+    void double_(double v) {
+        r_->item();
+        std::uint64_t bits = 0;
+        std::memcpy(&bits, &v, sizeof(bits));
+        r_->put_be(0xcb, bits, 8);
+    }
     void string(std::string_view sv) {
-        msgpack_pack_str(&pk_, sv.size());
-        msgpack_pack_str_body(&pk_, sv.data(), sv.size());
+        r_->item();
+        r_->put_len(0xa0, 32, 0xd9, 0xda, 0xdb, sv.size());
+        r_->put_bytes(sv.data(), sv.size());
     }
     void binary(std::span<const std::byte> b) {
-        auto p = reinterpret_cast<const char*>(b.data());
-        msgpack_pack_bin(&pk_, b.size());
-        msgpack_pack_bin_body(&pk_, p, b.size());
+        r_->item();
+        r_->put_len(0, 0, 0xc4, 0xc5, 0xc6, b.size());
+        r_->put_bytes(b.data(), b.size());
     }
 
     // arrays/maps (MsgPack needs sizes up-front)
-    void begin_array(std::size_t n) { msgpack_pack_array(&pk_, n); }
-    void end_array()                { /* no-op */ }
+    void begin_array(std::size_t n) {
+        r_->item();
+        r_->put_len(0x90, 16, 0, 0xdc, 0xdd, n);
+        r_->open(n);
+    }
+    void end_array() { r_->close(); }
 
-    void begin_map(std::size_t n)   { msgpack_pack_map(&pk_, n); }
-    void end_map()                  { /* no-op */ }
+    void begin_map(std::size_t n) {
+        r_->item();
+        r_->put_len(0x80, 16, 0, 0xde, 0xdf, n);
+        r_->open(2 * static_cast<std::uint64_t>(n));
+    }
+    void end_map() { r_->close(); }
 
-    void key(std::string_view k)    { string(k); }
+    void key(std::string_view k) { string(k); }
+
+    // Pre-encoded compile-time key: one write; see RawKeyWriter.
+    template<fixed_string K>
+    void key_raw() {
+        constexpr auto& enc = mp_encoded_key<K>;
+        r_->item();
+        r_->put_bytes(enc.data(), enc.size());
+    }
 };
 
+// Counts the bytes BasicMsgPackSerializer would write for the same calls,
+// writing nothing and never allocating; see measure(). It does not check
+// container counts, which the real writer still does.
+class MsgPackSizeCounter {
+    std::size_t n_ = 0;
+public:
+    // Message size so far; a message with no value is the 1-byte nil.
+    std::size_t size() const { return n_ ? n_ : 1; }
+    void reset() { n_ = 0; }
+
+    static std::size_t uint_size(std::uint64_t v) {
+        return v < 0x80 ? 1 : v <= 0xff ? 2 : v <= 0xffff ? 3 : v <= 0xffffffff ? 5 : 9;
+    }
+    static std::size_t int_size(std::int64_t v) {
+        if (v >= 0) return uint_size(static_cast<std::uint64_t>(v));
+        return v >= -32 ? 1 : v >= INT8_MIN ? 2 : v >= INT16_MIN ? 3 : v >= INT32_MIN ? 5 : 9;
+    }
+    // Header of a str/bin/array/map, as put_len() writes it.
+    static std::size_t len_size(std::size_t fix_limit, bool has8, std::uint64_t n) {
+        if (n < fix_limit) return 1;
+        if (has8 && n <= 0xff) return 2;
+        if (n <= 0xffff) return 3;
+        if (n <= 0xffffffff) return 5;
+        throw SerializationError("msgpack: length exceeds 2^32-1");
+    }
+
+    void null()                       { n_ += 1; }
+    void boolean(bool)                { n_ += 1; }
+    void int64(std::int64_t v)        { n_ += int_size(v); }
+    void uint64(std::uint64_t v)      { n_ += uint_size(v); }
+    void double_(double)              { n_ += 9; }
+    void string(std::string_view sv)  { n_ += len_size(32, true, sv.size()) + sv.size(); }
+    void binary(std::span<const std::byte> b) { n_ += len_size(0, true, b.size()) + b.size(); }
+    void begin_array(std::size_t n)   { n_ += len_size(16, false, n); }
+    void end_array()                  {}
+    void begin_map(std::size_t n)     { n_ += len_size(16, false, n); }
+    void end_map()                    {}
+    void key(std::string_view k)      { string(k); }
+
+    template<fixed_string K>
+    void key_raw() { n_ += mp_encoded_key<K>.size(); }
+};
+
+using MsgPackRootSerializer = BasicMsgPackRootSerializer<>;
+using MsgPackSerializer     = BasicMsgPackSerializer<>;
+
 struct MsgPack {
     static inline constexpr const char* Name = "MsgPack";
     using Deserializer   = MsgPackDeserializer; 
     using RootSerializer = MsgPackRootSerializer;
     using Serializer     = MsgPackSerializer;
+    using SpanRootSerializer = BasicMsgPackRootSerializer<SpanOutput>;
+    using SpanSerializer     = BasicMsgPackSerializer<SpanOutput>;
+    using SizeCounter        = MsgPackSizeCounter;
+
+    // Size of the message at the start of `b`; see SelfDelimitingProtocol.
+    static size_t frame_size(std::span<const uint8_t> b) { return mp_skip(b); }
+
+    // Overwrite a scalar in place; see PatchableProtocol. Numeric slots are
+    // the 9-byte int64, uint64 and float64 forms.
+    static void patch_bool(std::span<uint8_t> slot, bool v) {
+        if (slot.size() != 1 || (slot[0] != 0xc2 && slot[0] != 0xc3)) bad_slot();
+        slot[0] = v ? 0xc3 : 0xc2;
+    }
+    static void patch_int64(std::span<uint8_t> slot, std::int64_t v) {
+        if (slot.size() != 9 || slot[0] != 0xd3) bad_slot();
+        mp_write_be64(slot.data() + 1, static_cast<uint64_t>(v));
+    }
+    static void patch_uint64(std::span<uint8_t> slot, std::uint64_t v) {
+        if (slot.size() != 9 || slot[0] != 0xcf) bad_slot();
+        mp_write_be64(slot.data() + 1, v);
+    }
+    static void patch_double(std::span<uint8_t> slot, double v) {
+        if (slot.size() != 9 || slot[0] != 0xcb) bad_slot();
+        uint64_t bits = 0;
+        std::memcpy(&bits, &v, sizeof(bits));
+        mp_write_be64(slot.data() + 1, bits);
+    }
+
+private:
+    [[noreturn]] static void bad_slot() {
+        throw SerializationError("msgpack: patch slot is not the expected scalar");
+    }
 };
 
 } // namespace zerialize
@@ -0,0 +1,96 @@
+// MessagePack written through msgpack-c's sbuffer, read by the native reader.
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include <string_view>
+
+#include <msgpack.h>
+
+#include <zerialize/protocols/msgpack.hpp>
+
+namespace zerialize {
+
+/*
+ * MsgPackC is MsgPack with msgpack-c as the writer. The bytes are the same
+ * MessagePack, and the reader, frame_size and patch functions are the same as
+ * MsgPack's. Use it only when a build already links msgpack-c and wants its
+ * packer. The native MsgPack writer has no dependencies, does not call through
+ * a function pointer per value, and is the default.
+ */
+class MsgPackCRootSerializer {
+public:
+    msgpack_sbuffer sbuf{};
+    msgpack_packer  pk{};
+
+    MsgPackCRootSerializer() {
+        msgpack_sbuffer_init(&sbuf);
+        msgpack_packer_init(&pk, &sbuf, msgpack_sbuffer_write);
+    }
+    ~MsgPackCRootSerializer() { msgpack_sbuffer_destroy(&sbuf); }
+    MsgPackCRootSerializer(const MsgPackCRootSerializer&) = delete;
+    MsgPackCRootSerializer& operator=(const MsgPackCRootSerializer&) = delete;
+
+    ZBuffer finish() {
+        if (sbuf.size == 0) return ZBuffer();
+        // steal buffer
+        size_t n = sbuf.size;
+        char*  d = sbuf.data;
+        sbuf.data = nullptr; sbuf.size = 0; sbuf.alloc = 0;
+        return ZBuffer(d, n, ZBuffer::Deleters::Free);
+    }
+
+    // Bytes written so far; valid until the next reset().
+    std::span<const std::uint8_t> finish_view() {
+        return std::span<const std::uint8_t>(reinterpret_cast<const std::uint8_t*>(sbuf.data), sbuf.size);
+    }
+
+    // Discard the current message; the sbuffer keeps its allocation.
+    void reset() { sbuf.size = 0; }
+};
+
+class MsgPackCSerializer {
+    msgpack_packer& pk_;
+public:
+    explicit MsgPackCSerializer(MsgPackCRootSerializer& rs) : pk_(rs.pk) {}
+
+    // primitives
+    void null()                 { msgpack_pack_nil(&pk_); }
+    void boolean(bool v)        { v ? msgpack_pack_true(&pk_) : msgpack_pack_false(&pk_); }
+    void int64(std::int64_t v)  { msgpack_pack_int64(&pk_, v); }
+    void uint64(std::uint64_t v){ msgpack_pack_uint64(&pk_, v); }
+    void double_(double v)      { msgpack_pack_double(&pk_, v); }
+    void string(std::string_view sv) {
+        msgpack_pack_str(&pk_, sv.size());
+        msgpack_pack_str_body(&pk_, sv.data(), sv.size());
+    }
+    void binary(std::span<const std::byte> b) {
+        auto p = reinterpret_cast<const char*>(b.data());
+        msgpack_pack_bin(&pk_, b.size());
+        msgpack_pack_bin_body(&pk_, p, b.size());
+    }
+
+    // arrays/maps (MsgPack needs sizes up-front)
+    void begin_array(std::size_t n) { msgpack_pack_array(&pk_, n); }
+    void end_array()                { /* no-op */ }
+
+    void begin_map(std::size_t n)   { msgpack_pack_map(&pk_, n); }
+    void end_map()                  { /* no-op */ }
+
+    void key(std::string_view k)    { string(k); }
+
+    // Pre-encoded compile-time key: one write; see RawKeyWriter.
+    template<fixed_string K>
+    void key_raw() {
+        constexpr auto& enc = mp_encoded_key<K>;
+        pk_.callback(pk_.data, enc.data(), enc.size());
+    }
+};
+
+struct MsgPackC : MsgPack {
+    using RootSerializer = MsgPackCRootSerializer;
+    using Serializer     = MsgPackCSerializer;
+};
+
+} // namespace zerialize
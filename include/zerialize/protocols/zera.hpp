@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
@@ -18,7 +19,11 @@
 #include <array>
 
 #include <zerialize/zbuffer.hpp>
+#include <zerialize/buffer_pool.hpp>
+#include <zerialize/segments.hpp>
 #include <zerialize/errors.hpp>
+#include <zerialize/concepts.hpp>
+#include <zerialize/internals/fixed_string.hpp>
 
 namespace zerialize {
 namespace zera {
@@ -29,10 +34,27 @@ namespace zera {
 
 inline constexpr std::uint32_t Magic = 0x564E455A; // 'ZENV' little-endian
 inline constexpr std::uint16_t Version = 1;
+inline constexpr std::uint16_t VersionIndexed = 2; // v1 + indexed objects
+inline constexpr std::uint16_t VersionTensor = 3;  // v2 + native tensors
 inline constexpr std::uint32_t HeaderSize = 20;
 inline constexpr std::uint32_t ArenaBaseAlign = 16;
 inline constexpr std::uint32_t InlineMax = 12;
 inline constexpr std::uint32_t RankMax = 8;
+inline constexpr std::size_t EnvReserve = 640;       // first envelope region of a new writer
+inline constexpr std::size_t EnvReserveLarge = 1024; // region once the arena reaches LargeArena
+inline constexpr std::size_t LargeArena = 64 * 1024;
+
+// OBJECT ValueRef flag: `b` points at a key hash index (see ObjectIndex in ZERA.md).
+inline constexpr std::uint8_t ObjectIndexedFlag = 1;
+inline constexpr std::uint32_t IndexEmptySlot = 0xffffffffu;
+inline constexpr std::uint32_t DefaultObjectIndexThreshold = 0; // off: output stays v1
+
+// TYPED_ARRAY ValueRef flag: written by typed_array() as a tensor, so readers
+// present it via asTypedArray() rather than as a blob (even for u8 rank 1).
+// Only written on request (set_native_tensors()), and marks the buffer v3.
+inline constexpr std::uint8_t TensorFlag = 1;
+
+static_assert(RankMax == TypedArrayMaxRank);
 
 enum class Tag : std::uint8_t {
     Null      = 0,
@@ -59,6 +81,61 @@ enum class DType : std::uint16_t {
     F64 = 10,
 };
 
+// Mapping between zerialize tensor dtype codes (tensor_dtype_index) and DType.
+// Codes without a ZERA DType (complex, half) are not encoded natively.
+inline std::optional<DType> dtype_from_tensor_code(int code) {
+    switch (code) {
+        case 0:  return DType::I8;
+        case 1:  return DType::I16;
+        case 2:  return DType::I32;
+        case 3:  return DType::I64;
+        case 4:  return DType::U8;
+        case 5:  return DType::U16;
+        case 6:  return DType::U32;
+        case 7:  return DType::U64;
+        case 10: return DType::F32;
+        case 11: return DType::F64;
+    }
+    return std::nullopt;
+}
+
+inline int tensor_code_from_dtype(DType t) {
+    switch (t) {
+        case DType::I8:  return 0;
+        case DType::I16: return 1;
+        case DType::I32: return 2;
+        case DType::I64: return 3;
+        case DType::U8:  return 4;
+        case DType::U16: return 5;
+        case DType::U32: return 6;
+        case DType::U64: return 7;
+        case DType::F32: return 10;
+        case DType::F64: return 11;
+    }
+    return -1;
+}
+
+// Element count of a shape, or nullopt if it cannot fit a u32-sized payload.
+inline std::optional<std::uint64_t> shape_element_count(std::span<const std::uint64_t> dims) {
+    for (auto d : dims) if (d == 0) return 0;
+    std::uint64_t n = 1;
+    for (auto d : dims) {
+        if (n > std::numeric_limits<std::uint32_t>::max() / d) return std::nullopt;
+        n *= d;
+    }
+    return n;
+}
+
+inline std::size_t dtype_size(DType t) {
+    switch (t) {
+        case DType::I8:  case DType::U8:  return 1;
+        case DType::I16: case DType::U16: return 2;
+        case DType::I32: case DType::U32: case DType::F32: return 4;
+        case DType::I64: case DType::U64: case DType::F64: return 8;
+    }
+    return 0;
+}
+
 // ---- little-endian IO helpers (byte layouts, not packed structs) ----
 inline std::uint16_t read_u16_le(const std::uint8_t* p) {
     return std::uint16_t(p[0]) | (std::uint16_t(p[1]) << 8);
@@ -88,17 +165,42 @@ inline void append_u64_le(std::vector<std::uint8_t>& out, std::uint64_t v) {
     append_u32_le(out, std::uint32_t((v >> 32) & 0xffffffffu));
 }
 
-inline void write_u16_le_at(std::vector<std::uint8_t>& out, std::size_t at, std::uint16_t v) {
+template<class Buf>
+inline void write_u16_le_at(Buf& out, std::size_t at, std::uint16_t v) {
     out.at(at + 0) = std::uint8_t(v & 0xff);
     out.at(at + 1) = std::uint8_t((v >> 8) & 0xff);
 }
-inline void write_u32_le_at(std::vector<std::uint8_t>& out, std::size_t at, std::uint32_t v) {
+template<class Buf>
+inline void write_u32_le_at(Buf& out, std::size_t at, std::uint32_t v) {
     out.at(at + 0) = std::uint8_t(v & 0xff);
     out.at(at + 1) = std::uint8_t((v >> 8) & 0xff);
     out.at(at + 2) = std::uint8_t((v >> 16) & 0xff);
     out.at(at + 3) = std::uint8_t((v >> 24) & 0xff);
 }
 
+// Object entry head for compile-time key K: [u16 len][u16 reserved][bytes].
+template<fixed_string K>
+inline constexpr auto encoded_key = [] {
+    constexpr std::size_t n = decltype(K)::size();
+    static_assert(n <= 0xffff, "zera: compile-time key too long");
+    std::array<std::uint8_t, 4 + n> out{};
+    out[0] = std::uint8_t(n & 0xff);
+    out[1] = std::uint8_t(n >> 8);
+    for (std::size_t i = 0; i < n; ++i) out[4 + i] = std::uint8_t(K.data[i]);
+    return out;
+}();
+
+// FNV-1a, 32-bit. Used for object key indexes; constexpr so callers can
+// precompute hashes of compile-time keys.
+constexpr std::uint32_t key_hash(std::string_view k) {
+    std::uint32_t h = 2166136261u;
+    for (char ch : k) {
+        h ^= static_cast<std::uint8_t>(ch);
+        h *= 16777619u;
+    }
+    return h;
+}
+
 inline std::size_t align_up(std::size_t x, std::size_t a) {
     if (a == 0) return x;
     const std::size_t r = x % a;
@@ -207,6 +309,10 @@ protected:
         const std::uint8_t fl = flags();
         if (t == Tag::String) {
             require((fl & ~std::uint8_t{1}) == 0, "zera: unknown ValueRef flags");
+        } else if (t == Tag::Object) {
+            require((fl & ~ObjectIndexedFlag) == 0, "zera: unknown ValueRef flags");
+        } else if (t == Tag::TypedArray) {
+            require((fl & ~TensorFlag) == 0, "zera: unknown ValueRef flags");
         } else {
             require(fl == 0, "zera: non-string ValueRef has flags set");
         }
@@ -222,7 +328,10 @@ public:
     bool isString() const { return tag() == Tag::String; }
     bool isArray()  const { return tag() == Tag::Array; }
     bool isMap()    const { return tag() == Tag::Object; }
-    bool isBlob()   const { return tag() == Tag::TypedArray && aux() == std::uint16_t(DType::U8); }
+    bool isBlob()   const {
+        return tag() == Tag::TypedArray && aux() == std::uint16_t(DType::U8) && (flags() & TensorFlag) == 0;
+    }
+    bool isTypedArray() const { return tag() == Tag::TypedArray && (flags() & TensorFlag) != 0; }
 
     // Scalars
     bool asBool() const {
@@ -336,6 +445,29 @@ public:
         return arena_blob_view(a(), b());
     }
 
+    // Dtype, shape and data of a tensor written by typed_array(); the data is
+    // a view into the arena. Validates that the shape matches the byte length.
+    TypedArrayView asTypedArray() const {
+        require(isTypedArray(), "zera: value is not a typed array");
+        require_flags_ok();
+
+        const int code = tensor_code_from_dtype(DType(aux()));
+        require(code >= 0, "zera: unknown typed array dtype");
+        TypedArrayView out;
+        out.dtype = code;
+
+        const std::uint32_t shape_ofs = c();
+        out.rank = read_u32_le(env_ptr_at(shape_ofs, 4));
+        require(out.rank <= RankMax, "zera: typed array rank too large");
+        const auto* dims = env_ptr_at(shape_ofs + 4, 8 * std::size_t(out.rank));
+        for (std::uint32_t i = 0; i < out.rank; ++i) out.dims[i] = read_u64_le(dims + 8 * i);
+        const auto count = shape_element_count(out.shape());
+        require(count && *count * dtype_size(DType(aux())) == b(), "zera: typed array shape does not match byte length");
+
+        out.data = arena_blob_view(a(), b());
+        return out;
+    }
+
     std::size_t arraySize() const {
         require(tag() == Tag::Array, "zera: not an array");
         require_flags_ok();
@@ -400,9 +532,61 @@ public:
         return KeysView{this, entries, count};
     }
 
+    // One pass over (key, value) pairs; see MapCursorReader. Without an object
+    // index each operator[](key) is a linear scan, so full traversal uses this.
+    struct EntriesView {
+        KeysView keys;
+
+        struct iterator {
+            KeysView::iterator k{};
+            using iterator_category = std::forward_iterator_tag;
+            using iterator_concept  = std::forward_iterator_tag;
+            using value_type        = std::pair<std::string_view, ZeraValue>;
+            using difference_type   = std::ptrdiff_t;
+            using reference         = value_type;
+
+            reference operator*() const; // defined after ZeraValue
+            iterator& operator++() { ++k; return *this; }
+            iterator operator++(int) { iterator tmp = *this; ++(*this); return tmp; }
+            friend bool operator==(const iterator& a, const iterator& b) { return a.k == b.k; }
+        };
+
+        std::size_t size() const { return keys.count; }
+        iterator begin() const { return iterator{keys.begin()}; }
+        iterator end() const { return iterator{keys.end()}; }
+    };
+
+    EntriesView mapEntries() const { return EntriesView{mapKeys()}; }
+
     bool contains(std::string_view key) const {
         if (!isMap()) return false;
-        (void)require_flags_ok();
+        return find_value(key, key_hash(key)) != nullptr;
+    }
+
+    ZeraValue operator[](std::size_t idx) const;
+    ZeraValue operator[](std::string_view key) const;
+
+    // Lookup with a precomputed hash; see HashedKeyReader. On an indexed
+    // object this is one probe, so reading a few fields of a large object by
+    // compile-time key costs neither a scan nor hashing at run time.
+    static constexpr std::uint32_t key_hash(std::string_view k) { return zera::key_hash(k); }
+    bool hasKeyIndex() const { return isMap() && (flags() & ObjectIndexedFlag) != 0; }
+    std::optional<ZeraValue> find(std::string_view key, std::uint32_t hash) const; // hash == key_hash(key)
+
+    // The 16 bytes of this value's ValueRef; scalars live entirely in it.
+    std::span<const std::uint8_t> raw_view() const {
+        require_vr();
+        return std::span<const std::uint8_t>(vr_, 16);
+    }
+
+protected:
+    // Returns the value ValueRef for `key` (first match), or nullptr.
+    // `hash` must be key_hash(key); it is only used by indexed objects.
+    const std::uint8_t* find_value(std::string_view key, std::uint32_t hash) const {
+        require(tag() == Tag::Object, "zera: not a map");
+        require_flags_ok();
+        if (flags() & ObjectIndexedFlag) return find_value_indexed(key, hash);
+
         const std::uint32_t obj_ofs = a();
         const auto* p = env_ptr_at(obj_ofs, 4);
         const std::uint32_t count = read_u32_le(p);
@@ -412,16 +596,39 @@ public:
             const std::uint16_t key_len = read_u16_le(e);
             (void)read_u16_le(e + 2); // reserved
             const auto* key_bytes = env_ptr_at(static_cast<std::uint32_t>(ofs + 4), key_len);
-            if (key_len == key.size() &&
-                std::memcmp(key_bytes, key.data(), key.size()) == 0) return true;
+            const auto* value_vr = env_ptr_at(static_cast<std::uint32_t>(ofs + 4 + key_len), 16);
+            if (key_len == key.size() && std::memcmp(key_bytes, key.data(), key.size()) == 0) {
+                return value_vr;
+            }
             ofs += 4 + std::size_t(key_len) + 16;
             (void)env_ptr_at(static_cast<std::uint32_t>(ofs), 0);
         }
-        return false;
+        return nullptr;
     }
 
-    ZeraValue operator[](std::size_t idx) const;
-    ZeraValue operator[](std::string_view key) const;
+    // Open-addressed table: [u32 slot_count (power of two)][{u32 hash, u32 entry_ofs}...],
+    // linear probing, entry_ofs == IndexEmptySlot marks an empty slot.
+    const std::uint8_t* find_value_indexed(std::string_view key, std::uint32_t hash) const {
+        const std::uint32_t idx_ofs = b();
+        const std::uint32_t slots = read_u32_le(env_ptr_at(idx_ofs, 4));
+        require(slots != 0 && (slots & (slots - 1)) == 0, "zera: object index size not a power of two");
+        const std::uint8_t* table = env_ptr_at(idx_ofs + 4, 8 * std::size_t(slots));
+        const std::uint32_t mask = slots - 1;
+        for (std::uint32_t n = 0, i = hash & mask; n < slots; ++n, i = (i + 1) & mask) {
+            const std::uint8_t* slot = table + 8 * std::size_t(i);
+            const std::uint32_t entry_ofs = read_u32_le(slot + 4);
+            if (entry_ofs == IndexEmptySlot) return nullptr;
+            if (read_u32_le(slot) != hash) continue;
+            const auto* e = env_ptr_at(entry_ofs, 4);
+            const std::uint16_t key_len = read_u16_le(e);
+            if (key_len != key.size()) continue;
+            const auto* entry = env_ptr_at(entry_ofs, 4 + std::size_t(key_len) + 16);
+            if (std::memcmp(entry + 4, key.data(), key.size()) == 0) return entry + 4 + key_len;
+        }
+        return nullptr;
+    }
+
+public:
 
     std::string to_string() const {
         std::ostringstream os;
@@ -450,6 +657,11 @@ public:
         : ZeraViewBase(parent, vr) {}
 };
 
+inline std::pair<std::string_view, ZeraValue> ZeraViewBase::EntriesView::iterator::operator*() const {
+    const std::string_view key = *k; // bounds-checks the whole entry
+    return { key, ZeraValue(*k.self, k.cur + 4 + key.size()) };
+}
+
 inline ZeraValue ZeraViewBase::operator[](std::size_t idx) const {
     require(tag() == Tag::Array, "zera: not an array");
     require_flags_ok();
@@ -463,27 +675,15 @@ inline ZeraValue ZeraViewBase::operator[](std::size_t idx) const {
 }
 
 inline ZeraValue ZeraViewBase::operator[](std::string_view key) const {
-    require(tag() == Tag::Object, "zera: not a map");
-    require_flags_ok();
-    const std::uint32_t obj_ofs = a();
-    const auto* p = env_ptr_at(obj_ofs, 4);
-    const std::uint32_t count = read_u32_le(p);
-    std::size_t ofs = obj_ofs + 4;
-    for (std::uint32_t i = 0; i < count; ++i) {
-        const auto* e = env_ptr_at(static_cast<std::uint32_t>(ofs), 4);
-        const std::uint16_t key_len = read_u16_le(e);
-        (void)read_u16_le(e + 2); // reserved
-        const auto* key_bytes = env_ptr_at(static_cast<std::uint32_t>(ofs + 4), key_len);
-        const auto* value_vr = env_ptr_at(static_cast<std::uint32_t>(ofs + 4 + key_len), 16);
-        if (key_len == key.size() && std::memcmp(key_bytes, key.data(), key.size()) == 0) {
-            return ZeraValue(*this, value_vr);
-        }
-        ofs += 4 + std::size_t(key_len) + 16;
-        (void)env_ptr_at(static_cast<std::uint32_t>(ofs), 0);
-    }
+    if (const auto* vr = find_value(key, key_hash(key))) return ZeraValue(*this, vr);
     throw DeserializationError("zera: key not found: " + std::string(key));
 }
 
+inline std::optional<ZeraValue> ZeraViewBase::find(std::string_view key, std::uint32_t hash) const {
+    if (const auto* vr = find_value(key, hash)) return ZeraValue(*this, vr);
+    return std::nullopt;
+}
+
 class ZeraDeserializer final : public ZeraViewBase {
     std::vector<std::uint8_t> owned_;
     std::span<const std::uint8_t> view_{};
@@ -491,7 +691,7 @@ class ZeraDeserializer final : public ZeraViewBase {
     void init_from(std::span<const std::uint8_t> buf) {
         auto h = parse_header(buf);
         if (h.magic != Magic) throw DeserializationError("zera: bad magic");
-        if (h.version != Version) throw DeserializationError("zera: unsupported version");
+        if (h.version < Version || h.version > VersionTensor) throw DeserializationError("zera: unsupported version");
         if (h.flags != 1) throw DeserializationError("zera: flags invalid (expected little-endian bit0)");
 
         require(h.env_size <= buf.size(), "zera: env_size out of bounds");
@@ -539,6 +739,7 @@ public:
     using ZeraViewBase::isFloat;
     using ZeraViewBase::isString;
     using ZeraViewBase::isBlob;
+    using ZeraViewBase::isTypedArray;
     using ZeraViewBase::isMap;
     using ZeraViewBase::isArray;
     using ZeraViewBase::asInt8;
@@ -555,42 +756,336 @@ public:
     using ZeraViewBase::asStringView;
     using ZeraViewBase::asBool;
     using ZeraViewBase::asBlob;
+    using ZeraViewBase::asTypedArray;
     using ZeraViewBase::mapKeys;
+    using ZeraViewBase::mapEntries;
     using ZeraViewBase::contains;
     using ZeraViewBase::arraySize;
     using ZeraViewBase::operator[];
+    using ZeraViewBase::key_hash;
+    using ZeraViewBase::hasKeyIndex;
+    using ZeraViewBase::find;
+    using ZeraViewBase::raw_view;
     using ZeraViewBase::to_string;
 };
 
 // =============================================================================
 //  Writer (Builder)
 // =============================================================================
+//
+// Single-pass writer. Everything is written into one output vector laid out as
+//
+//   [Header][Envelope ... | slack][Arena ...]
+//
+// The header is reserved up front and filled in by finish(). The envelope grows
+// into a reserved region in front of the arena; if it outgrows that region the
+// arena is slid up as a whole (arena offsets are relative to the arena base, so
+// nothing needs re-patching). Array payloads are reserved in place from the
+// begin_array() hint and element ValueRefs are written straight into their slots.
+// Object entries have variable size, so they are staged on a shared scratch
+// stack and land in the envelope with one memcpy at end_map(). finish() hands the
+// output vector to ZBuffer without copying it.
+//
+// Blobs at or above the blob reference threshold are not copied into the arena:
+// the writer records where they go and reserves their place in the arena's
+// offsets only. finish_segments() returns the output vector cut around them, with
+// the caller's blob memory as the segments in between; finish() and finish_view()
+// copy them in.
+//
+// Constructed from a span, the writer lays the same message out in the
+// caller's memory instead. The envelope region starts small, and the arena is
+// slid down onto the envelope whenever the span runs short, so a message fits
+// whenever its final size does.
+//
+// The output depends on the message only. A reused writer opens its region at
+// the size of earlier envelopes, so it does not slide the arena while writing,
+// but finish() puts the arena where a new writer would have (grown_base()),
+// and it moves there early if it reaches LargeArena. serialize_into() thus
+// writes the bytes serialize() does, and measure() predicts both.
+
+// The writer's output bytes: a vector it owns (sized ahead of size(), handed
+// over by take()), or a span the caller owns. A span that runs out spills
+// into the vector, so the message can still be finished and measured; see
+// spilled().
+class OutputBytes {
+public:
+    OutputBytes() = default;
+    explicit OutputBytes(std::vector<std::uint8_t> v) : vec_(std::move(v)) {}
+    explicit OutputBytes(std::span<std::uint8_t> dst) { bind(dst); }
+
+    OutputBytes(OutputBytes&& o) noexcept { *this = std::move(o); }
+    OutputBytes& operator=(OutputBytes&& o) noexcept {
+        if (this != &o) {
+            vec_ = std::move(o.vec_); // keeps its buffer, so p_ stays valid
+            ext_ = o.ext_;
+            p_ = std::exchange(o.p_, nullptr);
+            n_ = std::exchange(o.n_, 0);
+            cap_ = std::exchange(o.cap_, 0);
+            bounded_ = o.bounded_;
+            spilled_ = o.spilled_;
+        }
+        return *this;
+    }
+
+    std::uint8_t* data() { return p_; }
+    const std::uint8_t* data() const { return p_; }
+    std::size_t size() const { return n_; }
+    std::size_t capacity() const { return cap_; }
+    std::uint8_t& at(std::size_t i) {
+        if (i >= n_) throw std::out_of_range("zera: output offset out of range");
+        return p_[i];
+    }
+
+    // Writing into a caller's span; spilled() once it has overflowed.
+    bool bounded() const { return bounded_; }
+    bool spilled() const { return spilled_; }
+    std::size_t span_size() const { return ext_.size(); }
+
+    // Grow or shrink to `n` bytes; new bytes are zero.
+    void resize(std::size_t n) {
+        if (n > cap_) grow(n);
+        if (n > n_) std::memset(p_ + n_, 0, n - n_);
+        n_ = n;
+    }
+    void append(const std::uint8_t* p, std::size_t n) {
+        if (n == 0) return;
+        if (cap_ - n_ < n) grow(n_ + n);
+        std::memcpy(p_ + n_, p, n);
+        n_ += n;
+    }
+    void reserve(std::size_t n) {
+        if (!bounded_ && n > cap_) grow(n);
+    }
+
+    // Start over; a spilled span writer goes back to its span.
+    void clear() {
+        n_ = 0;
+        if (spilled_) { p_ = ext_.data(); cap_ = ext_.size(); spilled_ = false; }
+    }
+
+    // Write the next messages into `dst`.
+    void bind(std::span<std::uint8_t> dst) {
+        ext_ = dst;
+        p_ = dst.data();
+        cap_ = dst.size();
+        n_ = 0;
+        bounded_ = true;
+        spilled_ = false;
+    }
+
+    // The bytes as a vector, leaving this empty. Copies when writing into a span.
+    std::vector<std::uint8_t> take() {
+        std::vector<std::uint8_t> out;
+        if (bounded_) {
+            out.assign(p_, p_ + n_);
+            clear();
+            return out;
+        }
+        vec_.resize(n_);
+        out = std::move(vec_);
+        vec_ = {};
+        p_ = nullptr;
+        n_ = cap_ = 0;
+        return out;
+    }
+    std::vector<std::uint8_t> release() {
+        std::vector<std::uint8_t> out = std::move(vec_);
+        vec_ = {};
+        p_ = nullptr;
+        n_ = cap_ = 0;
+        return out;
+    }
+
+private:
+    void grow(std::size_t n) {
+        if (bounded_ && !spilled_) {
+            vec_.resize(std::max({vec_.size(), n, 2 * cap_}));
+            if (n_) std::memcpy(vec_.data(), p_, n_);
+            spilled_ = true;
+        } else {
+            vec_.resize(std::max({vec_.capacity(), 2 * cap_, n, std::size_t(256)}));
+        }
+        p_ = vec_.data();
+        cap_ = vec_.size();
+    }
+
+    std::vector<std::uint8_t> vec_; // owned bytes; size() is the capacity in use
+    std::span<std::uint8_t> ext_{};
+    std::uint8_t* p_ = nullptr;
+    std::size_t n_ = 0;
+    std::size_t cap_ = 0;
+    bool bounded_ = false;
+    bool spilled_ = false;
+};
+
+// Arena start of a new writer after making room for `need` envelope bytes on
+// top of `env`: the first use opens an EnvReserve region, which then doubles.
+inline std::size_t grown_base(std::size_t base, std::size_t env, std::size_t need) {
+    if (base == 0) return align_up(HeaderSize + std::max(EnvReserve, need), ArenaBaseAlign);
+    if (HeaderSize + env + need <= base) return base;
+    return align_up(HeaderSize + std::max(2 * (base - HeaderSize), env + need), ArenaBaseAlign);
+}
 
 struct RootSerializer {
     struct ArrayCtx {
-        std::vector<std::uint8_t> payload; // [u32 count][ValueRef16...]
+        std::uint32_t payload_ofs = 0; // envelope offset of [u32 count][ValueRef16...]
         std::uint32_t count = 0;
+        std::uint32_t capacity = 0;    // reserved element slots
     };
     struct MapCtx {
-        std::vector<std::uint8_t> payload; // [u32 count][entries...]
+        std::size_t scratch_ofs = 0;   // start of [u32 count][entries...] in scratch_
         std::uint32_t count = 0;
-        std::optional<std::size_t> pending_value_patch; // offset within payload
+        std::optional<std::size_t> pending_value_patch; // offset within scratch_
     };
 
     std::vector<std::variant<ArrayCtx, MapCtx>> st_;
-    std::vector<std::uint8_t> env_;     // finalized envelope payloads + root ValueRef16
-    std::vector<std::uint8_t> arena_;   // arena bytes
+    OutputBytes out_;                   // header + envelope region + arena
+    std::vector<std::uint8_t> scratch_; // object entries of open maps (stack)
+    std::size_t env_end_ = HeaderSize;  // absolute end of used envelope bytes
+    std::size_t arena_base_ = 0;        // absolute arena start (16-aligned); 0 until first use
+    std::size_t layout_base_ = 0;       // where a new writer would have it (grown_base())
     std::optional<std::uint32_t> root_ofs_;
     std::uint32_t inline_threshold_ = InlineMax;
+    std::size_t env_reserve_ = EnvReserve; // initial envelope region size
+    std::size_t out_reserve_ = 0;       // largest message so far; sizes a fresh output
+    std::uint32_t index_threshold_ = DefaultObjectIndexThreshold;
+    bool wrote_index_ = false;
+    bool native_tensors_ = false;
+    bool wrote_tensor_ = false;
+    BufferPool* pool_ = nullptr;
+
+    struct BlobRef {
+        std::size_t at = 0;               // arena offset in out_ (referenced bytes excluded)
+        const std::uint8_t* data = nullptr;
+        std::size_t size = 0;
+    };
+    std::vector<BlobRef> refs_;
+    std::size_t ref_bytes_ = 0;         // arena bytes held by reference, not in out_
+    std::size_t ref_threshold_ = 0;     // 0: copy every blob
 
     RootSerializer() = default;
 
+    // Output vectors come from `pool`, and finish() returns ZBuffers that give
+    // them back; see BufferPool.
+    explicit RootSerializer(BufferPool& pool) : out_(pool.acquire()), pool_(&pool) {}
+
+    // Write into `dst` instead of an owned vector; see serialize_to(). Give
+    // it 16-byte aligned memory so arena payloads are aligned in place.
+    // finish_view() points into `dst`, and throws OutputOverflow if the
+    // message did not fit (it is finished in an owned vector to measure it).
+    // Blobs are always copied in this mode.
+    explicit RootSerializer(std::span<std::byte> dst)
+        : out_(std::span<std::uint8_t>(reinterpret_cast<std::uint8_t*>(dst.data()), dst.size())) {}
+    explicit RootSerializer(std::span<std::uint8_t> dst) : out_(dst) {}
+
+    RootSerializer(RootSerializer&&) = default;
+    RootSerializer& operator=(RootSerializer&&) = default;
+    ~RootSerializer() {
+        if (pool_) pool_->release(out_.release());
+    }
+
     void set_inline_string_threshold(std::uint32_t t) {
         if (t > InlineMax) throw SerializationError("zera: inline string threshold must be <= 12");
         inline_threshold_ = t;
     }
 
+    // Objects with at least `n` keys get a key hash index (O(1) lookup), and
+    // the output becomes version 2. 0 (the default) disables indexing, which
+    // keeps the output readable by v1-only readers; 16 is a good cutoff.
+    void set_object_index_threshold(std::uint32_t n) { index_threshold_ = n; }
+
+    // Write xtensor/Eigen values (anything through write_typed_array()) as
+    // native TYPED_ARRAY tensors, which makes the output version 3. Off by
+    // default: tensors then use the portable [dtype, shape, blob] array.
+    void set_native_tensors(bool on) { native_tensors_ = on; }
+
+    // Blobs (binary(), typed_array()) of at least `n` bytes are referenced by
+    // finish_segments() instead of copied. 0 (the default) copies everything.
+    void set_blob_reference_threshold(std::size_t n) { ref_threshold_ = n; }
+
+    // Pre-size the output: `env_bytes` of envelope in front of the arena and room
+    // for `arena_bytes` of arena payload. Only a hint; both grow as needed.
+    void reserve(std::size_t env_bytes, std::size_t arena_bytes = 0) {
+        if (arena_base_ == 0) env_reserve_ = std::max(env_reserve_, env_bytes);
+        else open_env(env_bytes > env_used() ? env_bytes - env_used() : 0);
+        out_.reserve(align_up(HeaderSize + env_reserve_, ArenaBaseAlign) + arena_bytes);
+    }
+
     ZBuffer finish() {
+        (void)finish_view();
+        ZBuffer result = pool_ ? pool_->wrap(out_.take()) : ZBuffer(out_.take());
+        if (pool_) out_ = OutputBytes(pool_->acquire());
+        reset();
+        return result;
+    }
+
+    // Finalize in place; the span is valid until the next reset().
+    std::span<const std::uint8_t> finish_view() {
+        finalize();
+        splice_refs();
+        if (out_.spilled()) {
+            const std::size_t need = out_.size();
+            const std::size_t have = out_.span_size();
+            reset();
+            throw OutputOverflow(need, have);
+        }
+        return std::span<const std::uint8_t>(out_.data(), out_.size());
+    }
+
+    // Finalize without copying referenced blobs: the output vector, cut around
+    // them, plus the blobs themselves. They must outlive the SegmentedBuffer.
+    SegmentedBuffer finish_segments() {
+        if (out_.bounded()) {
+            // Blobs were copied into the span, which is the only segment.
+            const auto bytes = finish_view();
+            reset();
+            return SegmentedBuffer(ZBuffer(), {Segment{bytes.data(), bytes.size()}});
+        }
+        finalize();
+        std::vector<Segment> segs;
+        segs.reserve(2 * refs_.size() + 1);
+        std::size_t from = 0;
+        for (const auto& ref : refs_) {
+            segs.push_back({out_.data() + from, arena_base_ + ref.at - from});
+            segs.push_back({ref.data, ref.size});
+            from = arena_base_ + ref.at;
+        }
+        segs.push_back({out_.data() + from, out_.size() - from});
+
+        ZBuffer owned = pool_ ? pool_->wrap(out_.take()) : ZBuffer(out_.take());
+        if (pool_) out_ = OutputBytes(pool_->acquire());
+        reset();
+        return SegmentedBuffer(std::move(owned), std::move(segs));
+    }
+
+    // Discard the current message, keeping the output, scratch and stack
+    // capacity. The envelope region of the next message is sized from the
+    // largest envelope seen so far, and a fresh output vector (after finish())
+    // from the largest message, so steady-state messages neither reallocate
+    // nor slide the arena while they are written. Only the working layout
+    // changes: finalize() places the arena as a new writer would.
+    void reset() {
+        env_reserve_ = std::max(env_reserve_, env_used());
+        out_.clear();
+        scratch_.clear();
+        st_.clear();
+        env_end_ = HeaderSize;
+        arena_base_ = 0;
+        layout_base_ = 0;
+        root_ofs_.reset();
+        wrote_index_ = false;
+        wrote_tensor_ = false;
+        refs_.clear();
+        ref_bytes_ = 0;
+    }
+
+    // Discard the current message and write the next ones into `dst`.
+    void reset(std::span<std::byte> dst) {
+        reset();
+        out_.bind(std::span<std::uint8_t>(reinterpret_cast<std::uint8_t*>(dst.data()), dst.size()));
+    }
+
+    void finalize() {
         if (!st_.empty()) throw SerializationError("zera: finish() called with unterminated container");
         if (!root_ofs_) {
             // Default root = null
@@ -598,39 +1093,33 @@ struct RootSerializer {
             write_root_vr(vr);
         }
 
-        if (env_.size() > std::numeric_limits<std::uint32_t>::max()) throw SerializationError("zera: envelope too large");
-        if (arena_.size() > std::numeric_limits<std::uint32_t>::max()) throw SerializationError("zera: arena too large");
-
-        const std::uint32_t env_size = static_cast<std::uint32_t>(env_.size());
-        const std::size_t arena_ofs = align_up(HeaderSize + std::size_t(env_size), ArenaBaseAlign);
-        if (arena_ofs > std::numeric_limits<std::uint32_t>::max())
+        const std::size_t env_size = env_used();
+        if (env_size > std::numeric_limits<std::uint32_t>::max()) throw SerializationError("zera: envelope too large");
+        const std::size_t arena_len = out_.size() - arena_base_;
+        if (arena_len + ref_bytes_ > std::numeric_limits<std::uint32_t>::max()) throw SerializationError("zera: arena too large");
+
+        // Place the arena where a new writer would have it, so the bytes do not
+        // depend on the envelopes of earlier messages. Close the gap between
+        // envelope and arena, unless the arena is so large relative to the
+        // slack that moving it would cost more than the padding saves (slack is
+        // zero-filled, which the layout permits). Referenced blobs count toward
+        // the arena's size, so finish_segments() lays out the same bytes as
+        // finish().
+        // A span is always closed up: its slack is worth more than the move.
+        const std::size_t tight_base = align_up(env_end_, ArenaBaseAlign);
+        std::size_t base = out_.bounded() ? tight_base : layout_base_;
+        if (tight_base < base && (base - tight_base) * 64 >= arena_len + ref_bytes_) base = tight_base;
+        move_arena(base);
+        if (arena_base_ > std::numeric_limits<std::uint32_t>::max())
             throw SerializationError("zera: arena_ofs overflow");
 
-        std::vector<std::uint8_t> out;
-        out.resize(arena_ofs + arena_.size(), 0);
-
-        auto write_header32 = [&](std::size_t at, std::uint32_t v) {
-            out.at(at + 0) = std::uint8_t(v & 0xff);
-            out.at(at + 1) = std::uint8_t((v >> 8) & 0xff);
-            out.at(at + 2) = std::uint8_t((v >> 16) & 0xff);
-            out.at(at + 3) = std::uint8_t((v >> 24) & 0xff);
-        };
-        auto write_header16 = [&](std::size_t at, std::uint16_t v) {
-            out.at(at + 0) = std::uint8_t(v & 0xff);
-            out.at(at + 1) = std::uint8_t((v >> 8) & 0xff);
-        };
-
-        write_header32(0, Magic);
-        write_header16(4, Version);
-        write_header16(6, 1); // flags: bit0 little-endian
-        write_header32(8, *root_ofs_);
-        write_header32(12, env_size);
-        write_header32(16, static_cast<std::uint32_t>(arena_ofs));
-
-        std::memcpy(out.data() + HeaderSize, env_.data(), env_.size());
-        std::memcpy(out.data() + arena_ofs, arena_.data(), arena_.size());
-
-        return ZBuffer(std::move(out));
+        write_u32_le_at(out_, 0, Magic);
+        write_u16_le_at(out_, 4, wrote_tensor_ ? VersionTensor : wrote_index_ ? VersionIndexed : Version);
+        write_u16_le_at(out_, 6, 1); // flags: bit0 little-endian
+        write_u32_le_at(out_, 8, *root_ofs_);
+        write_u32_le_at(out_, 12, static_cast<std::uint32_t>(env_size));
+        write_u32_le_at(out_, 16, static_cast<std::uint32_t>(arena_base_));
+        out_reserve_ = std::max(out_reserve_, out_.size());
     }
 
     // ---- streaming encoding helpers (called by Serializer) ----
@@ -656,24 +1145,132 @@ struct RootSerializer {
         return out;
     }
 
-    std::uint32_t append_env_payload(std::span<const std::uint8_t> bytes) {
-        const std::size_t ofs = env_.size();
-        if (ofs > std::numeric_limits<std::uint32_t>::max()) throw SerializationError("zera: envelope offset overflow");
-        env_.insert(env_.end(), bytes.begin(), bytes.end());
+    std::size_t env_used() const { return env_end_ - HeaderSize; }
+    std::uint8_t* env_at(std::uint32_t ofs) { return out_.data() + HeaderSize + ofs; }
+
+    // Make room for `need` more envelope bytes in front of the arena.
+    void ensure_env(std::size_t need) {
+        layout_base_ = grown_base(layout_base_, env_used(), need);
+        open_env(need);
+    }
+
+    // ensure_env() for the working layout only, which may differ from a new
+    // writer's (see reset()).
+    void open_env(std::size_t need) {
+        if (arena_base_ == 0) {
+            // First use: lay out [Header][envelope region][arena]. The region
+            // starts small and follows the envelopes seen by reset(); the
+            // output has room for a small arena, or for the largest message
+            // so far. A span gets a region of at most half of it, or just
+            // what is needed.
+            arena_base_ = align_up(HeaderSize + std::max(env_reserve_, need), ArenaBaseAlign);
+            if (out_.bounded()) {
+                const std::size_t half = out_.capacity() / 2;
+                if (arena_base_ > half) arena_base_ = align_up(std::max<std::size_t>(HeaderSize + need, half), ArenaBaseAlign);
+                if (arena_base_ > out_.capacity()) arena_base_ = align_up(HeaderSize + need, ArenaBaseAlign);
+            }
+            out_.reserve(std::max(arena_base_ + EnvReserve / 2, out_reserve_));
+            out_.resize(arena_base_);
+            st_.reserve(16);
+            scratch_.reserve(512);
+            return;
+        }
+        if (env_end_ + need <= arena_base_) return;
+
+        const std::size_t region = arena_base_ - HeaderSize;
+        const std::size_t arena_len = out_.size() - arena_base_;
+        std::size_t new_base = align_up(HeaderSize + std::max(region * 2, env_used() + need), ArenaBaseAlign);
+        if (out_.bounded() && new_base + arena_len > out_.capacity())
+            new_base = align_up(env_end_ + need, ArenaBaseAlign); // as little as fits
+        out_.reserve(new_base + arena_len + arena_len / 2);
+        out_.resize(new_base + arena_len);
+        if (arena_len) std::memmove(out_.data() + new_base, out_.data() + arena_base_, arena_len);
+        std::memset(out_.data() + arena_base_, 0, new_base - arena_base_);
+        arena_base_ = new_base;
+    }
+
+    // Reserve `len` zeroed envelope bytes; returns their envelope offset.
+    std::uint32_t env_alloc(std::size_t len) {
+        ensure_env(len);
+        const std::size_t ofs = env_used();
+        if (ofs + len > std::numeric_limits<std::uint32_t>::max()) throw SerializationError("zera: envelope offset overflow");
+        env_end_ += len;
         return static_cast<std::uint32_t>(ofs);
     }
 
-    std::uint32_t arena_alloc(std::size_t len, std::size_t align) {
+    std::uint32_t append_env_payload(std::span<const std::uint8_t> bytes) {
+        const std::uint32_t ofs = env_alloc(bytes.size());
+        if (!bytes.empty()) std::memcpy(env_at(ofs), bytes.data(), bytes.size());
+        return ofs;
+    }
+
+    // Append `bytes` to the arena at the requested alignment; returns the arena offset.
+    // With `by_reference`, only the offset is reserved and `bytes` is recorded
+    // as a segment (see finish_segments()).
+    std::uint32_t arena_append(std::span<const std::uint8_t> bytes, std::size_t align, bool by_reference = false) {
+        if (arena_base_ == 0) ensure_env(0);
         const std::size_t want_align = std::max<std::size_t>(1, align);
-        const std::size_t aligned = align_up(arena_.size(), want_align);
-        if (aligned > arena_.size()) arena_.resize(aligned, 0);
-        const std::size_t ofs = arena_.size();
-        arena_.resize(ofs + len, 0);
+        const std::size_t ofs = align_up(out_.size() - arena_base_ + ref_bytes_, want_align);
         if (ofs > std::numeric_limits<std::uint32_t>::max()) throw SerializationError("zera: arena offset overflow");
-        if (len > std::numeric_limits<std::uint32_t>::max()) throw SerializationError("zera: arena length overflow");
+        if (bytes.size() > std::numeric_limits<std::uint32_t>::max()) throw SerializationError("zera: arena length overflow");
+        if (out_.bounded() && arena_base_ + ofs + bytes.size() > out_.capacity()) close_envelope_slack();
+        // Envelope growth slides the arena. Before it gets large, widen a
+        // small region (finalize() keeps that much slack in front of it
+        // anyway), and move the arena to its final place while that is cheap.
+        if (!out_.bounded() && ofs + bytes.size() >= LargeArena) {
+            if (env_used() < EnvReserveLarge) ensure_env(EnvReserveLarge - env_used());
+            move_arena(layout_base_);
+        }
+        out_.resize(arena_base_ + ofs - ref_bytes_);
+        if (by_reference) {
+            refs_.push_back({ofs - ref_bytes_, bytes.data(), bytes.size()});
+            ref_bytes_ += bytes.size();
+        } else {
+            out_.append(bytes.data(), bytes.size());
+        }
         return static_cast<std::uint32_t>(ofs);
     }
 
+    bool blob_by_reference(std::size_t size) const {
+        return ref_threshold_ != 0 && size >= ref_threshold_ && !out_.bounded();
+    }
+
+    // A span is running out: slide the arena down onto the end of the
+    // envelope.
+    void close_envelope_slack() {
+        const std::size_t tight_base = align_up(env_end_, ArenaBaseAlign);
+        if (tight_base < arena_base_) move_arena(tight_base);
+    }
+
+    // Slide the arena to start at `base`, at or past the envelope's end (arena
+    // offsets are relative, so nothing is re-patched). Slack stays zeroed.
+    void move_arena(std::size_t base) {
+        if (base == arena_base_) return;
+        const std::size_t arena_len = out_.size() - arena_base_;
+        if (base > arena_base_) out_.resize(base + arena_len);
+        if (arena_len) std::memmove(out_.data() + base, out_.data() + arena_base_, arena_len);
+        if (base > arena_base_) std::memset(out_.data() + arena_base_, 0, base - arena_base_);
+        else out_.resize(base + arena_len);
+        arena_base_ = base;
+    }
+
+    // Copy referenced blobs into out_, making the message contiguous.
+    void splice_refs() {
+        if (refs_.empty()) return;
+        std::size_t end = out_.size();
+        std::size_t shift = ref_bytes_;
+        out_.resize(out_.size() + ref_bytes_);
+        for (auto it = refs_.rbegin(); it != refs_.rend(); ++it) {
+            const std::size_t at = arena_base_ + it->at;
+            if (end > at) std::memmove(out_.data() + at + shift, out_.data() + at, end - at);
+            shift -= it->size;
+            std::memcpy(out_.data() + at + shift, it->data, it->size);
+            end = at;
+        }
+        refs_.clear();
+        ref_bytes_ = 0;
+    }
+
     std::uint32_t emit_shape_rank1(std::uint64_t dim0) {
         std::array<std::uint8_t, 12> tmp{};
         tmp[0] = 1; tmp[1] = 0; tmp[2] = 0; tmp[3] = 0; // rank u32
@@ -681,6 +1278,16 @@ struct RootSerializer {
         return append_env_payload(tmp);
     }
 
+    std::uint32_t emit_shape(std::span<const std::uint64_t> dims) {
+        const std::uint32_t ofs = env_alloc(4 + 8 * dims.size());
+        std::uint8_t* p = env_at(ofs);
+        const auto rank = static_cast<std::uint32_t>(dims.size());
+        for (int i = 0; i < 4; ++i) p[i] = std::uint8_t((rank >> (8 * i)) & 0xff);
+        for (std::size_t d = 0; d < dims.size(); ++d)
+            for (int i = 0; i < 8; ++i) p[4 + 8 * d + i] = std::uint8_t((dims[d] >> (8 * i)) & 0xff);
+        return ofs;
+    }
+
     void write_root_vr(const std::array<std::uint8_t, 16>& vr) {
         if (root_ofs_) throw SerializationError("zera: multiple root values");
         root_ofs_ = append_env_payload(vr);
@@ -693,7 +1300,8 @@ struct RootSerializer {
         }
         auto& top = st_.back();
         if (auto* a = std::get_if<ArrayCtx>(&top)) {
-            a->payload.insert(a->payload.end(), vr.begin(), vr.end());
+            if (a->count == a->capacity) grow_array(*a);
+            std::memcpy(env_at(a->payload_ofs + 4 + 16 * a->count), vr.data(), 16);
             ++a->count;
             return;
         }
@@ -701,10 +1309,49 @@ struct RootSerializer {
         if (!m) throw SerializationError("zera: internal container stack error");
         if (!m->pending_value_patch) throw SerializationError("zera: map value without key()");
         const std::size_t at = *m->pending_value_patch;
-        if (at + 16 > m->payload.size()) throw SerializationError("zera: internal map patch out of bounds");
-        std::memcpy(m->payload.data() + at, vr.data(), 16);
+        if (at + 16 > scratch_.size()) throw SerializationError("zera: internal map patch out of bounds");
+        std::memcpy(scratch_.data() + at, vr.data(), 16);
         m->pending_value_patch.reset();
     }
+
+    // Build the key hash index for an object payload already in the envelope.
+    // Returns the envelope offset of the index.
+    std::uint32_t emit_object_index(std::uint32_t payload_ofs, std::uint32_t count) {
+        std::uint32_t slots = 4;
+        while (slots < 2 * std::size_t(count)) slots *= 2; // load factor <= 1/2
+        const std::uint32_t idx_ofs = env_alloc(4 + 8 * std::size_t(slots));
+        std::uint8_t* idx = env_at(idx_ofs);
+        write_u32_le_at(out_, HeaderSize + idx_ofs, slots);
+        std::memset(idx + 4, 0xff, 8 * std::size_t(slots));
+
+        const std::uint32_t mask = slots - 1;
+        std::uint32_t ofs = payload_ofs + 4;
+        for (std::uint32_t n = 0; n < count; ++n) {
+            const std::uint8_t* e = env_at(ofs);
+            const std::uint16_t key_len = read_u16_le(e);
+            const std::uint32_t h = key_hash(std::string_view(reinterpret_cast<const char*>(e + 4), key_len));
+            std::uint32_t i = h & mask;
+            while (read_u32_le(idx + 4 + 8 * std::size_t(i) + 4) != IndexEmptySlot) i = (i + 1) & mask;
+            write_u32_le_at(out_, HeaderSize + idx_ofs + 4 + 8 * std::size_t(i), h);
+            write_u32_le_at(out_, HeaderSize + idx_ofs + 4 + 8 * std::size_t(i) + 4, ofs);
+            ofs += 4 + key_len + 16;
+        }
+        wrote_index_ = true;
+        return idx_ofs;
+    }
+
+    // The begin_array() hint was too small: move the slots to a larger payload.
+    // The old payload is left behind as zeroed, unreferenced envelope bytes.
+    void grow_array(ArrayCtx& a) {
+        const std::size_t new_cap = std::max<std::size_t>(4, std::size_t(a.capacity) * 2);
+        if (new_cap > (std::numeric_limits<std::uint32_t>::max() - 4) / 16) throw SerializationError("zera: array too large");
+        const std::uint32_t new_ofs = env_alloc(4 + 16 * new_cap);
+        const std::size_t used = 4 + 16 * std::size_t(a.count);
+        std::memcpy(env_at(new_ofs), env_at(a.payload_ofs), used);
+        std::memset(env_at(a.payload_ofs), 0, used);
+        a.payload_ofs = new_ofs;
+        a.capacity = static_cast<std::uint32_t>(new_cap);
+    }
 };
 
 struct Serializer {
@@ -747,71 +1394,317 @@ struct Serializer {
             return;
         }
         if (sv.size() > std::numeric_limits<std::uint32_t>::max()) throw SerializationError("zera: string too large");
-        const auto ofs = r->arena_alloc(sv.size(), 1);
-        if (!sv.empty()) std::memcpy(r->arena_.data() + ofs, sv.data(), sv.size());
+        const auto ofs = r->arena_append(
+            std::span<const std::uint8_t>(reinterpret_cast<const std::uint8_t*>(sv.data()), sv.size()), 1);
         r->deliver_vr(RootSerializer::make_vr(Tag::String, 0, 0, ofs, static_cast<std::uint32_t>(sv.size()), 0));
     }
     void binary(std::span<const std::byte> b) {
         if (b.size() > std::numeric_limits<std::uint32_t>::max()) throw SerializationError("zera: blob too large");
         const std::uint32_t byte_len = static_cast<std::uint32_t>(b.size());
-        const std::uint32_t arena_ofs = r->arena_alloc(byte_len, ArenaBaseAlign);
-        if (byte_len) std::memcpy(r->arena_.data() + arena_ofs, b.data(), byte_len);
+        const std::uint32_t arena_ofs = r->arena_append(
+            std::span<const std::uint8_t>(reinterpret_cast<const std::uint8_t*>(b.data()), b.size()), ArenaBaseAlign,
+            r->blob_by_reference(b.size()));
         const std::uint32_t shape_ofs = r->emit_shape_rank1(byte_len);
         r->deliver_vr(RootSerializer::make_vr(
             Tag::TypedArray, 0, static_cast<std::uint16_t>(DType::U8),
             arena_ofs, byte_len, shape_ofs));
     }
 
+    // Native tensor: one TYPED_ARRAY ValueRef, a rank-N shape and a 16-aligned
+    // arena payload. `dtype` is a zerialize tensor dtype code. Declined unless
+    // the root serializer opted in with set_native_tensors().
+    bool supports_typed_array(int dtype) const {
+        return r->native_tensors_ && dtype_from_tensor_code(dtype).has_value();
+    }
+
+    void typed_array(int dtype, std::span<const std::uint64_t> shape, std::span<const std::byte> bytes) {
+        const auto dt = dtype_from_tensor_code(dtype);
+        if (!dt) throw SerializationError("zera: unsupported typed array dtype");
+        if (shape.size() > RankMax) throw SerializationError("zera: typed array rank too large");
+        if (bytes.size() > std::numeric_limits<std::uint32_t>::max()) throw SerializationError("zera: typed array too large");
+        const auto count = shape_element_count(shape);
+        if (!count || *count * dtype_size(*dt) != bytes.size()) throw SerializationError("zera: typed array shape does not match byte length");
+
+        const std::uint32_t arena_ofs = r->arena_append(
+            std::span<const std::uint8_t>(reinterpret_cast<const std::uint8_t*>(bytes.data()), bytes.size()), ArenaBaseAlign,
+            r->blob_by_reference(bytes.size()));
+        const std::uint32_t shape_ofs = r->emit_shape(shape);
+        r->wrote_tensor_ = true;
+        r->deliver_vr(RootSerializer::make_vr(
+            Tag::TypedArray, TensorFlag, static_cast<std::uint16_t>(*dt),
+            arena_ofs, static_cast<std::uint32_t>(bytes.size()), shape_ofs));
+    }
+
     void begin_array(std::size_t reserve) {
+        if (reserve > (std::numeric_limits<std::uint32_t>::max() - 4) / 16) throw SerializationError("zera: array too large");
         RootSerializer::ArrayCtx ctx{};
-        ctx.payload.reserve(4 + reserve * 16);
-        append_u32_le(ctx.payload, 0); // count placeholder
-        r->st_.push_back(std::move(ctx));
+        ctx.payload_ofs = r->env_alloc(4 + reserve * 16); // count patched at end_array
+        ctx.capacity = static_cast<std::uint32_t>(reserve);
+        r->st_.push_back(ctx);
     }
     void end_array() {
         if (r->st_.empty() || !std::holds_alternative<RootSerializer::ArrayCtx>(r->st_.back()))
             throw SerializationError("zera: end_array outside array");
-        auto ctx = std::move(std::get<RootSerializer::ArrayCtx>(r->st_.back()));
+        const auto ctx = std::get<RootSerializer::ArrayCtx>(r->st_.back());
         r->st_.pop_back();
-        if (ctx.count > std::numeric_limits<std::uint32_t>::max()) throw SerializationError("zera: array too large");
-        write_u32_le_at(ctx.payload, 0, ctx.count);
-        const std::uint32_t payload_ofs = r->append_env_payload(ctx.payload);
-        r->deliver_vr(RootSerializer::make_vr(Tag::Array, 0, 0, payload_ofs, 0, 0));
+        // Unused reserved slots stay zeroed after the elements.
+        write_u32_le_at(r->out_, HeaderSize + ctx.payload_ofs, ctx.count);
+        r->deliver_vr(RootSerializer::make_vr(Tag::Array, 0, 0, ctx.payload_ofs, 0, 0));
     }
 
     void begin_map(std::size_t reserve) {
+        if (r->arena_base_ == 0) r->ensure_env(0);
         RootSerializer::MapCtx ctx{};
-        ctx.payload.reserve(4 + reserve * (4 + 8 + 16));
-        append_u32_le(ctx.payload, 0); // count placeholder
-        r->st_.push_back(std::move(ctx));
+        ctx.scratch_ofs = r->scratch_.size();
+        r->scratch_.reserve(ctx.scratch_ofs + 4 + reserve * (4 + 8 + 16));
+        append_u32_le(r->scratch_, 0); // count placeholder
+        r->st_.push_back(ctx);
     }
     void end_map() {
         if (r->st_.empty() || !std::holds_alternative<RootSerializer::MapCtx>(r->st_.back()))
             throw SerializationError("zera: end_map outside map");
-        auto ctx = std::move(std::get<RootSerializer::MapCtx>(r->st_.back()));
+        const auto ctx = std::get<RootSerializer::MapCtx>(r->st_.back());
         if (ctx.pending_value_patch) throw SerializationError("zera: end_map with dangling key()");
         r->st_.pop_back();
-        write_u32_le_at(ctx.payload, 0, ctx.count);
-        const std::uint32_t payload_ofs = r->append_env_payload(ctx.payload);
+        write_u32_le_at(r->scratch_, ctx.scratch_ofs, ctx.count);
+        const std::uint32_t payload_ofs = r->append_env_payload(
+            std::span<const std::uint8_t>(r->scratch_).subspan(ctx.scratch_ofs));
+        r->scratch_.resize(ctx.scratch_ofs);
+        if (r->index_threshold_ != 0 && ctx.count >= r->index_threshold_) {
+            const std::uint32_t idx_ofs = r->emit_object_index(payload_ofs, ctx.count);
+            r->deliver_vr(RootSerializer::make_vr(Tag::Object, ObjectIndexedFlag, 0, payload_ofs, idx_ofs, 0));
+            return;
+        }
         r->deliver_vr(RootSerializer::make_vr(Tag::Object, 0, 0, payload_ofs, 0, 0));
     }
 
     void key(std::string_view k) {
+        auto& ctx = map_for_key();
+        if (k.size() > std::numeric_limits<std::uint16_t>::max()) throw SerializationError("zera: key too long");
+        auto& sc = r->scratch_;
+        append_u16_le(sc, static_cast<std::uint16_t>(k.size()));
+        append_u16_le(sc, 0);
+        sc.insert(sc.end(), k.begin(), k.end());
+        reserve_value(ctx);
+    }
+
+    // Pre-encoded compile-time key: one copy of [u16 len][u16 0][bytes];
+    // see RawKeyWriter.
+    template<fixed_string K>
+    void key_raw() {
+        auto& ctx = map_for_key();
+        constexpr auto& enc = encoded_key<K>;
+        r->scratch_.insert(r->scratch_.end(), enc.begin(), enc.end());
+        reserve_value(ctx);
+    }
+
+private:
+    RootSerializer::MapCtx& map_for_key() {
         if (r->st_.empty() || !std::holds_alternative<RootSerializer::MapCtx>(r->st_.back()))
             throw SerializationError("zera: key() outside map");
         auto& ctx = std::get<RootSerializer::MapCtx>(r->st_.back());
         if (ctx.pending_value_patch) throw SerializationError("zera: key() called twice without value");
-        if (k.size() > std::numeric_limits<std::uint16_t>::max()) throw SerializationError("zera: key too long");
-        append_u16_le(ctx.payload, static_cast<std::uint16_t>(k.size()));
-        append_u16_le(ctx.payload, 0);
-        ctx.payload.insert(ctx.payload.end(), k.begin(), k.end());
-        const std::size_t patch = ctx.payload.size();
-        ctx.payload.resize(ctx.payload.size() + 16, 0);
+        return ctx;
+    }
+
+    // Leave room for the entry's ValueRef, patched when the value arrives.
+    void reserve_value(RootSerializer::MapCtx& ctx) {
+        auto& sc = r->scratch_;
+        const std::size_t patch = sc.size();
+        sc.resize(sc.size() + 16, 0);
         ctx.pending_value_patch = patch;
         ++ctx.count;
     }
 };
 
+// Counts the bytes a RootSerializer would produce for the same calls,
+// writing nothing; see measure(). It follows the writer's layout: ValueRefs,
+// array payloads (including those abandoned by grow_array()), object entries
+// and indexes, and shapes in the envelope; long strings and blobs in the
+// arena, blobs 16-aligned. It also tracks where a new writer places the
+// arena, so size() is what finish() returns, including the envelope slack
+// finalize() keeps in front of a large arena. span_size() is the tight
+// layout serialize_to() writes. Nesting deeper than 32 falls back to an
+// allocated stack.
+class SizeCounter {
+public:
+    void set_inline_string_threshold(std::uint32_t t) {
+        if (t > InlineMax) throw SerializationError("zera: inline string threshold must be <= 12");
+        inline_threshold_ = t;
+    }
+    void set_object_index_threshold(std::uint32_t n) { index_threshold_ = n; }
+    void set_native_tensors(bool on) { native_tensors_ = on; }
+
+    // Message size so far, as finish() lays it out: the arena stays where
+    // the envelope region ended unless finalize() would move it down. A
+    // message with no value has the null root.
+    std::size_t size() const {
+        std::size_t base = base_;
+        std::size_t env = env_;
+        if (!root_) {
+            base = grown_base(base, env, 16);
+            env += 16;
+        }
+        const std::size_t tight = align_up(HeaderSize + env, ArenaBaseAlign);
+        if (tight < base && (base - tight) * 64 >= arena_) base = tight;
+        return base + arena_;
+    }
+
+    // Message size so far as serialize_to() writes it: header, envelope, then
+    // the arena at the next 16-byte boundary.
+    std::size_t span_size() const {
+        const std::size_t env = env_ + (root_ ? 0 : 16);
+        return align_up(HeaderSize + env, ArenaBaseAlign) + arena_;
+    }
+
+    void reset() {
+        env_ = arena_ = depth_ = base_ = 0;
+        deep_.clear();
+        root_ = false;
+    }
+
+    void null()                  { value(); }
+    void boolean(bool)           { value(); }
+    void int64(std::int64_t)     { value(); }
+    void uint64(std::uint64_t)   { value(); }
+    void double_(double)         { value(); }
+
+    void string(std::string_view sv) {
+        if (sv.size() > std::min<std::size_t>(inline_threshold_, InlineMax)) arena(sv.size(), 1);
+        value();
+    }
+    void binary(std::span<const std::byte> b) {
+        arena(b.size(), ArenaBaseAlign);
+        env(12); // rank-1 shape
+        value();
+    }
+
+    bool supports_typed_array(int dtype) const {
+        return native_tensors_ && dtype_from_tensor_code(dtype).has_value();
+    }
+    void typed_array(int, std::span<const std::uint64_t> shape, std::span<const std::byte> bytes) {
+        arena(bytes.size(), ArenaBaseAlign);
+        env(4 + 8 * shape.size());
+        value();
+    }
+
+    void begin_array(std::size_t reserve) {
+        env(4 + 16 * reserve);
+        push({false, 0, static_cast<std::uint32_t>(reserve), 0});
+    }
+    void end_array() {
+        pop();
+        value();
+    }
+
+    void begin_map(std::size_t) {
+        if (base_ == 0) base_ = grown_base(0, env_, 0);
+        push({true, 0, 0, 4});
+    }
+    void end_map() {
+        const Frame f = pop();
+        env(f.bytes);
+        if (index_threshold_ != 0 && f.count >= index_threshold_) {
+            std::size_t slots = 4;
+            while (slots < 2 * std::size_t(f.count)) slots *= 2;
+            env(4 + 8 * slots);
+        }
+        value();
+    }
+
+    void key(std::string_view k) { entry(k.size()); }
+
+    template<fixed_string K>
+    void key_raw() { entry(decltype(K)::size()); }
+
+private:
+    struct Frame {                  // left uninitialized until pushed
+        bool map;
+        std::uint32_t count;
+        std::uint32_t capacity;     // array slots reserved so far
+        std::size_t bytes;          // object payload: [u32 count][entries...]
+    };
+
+    // A value lands in its parent: the root ValueRef, an array slot (growing
+    // the payload as grow_array() does), or an object entry already counted.
+    void value() {
+        if (depth_ == 0) {
+            env(16);
+            root_ = true;
+            return;
+        }
+        Frame& f = top();
+        if (f.map) return;
+        if (f.count == f.capacity) {
+            f.capacity = std::max<std::uint32_t>(4, f.capacity * 2);
+            env(4 + 16 * std::size_t(f.capacity));
+        }
+        ++f.count;
+    }
+
+    void entry(std::size_t key_len) {
+        if (depth_ == 0 || !top().map) throw SerializationError("zera: key() outside map");
+        Frame& f = top();
+        ++f.count;
+        f.bytes += 4 + key_len + 16;
+    }
+
+    void arena(std::size_t n, std::size_t align) {
+        if (base_ == 0) base_ = grown_base(0, env_, 0);
+        arena_ = align_up(arena_, align) + n;
+        if (arena_ >= LargeArena && env_ < EnvReserveLarge)
+            base_ = grown_base(base_, env_, EnvReserveLarge - env_);
+    }
+
+    // `n` more envelope bytes, placed as RootSerializer::ensure_env() does.
+    void env(std::size_t n) {
+        base_ = grown_base(base_, env_, n);
+        env_ += n;
+    }
+
+    // Frames past the fixed stack spill to deep_, so the top is deep_'s
+    // last frame whenever it has one.
+    Frame& top() { return deep_.empty() ? frames_[depth_ - 1] : deep_.back(); }
+    void push(const Frame& f) {
+        if (depth_ < frames_.size()) frames_[depth_] = f;
+        else deep_.push_back(f);
+        ++depth_;
+    }
+    Frame pop() {
+        if (!deep_.empty()) {
+            const Frame f = deep_.back();
+            deep_.pop_back();
+            --depth_;
+            return f;
+        }
+        if (depth_ == 0) throw SerializationError("zera: end of container without a begin");
+        return frames_[--depth_];
+    }
+
+    std::size_t env_ = 0;
+    std::size_t arena_ = 0;
+    std::size_t base_ = 0;          // arena start in a new writer's output; 0 until first use
+    std::size_t depth_ = 0;
+    std::array<Frame, 32> frames_;
+    std::vector<Frame> deep_;
+    bool root_ = false;
+    std::uint32_t inline_threshold_ = InlineMax;
+    std::uint32_t index_threshold_ = DefaultObjectIndexThreshold;
+    bool native_tensors_ = false;
+};
+
+// ---- in-place scalar updates (see PatchableProtocol) ----
+// A scalar is its ValueRef: the tag stays, the payload is rewritten.
+inline std::uint8_t* patch_slot(std::span<std::uint8_t> slot, Tag t) {
+    if (slot.size() != 16 || Tag(slot[0]) != t) throw SerializationError("zera: patch slot is not the expected scalar");
+    return slot.data();
+}
+
+inline void patch_payload64(std::span<std::uint8_t> slot, Tag t, std::uint64_t bits) {
+    std::uint8_t* vr = patch_slot(slot, t);
+    for (int i = 0; i < 8; ++i) vr[4 + i] = std::uint8_t((bits >> (8 * i)) & 0xff);
+}
+
 } // namespace zera
 
 struct Zera {
@@ -819,6 +1712,27 @@ struct Zera {
     using Deserializer   = zera::ZeraDeserializer;
     using RootSerializer = zera::RootSerializer;
     using Serializer     = zera::Serializer;
+    using SpanRootSerializer = zera::RootSerializer;
+    using SpanSerializer     = zera::Serializer;
+    using SizeCounter        = zera::SizeCounter;
+
+    // Overwrite a scalar in place; see PatchableProtocol.
+    static void patch_bool(std::span<std::uint8_t> slot, bool v) {
+        std::uint8_t* vr = zera::patch_slot(slot, zera::Tag::Bool);
+        vr[2] = v ? 1 : 0;
+        vr[3] = 0;
+    }
+    static void patch_int64(std::span<std::uint8_t> slot, std::int64_t v) {
+        zera::patch_payload64(slot, zera::Tag::I64, static_cast<std::uint64_t>(v));
+    }
+    static void patch_uint64(std::span<std::uint8_t> slot, std::uint64_t v) {
+        zera::patch_payload64(slot, zera::Tag::U64, v);
+    }
+    static void patch_double(std::span<std::uint8_t> slot, double v) {
+        std::uint64_t bits = 0;
+        std::memcpy(&bits, &v, sizeof(bits));
+        zera::patch_payload64(slot, zera::Tag::F64, bits);
+    }
 };
 
 } // namespace zerialize
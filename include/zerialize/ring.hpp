@@ -0,0 +1,268 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <zerialize/concepts.hpp>
+#include <zerialize/errors.hpp>
+#include <zerialize/serialize.hpp>
+
+namespace zerialize {
+namespace ring {
+
+/*
+ * MPSC byte ring
+ * --------------
+ * A fixed block of memory that many producer threads write messages into and
+ * one consumer thread reads them out of, without locks and without copying.
+ * Writing a message has two phases:
+ *
+ *   1. reserve(n) claims n bytes with one compare-and-swap on the ring's
+ *      head. Producers never wait for each other beyond that.
+ *   2. The producer encodes into its reservation, then commit()s the bytes
+ *      it used (or abandon()s the reservation).
+ *
+ * The size for step 1 comes from measure<P>() (exact), or is an upper bound
+ * used with a SpanRootSerializer, committing finish_view().size(). write<P>()
+ * does the measured version in one call.
+ *
+ *   ring::ByteRing q(1 << 20);
+ *   // any number of producer threads:
+ *   ring::write<MsgPack>(q, zmap<"seq", "value">(seq, value));
+ *   // the consumer thread:
+ *   ring::read<MsgPack>(q, [](const MsgPack::Deserializer& msg) { ... });
+ *
+ * The consumer sees messages in reservation order, as P::Deserializer views
+ * straight into the ring. A view is valid only during the callback; the
+ * space is handed back to producers when poll() or read() returns. A
+ * reservation that is not yet committed holds back the messages behind it.
+ *
+ * Layout: frames start at multiples of FrameAlign (16). Each frame is a
+ * 16-byte header, { u32 state, u32 frame bytes, u32 message bytes, u32 0 },
+ * followed by the message, so Zera arenas are aligned in place. A frame that
+ * would run past the end of the ring is preceded by a padding frame and
+ * starts again at the beginning. The consumer zeroes what it has read: a
+ * zero state is a frame not committed yet.
+ */
+
+inline constexpr std::size_t FrameAlign = 16;
+inline constexpr std::size_t FrameHeaderSize = 16;
+
+class ByteRing {
+public:
+    // A producer's claim: write up to bytes.size() bytes, then commit().
+    struct Reservation {
+        std::span<std::byte> bytes;
+        std::uint64_t pos = 0;      // ring position of the frame header
+    };
+
+    // `capacity` must be a power of two from 64 to 2^31.
+    explicit ByteRing(std::size_t capacity)
+        : cap_(capacity), mask_(capacity - 1) {
+        if (capacity < 64 || capacity > (std::size_t(1) << 31) || (capacity & (capacity - 1)) != 0) {
+            throw SerializationError("ring: capacity " + std::to_string(capacity) +
+                                     " is not a power of two in [64, 2^31]");
+        }
+        data_.reset(static_cast<std::byte*>(::operator new(cap_, std::align_val_t{CacheLine})));
+        std::memset(data_.get(), 0, cap_);
+    }
+
+    ByteRing(const ByteRing&) = delete;
+    ByteRing& operator=(const ByteRing&) = delete;
+
+    [[nodiscard]] std::size_t capacity() const noexcept { return cap_; }
+
+    // The largest message a reservation can hold.
+    [[nodiscard]] std::size_t max_message() const noexcept { return cap_ - FrameHeaderSize; }
+
+    // ---- producers (any thread) ----
+
+    // Claim room for an `n`-byte message, or nullopt if the ring is too full.
+    std::optional<Reservation> try_reserve(std::size_t n) {
+        if (n > max_message()) {
+            throw SerializationError("ring: message of " + std::to_string(n) +
+                                     " bytes exceeds the ring's capacity");
+        }
+        const std::size_t frame = frame_size(n);
+        std::uint64_t pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            const std::size_t at = static_cast<std::size_t>(pos & mask_);
+            const std::size_t to_end = cap_ - at;
+            // A frame that would wrap: claim the rest of the ring as padding first.
+            const std::size_t need = frame <= to_end ? frame : to_end;
+            if (pos + need > tail_.load(std::memory_order_acquire) + cap_) return std::nullopt;
+            if (!head_.compare_exchange_weak(pos, pos + need, std::memory_order_relaxed)) continue;
+            if (need == frame) return Reservation{{data_.get() + at + FrameHeaderSize, n}, pos};
+            publish(at, Padding, to_end, 0);
+            pos = head_.load(std::memory_order_relaxed);
+        }
+    }
+
+    // As try_reserve(), yielding until the consumer makes room.
+    Reservation reserve(std::size_t n) {
+        for (;;) {
+            if (auto r = try_reserve(n)) return *r;
+            std::this_thread::yield();
+        }
+    }
+
+    // Publish the first `used` bytes of the reservation as a message.
+    void commit(const Reservation& r, std::size_t used) {
+        if (used > r.bytes.size()) {
+            throw SerializationError("ring: committed " + std::to_string(used) +
+                                     " bytes of a " + std::to_string(r.bytes.size()) + "-byte reservation");
+        }
+        publish(static_cast<std::size_t>(r.pos & mask_), Committed, frame_size(r.bytes.size()), used);
+    }
+
+    // Give the reservation up; the consumer skips it.
+    void abandon(const Reservation& r) {
+        publish(static_cast<std::size_t>(r.pos & mask_), Abandoned, frame_size(r.bytes.size()), 0);
+    }
+
+    // ---- the consumer (one thread) ----
+
+    // Call on_frame(std::span<const std::uint8_t>) for each committed message,
+    // in order, up to `max_frames`; returns how many. Stops at the first
+    // reservation not committed yet. If on_frame throws, the messages before
+    // that one are released and it is delivered again by the next poll().
+    template <class Fn>
+    std::size_t poll(Fn&& on_frame, std::size_t max_frames = SIZE_MAX) {
+        const std::uint64_t start = tail_.load(std::memory_order_relaxed);
+        std::uint64_t pos = start;
+        std::size_t delivered = 0;
+        try {
+            // At most one lap: the frames read are only zeroed on release.
+            while (delivered < max_frames && pos - start < cap_) {
+                const std::byte* h = data_.get() + (pos & mask_);
+                const std::uint32_t state = state_ref(pos & mask_).load(std::memory_order_acquire);
+                if (state == Empty) break;
+                if (state == Committed) {
+                    on_frame(std::span<const std::uint8_t>(
+                        reinterpret_cast<const std::uint8_t*>(h) + FrameHeaderSize, read_u32(h + 8)));
+                    ++delivered;
+                }
+                pos += read_u32(h + 4);
+            }
+        } catch (...) {
+            release(start, pos);
+            throw;
+        }
+        release(start, pos);
+        return delivered;
+    }
+
+    // No message waiting or being written (a snapshot, from any thread).
+    [[nodiscard]] bool empty() const noexcept {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+private:
+    static constexpr std::size_t CacheLine = 64;
+
+    enum : std::uint32_t { Empty = 0, Committed = 1, Padding = 2, Abandoned = 3 };
+
+    struct AlignedDelete {
+        void operator()(std::byte* p) const noexcept { ::operator delete(p, std::align_val_t{CacheLine}); }
+    };
+
+    static std::size_t frame_size(std::size_t n) {
+        return (FrameHeaderSize + n + FrameAlign - 1) & ~(FrameAlign - 1);
+    }
+
+    static std::uint32_t read_u32(const std::byte* p) {
+        std::uint32_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    std::atomic_ref<std::uint32_t> state_ref(std::size_t at) const {
+        return std::atomic_ref<std::uint32_t>(*reinterpret_cast<std::uint32_t*>(data_.get() + at));
+    }
+
+    // Fill in a frame header; the state goes last, releasing the frame.
+    void publish(std::size_t at, std::uint32_t state, std::size_t frame, std::size_t used) {
+        const std::uint32_t words[3] = {static_cast<std::uint32_t>(frame), static_cast<std::uint32_t>(used), 0};
+        std::memcpy(data_.get() + at + 4, words, sizeof(words));
+        state_ref(at).store(state, std::memory_order_release);
+    }
+
+    // Zero the frames read, then hand their space back to producers.
+    void release(std::uint64_t from, std::uint64_t to) {
+        if (to == from) return;
+        const std::size_t at = static_cast<std::size_t>(from & mask_);
+        const std::size_t len = static_cast<std::size_t>(to - from);
+        const std::size_t first = std::min(len, cap_ - at);
+        std::memset(data_.get() + at, 0, first);
+        std::memset(data_.get(), 0, len - first);
+        tail_.store(to, std::memory_order_release);
+    }
+
+    std::size_t cap_;
+    std::uint64_t mask_;
+    std::unique_ptr<std::byte[], AlignedDelete> data_;
+    alignas(CacheLine) std::atomic<std::uint64_t> head_{0}; // next position to reserve
+    alignas(CacheLine) std::atomic<std::uint64_t> tail_{0}; // first position not yet released
+};
+
+/*
+ * write<P>(ring, rootValue) / try_write<P>(ring, rootValue)
+ * ---------------------------------------------------------
+ * Measure rootValue, reserve that, encode it in place with serialize_to()
+ * and commit the bytes written (for Zera messages with a large arena, a
+ * little less than measured; see measure()). write() waits for room; try_write() returns
+ * false instead. rootValue is visited twice (counted, then written), so a
+ * builder must not consume its arguments.
+ */
+template <Protocol P, class RootType>
+requires MeasurableProtocol<P> && SpanOutputProtocol<P>
+bool try_write(ByteRing& ring, RootType&& rootValue) {
+    auto r = ring.try_reserve(measure<P>(rootValue));
+    if (!r) return false;
+    try {
+        ring.commit(*r, serialize_to<P>(r->bytes, rootValue));
+    } catch (...) {
+        ring.abandon(*r);
+        throw;
+    }
+    return true;
+}
+
+template <Protocol P, class RootType>
+requires MeasurableProtocol<P> && SpanOutputProtocol<P>
+void write(ByteRing& ring, RootType&& rootValue) {
+    const auto r = ring.reserve(measure<P>(rootValue));
+    try {
+        ring.commit(r, serialize_to<P>(r.bytes, rootValue));
+    } catch (...) {
+        ring.abandon(r);
+        throw;
+    }
+}
+
+/*
+ * read<P>(ring, on_message, max_messages)
+ * ---------------------------------------
+ * poll() with each message as a P::Deserializer over the ring's bytes; for
+ * the consumer thread only. Returns the number of messages delivered.
+ */
+template <Protocol P, class Fn>
+std::size_t read(ByteRing& ring, Fn&& on_message, std::size_t max_messages = SIZE_MAX) {
+    return ring.poll([&](std::span<const std::uint8_t> bytes) {
+        const typename P::Deserializer msg(bytes);
+        on_message(msg);
+    }, max_messages);
+}
+
+} // namespace ring
+} // namespace zerialize
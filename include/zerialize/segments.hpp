@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <utility>
+#include <vector>
+
+#if __has_include(<sys/uio.h>)
+#include <sys/uio.h>
+#define ZERIALIZE_HAS_IOVEC 1
+#endif
+
+#include <zerialize/zbuffer.hpp>
+
+namespace zerialize {
+
+/*
+ * SegmentedBuffer
+ * ---------------
+ * A serialized message as a list of byte ranges instead of one contiguous
+ * buffer. Concatenated in order, the segments are exactly the bytes finish()
+ * would have returned. Some of them are the serializer's own output (owned by
+ * the SegmentedBuffer); the others point straight at blobs the caller passed
+ * to binary() or typed_array(), which were never copied.
+ *
+ *   zerialize::Zera::RootSerializer rs;
+ *   rs.set_blob_reference_threshold(64 * 1024);
+ *   zerialize::Zera::Serializer w{rs};
+ *   zmap<"id", "image">(id, std::span<const std::byte>(pixels))(w);
+ *   SegmentedBuffer msg = rs.finish_segments();
+ *   ::writev(fd, msg.iovecs().data(), int(msg.iovecs().size()));
+ *
+ * Lifetime: a referenced blob must stay alive, and unchanged, until the
+ * SegmentedBuffer is destroyed (or at least until its bytes have been sent).
+ * Nothing is copied to protect it.
+ *
+ * A Segment has the layout of a POSIX struct iovec; iovecs() exposes the list
+ * as one where <sys/uio.h> exists. flatten() copies everything into a ZBuffer.
+ */
+struct Segment {
+    const void* data = nullptr;
+    std::size_t size = 0;
+};
+
+class SegmentedBuffer {
+public:
+    SegmentedBuffer() = default;
+
+    // `segments` may point into `owned` (whose bytes do not move with it).
+    SegmentedBuffer(ZBuffer owned, std::vector<Segment> segments)
+        : owned_(std::move(owned)), segments_(std::move(segments)) {
+        for (const auto& s : segments_) size_ += s.size;
+    }
+
+    std::span<const Segment> segments() const { return segments_; }
+
+    // Total message size in bytes.
+    std::size_t size() const { return size_; }
+
+    // The bytes owned by this buffer (everything but the referenced blobs).
+    const ZBuffer& owned() const { return owned_; }
+
+    // The whole message as one contiguous buffer (copies every segment).
+    ZBuffer flatten() const {
+        std::vector<std::uint8_t> out(size_);
+        std::size_t at = 0;
+        for (const auto& s : segments_) {
+            if (s.size) std::memcpy(out.data() + at, s.data, s.size);
+            at += s.size;
+        }
+        return ZBuffer(std::move(out));
+    }
+
+#ifdef ZERIALIZE_HAS_IOVEC
+    std::span<const ::iovec> iovecs() const {
+        return {reinterpret_cast<const ::iovec*>(segments_.data()), segments_.size()};
+    }
+#endif
+
+private:
+    ZBuffer owned_;
+    std::vector<Segment> segments_;
+    std::size_t size_ = 0;
+};
+
+#ifdef ZERIALIZE_HAS_IOVEC
+static_assert(sizeof(Segment) == sizeof(::iovec));
+static_assert(offsetof(Segment, data) == offsetof(::iovec, iov_base));
+static_assert(offsetof(Segment, size) == offsetof(::iovec, iov_len));
+#endif
+
+} // namespace zerialize
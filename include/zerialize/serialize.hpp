@@ -1,8 +1,12 @@
 #pragma once
 
 #include <utility>
+#include <span>
+#include <cstddef>
+#include <cstdint>
 
 #include <zerialize/zbuffer.hpp>
+#include <zerialize/buffer_pool.hpp>
 #include <zerialize/concepts.hpp>
 #include <zerialize/internals/serializers.hpp>
 #include <zerialize/zbuilders.hpp>
@@ -57,6 +61,141 @@ inline ZBuffer serialize(RootType&& rootValue) {
     return rs.finish();
 }
 
+/*
+ * serialize_into<P>(rootSerializer, rootValue)
+ * --------------------------------------------
+ * Like serialize<P>(), but encodes into a caller-owned, long-lived
+ * P::RootSerializer instead of a fresh one. The serializer is reset() first
+ * (keeping its capacity), and the encoded bytes are returned as a view into
+ * its storage via finish_view().
+ *
+ * The returned span is valid until the next serialize_into()/reset() on the
+ * same serializer, or its destruction. Copy the bytes out (or use serialize())
+ * if they must outlive that.
+ *
+ * Typical use is one serializer per worker thread:
+ *
+ *   zerialize::Zera::RootSerializer rs;
+ *   for (auto& msg : messages) {
+ *       auto bytes = zerialize::serialize_into<zerialize::Zera>(rs, zmap<"id">(msg.id));
+ *       send(bytes);
+ *   }
+ */
+template <Protocol P, class RootType>
+requires ReusableRootSerializer<typename P::RootSerializer>
+inline std::span<const std::uint8_t> serialize_into(typename P::RootSerializer& rs, RootType&& rootValue) {
+    using Serializer = typename P::Serializer;
+    using T          = std::remove_cvref_t<RootType>;
+
+    rs.reset();
+    Serializer w{rs};
+
+    if constexpr (Builder<T>) {
+        std::forward<RootType>(rootValue)(w);
+    } else {
+        using zerialize::serialize;
+        serialize(std::forward<RootType>(rootValue), w);
+    }
+    return rs.finish_view();
+}
+
+/*
+ * serialize<P>(pool, rootValue)
+ * -----------------------------
+ * Like serialize<P>(rootValue), but the output vector comes from `pool` and
+ * the returned ZBuffer gives it back on destruction (see BufferPool). For
+ * any protocol whose RootSerializer is constructible from a BufferPool&:
+ * Zera, CBOR, CBORJsoncons, MsgPack and JSONDirect.
+ */
+template <Protocol P, class RootType>
+requires std::constructible_from<typename P::RootSerializer, BufferPool&>
+inline ZBuffer serialize(BufferPool& pool, RootType&& rootValue) {
+    using Serializer = typename P::Serializer;
+    using T          = std::remove_cvref_t<RootType>;
+
+    typename P::RootSerializer rs{pool};
+    Serializer w{rs};
+
+    if constexpr (Builder<T>) {
+        std::forward<RootType>(rootValue)(w);
+    } else {
+        using zerialize::serialize;
+        serialize(std::forward<RootType>(rootValue), w);
+    }
+    return rs.finish();
+}
+
+/*
+ * serialize_to<P>(dst, rootValue)
+ * -------------------------------
+ * Encodes rootValue straight into `dst` (a shared-memory slot, a DMA or
+ * registered I/O buffer) and returns the number of bytes used; nothing is
+ * allocated for the output and nothing is copied afterwards. If the message
+ * does not fit, throws OutputOverflow; its required() is the size the
+ * message needs, and the contents of `dst` are unspecified. For SpanOutputProtocols (Zera,
+ * MsgPack, CBOR).
+ *
+ *   std::span<std::byte> slot = shm.slot(i);
+ *   std::size_t n = zerialize::serialize_to<zerialize::MsgPack>(slot, zmap<"id">(id));
+ *   shm.publish(i, n);
+ *
+ * Use a long-lived P::SpanRootSerializer (with reset(span) per message) to
+ * also keep the writer's own small bookkeeping allocations out of the loop.
+ */
+template <Protocol P, class RootType>
+requires SpanOutputProtocol<P>
+inline std::size_t serialize_to(std::span<std::byte> dst, RootType&& rootValue) {
+    using Serializer = typename P::SpanSerializer;
+    using T          = std::remove_cvref_t<RootType>;
+
+    typename P::SpanRootSerializer rs{dst};
+    Serializer w{rs};
+
+    if constexpr (Builder<T>) {
+        std::forward<RootType>(rootValue)(w);
+    } else {
+        using zerialize::serialize;
+        serialize(std::forward<RootType>(rootValue), w);
+    }
+    return rs.finish_view().size();
+}
+
+/*
+ * measure<P>(rootValue)
+ * ---------------------
+ * The exact size, in bytes, of rootValue encoded with P, computed by running
+ * the value through P::SizeCounter: nothing is written and nothing is
+ * allocated, so it is cheap enough to run on every message. Use it to
+ * allocate once, to claim a ring-buffer slot of the right size before
+ * serialize_to(), or to choose between sending a message inline and out of
+ * band. For MeasurableProtocols (Zera, MsgPack, CBOR).
+ *
+ *   std::size_t n = zerialize::measure<zerialize::CBOR>(zmap<"id", "name">(id, name));
+ *   std::span<std::byte> slot = ring.claim(n);
+ *   zerialize::serialize_to<zerialize::CBOR>(slot, zmap<"id", "name">(id, name));
+ *
+ * For MsgPack and CBOR the size is that of every encoding. For Zera it is
+ * the size serialize<Zera>() produces, and serialize_into() with a new or a
+ * reused RootSerializer, which can keep envelope slack in front of a large
+ * arena; serialize_to() closes that gap, so a buffer of this size is always
+ * enough, for a reused span writer too (zera::SizeCounter::span_size() is
+ * its exact size).
+ */
+template <Protocol P, class RootType>
+requires MeasurableProtocol<P>
+inline std::size_t measure(RootType&& rootValue) {
+    using T = std::remove_cvref_t<RootType>;
+
+    typename P::SizeCounter c;
+    if constexpr (Builder<T>) {
+        std::forward<RootType>(rootValue)(c);
+    } else {
+        using zerialize::serialize;
+        serialize(std::forward<RootType>(rootValue), c);
+    }
+    return c.size();
+}
+
 // Overload for 0 arguments: creates empty serialization. 
 // Not necessarily 0-byte; for example in json is "null".
 template <Protocol P>
@@ -0,0 +1,319 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <zerialize/concepts.hpp>
+#include <zerialize/errors.hpp>
+#include <zerialize/serialize.hpp>
+#include <zerialize/zbuffer.hpp>
+
+namespace zerialize {
+namespace stream {
+
+/*
+ * Streams of messages
+ * -------------------
+ * serialize<P>() produces one message per call. This header packs many
+ * messages into one buffer (one write() per batch instead of one per message)
+ * and splits such a buffer, or a socket's worth of arbitrary chunks, back into
+ * P::Deserializer views without copying each message out.
+ *
+ * Framing:
+ *   • LengthPrefixed — each message is preceded by its length as a
+ *                      little-endian uint32. Works for every protocol.
+ *   • Concatenated   — messages back to back, with no header. Only for a
+ *                      SelfDelimitingProtocol (MsgPack, CBOR), whose
+ *                      messages are already a valid stream of values.
+ *
+ * Example:
+ *   stream::FrameWriter<MsgPack> out;
+ *   for (const auto& s : samples) out.write(zmap<"seq", "v">(s.seq, s.v));
+ *   ::write(fd, out.view().data(), out.view().size());
+ *   out.clear();
+ *
+ *   stream::FrameDecoder<MsgPack> in;
+ *   while (auto n = ::read(fd, chunk, sizeof chunk); n > 0)
+ *       in.feed({chunk, size_t(n)}, [](const MsgPack::Deserializer& msg) { ... });
+ *   in.finish();  // throws if the stream ended mid-message
+ *
+ * Payloads sit at arbitrary offsets in the batch. Readers that want aligned
+ * data (Zera tensor views) copy when the payload is not suitably aligned.
+ */
+
+enum class Framing {
+    LengthPrefixed,
+    Concatenated
+};
+
+inline constexpr std::size_t LengthPrefixSize = 4;
+
+namespace detail {
+
+template <class P, Framing F>
+inline constexpr bool framing_supported =
+    F == Framing::LengthPrefixed || SelfDelimitingProtocol<P>;
+
+inline std::uint32_t read_le32(const std::uint8_t* p) {
+    return std::uint32_t(p[0]) | (std::uint32_t(p[1]) << 8) |
+           (std::uint32_t(p[2]) << 16) | (std::uint32_t(p[3]) << 24);
+}
+
+inline std::size_t checked_length(std::span<const std::uint8_t> prefix, std::size_t max_frame) {
+    const std::size_t len = read_le32(prefix.data());
+    if (len > max_frame) {
+        throw DeserializationError("stream: frame of " + std::to_string(len) + " bytes exceeds the limit");
+    }
+    return len;
+}
+
+// One frame at the start of `b`.
+struct Extent {
+    std::size_t payload_off = 0;
+    std::size_t size = 0; // whole frame, prefix included; 0 = incomplete
+    std::size_t need = 0; // incomplete: at least this many bytes missing; 0 = unknown
+};
+
+// Locate the frame at the start of `b`. With `more` set, a frame that runs past
+// the end of `b` is reported as incomplete; otherwise it is an error.
+template <class P, Framing F>
+Extent frame_extent(std::span<const std::uint8_t> b, bool more, std::size_t max_frame) {
+    if constexpr (F == Framing::LengthPrefixed) {
+        if (b.size() < LengthPrefixSize) {
+            if (more) return { 0, 0, LengthPrefixSize - b.size() };
+            throw DeserializationError("stream: truncated frame header");
+        }
+        const std::size_t len = checked_length(b, max_frame);
+        if (len > b.size() - LengthPrefixSize) {
+            if (more) return { 0, 0, LengthPrefixSize + len - b.size() };
+            throw DeserializationError("stream: truncated frame");
+        }
+        return { LengthPrefixSize, LengthPrefixSize + len };
+    } else {
+        std::size_t n = 0;
+        try {
+            n = P::frame_size(b);
+        } catch (const DeserializationError&) {
+            // A prefix of a valid message looks malformed until the rest arrives.
+            if (more && b.size() <= max_frame) return {};
+            throw;
+        }
+        if (n == 0) throw DeserializationError("stream: empty frame");
+        if (n > b.size()) {
+            if (n > max_frame) {
+                throw DeserializationError("stream: frame of " + std::to_string(n) + " bytes exceeds the limit");
+            }
+            if (more) return { 0, 0, n - b.size() };
+            throw DeserializationError("stream: truncated frame");
+        }
+        return { 0, n };
+    }
+}
+
+} // namespace detail
+
+/*
+ * FrameWriter<P, F>
+ * -----------------
+ * Appends framed messages to one growable buffer. Each write() encodes through
+ * a reused P::RootSerializer (see serialize_into) and copies the bytes in once.
+ * clear() keeps the buffer's capacity, so a writer drained after every batch
+ * stops allocating once it has seen the largest batch.
+ */
+template <Protocol P, Framing F = Framing::LengthPrefixed>
+requires ReusableRootSerializer<typename P::RootSerializer>
+class FrameWriter {
+    static_assert(detail::framing_supported<P, F>,
+                  "Framing::Concatenated requires a SelfDelimitingProtocol");
+
+    std::vector<std::uint8_t> out_;
+    std::size_t frames_ = 0;
+    typename P::RootSerializer rs_{};
+
+public:
+    FrameWriter() = default;
+    explicit FrameWriter(std::size_t reserve_bytes) { out_.reserve(reserve_bytes); }
+
+    // Encode one value (a builder or anything serialize<P>() accepts).
+    template <class RootType>
+    void write(RootType&& rootValue) {
+        append(serialize_into<P>(rs_, std::forward<RootType>(rootValue)));
+    }
+
+    // Frame a message that is already encoded with P.
+    void append(std::span<const std::uint8_t> message) {
+        if constexpr (F == Framing::LengthPrefixed) {
+            if (message.size() > UINT32_MAX) {
+                throw SerializationError("stream: message of " + std::to_string(message.size()) +
+                                         " bytes does not fit a 32-bit length prefix");
+            }
+            const auto len = static_cast<std::uint32_t>(message.size());
+            const std::uint8_t prefix[LengthPrefixSize] = {
+                std::uint8_t(len), std::uint8_t(len >> 8), std::uint8_t(len >> 16), std::uint8_t(len >> 24)
+            };
+            out_.insert(out_.end(), prefix, prefix + LengthPrefixSize);
+        }
+        out_.insert(out_.end(), message.begin(), message.end());
+        ++frames_;
+    }
+
+    // The framed bytes so far; valid until the next write/append/clear/finish.
+    [[nodiscard]] std::span<const std::uint8_t> view() const noexcept { return out_; }
+    [[nodiscard]] std::size_t size() const noexcept { return out_.size(); }
+    [[nodiscard]] std::size_t frames() const noexcept { return frames_; }
+    [[nodiscard]] bool empty() const noexcept { return frames_ == 0; }
+
+    // Drop the batch, keeping capacity.
+    void clear() noexcept { out_.clear(); frames_ = 0; }
+
+    // Hand the batch over as a ZBuffer; the writer starts empty (and unallocated).
+    ZBuffer finish() {
+        frames_ = 0;
+        return ZBuffer(std::exchange(out_, {}));
+    }
+};
+
+/*
+ * FrameReader<P, F>
+ * -----------------
+ * Splits a contiguous buffer of frames. next() returns a P::Deserializer over
+ * the next payload in place, or nullopt at the end. The views borrow the
+ * buffer, which must outlive them. A buffer that ends mid-frame throws
+ * DeserializationError.
+ */
+template <Protocol P, Framing F = Framing::LengthPrefixed>
+class FrameReader {
+    static_assert(detail::framing_supported<P, F>,
+                  "Framing::Concatenated requires a SelfDelimitingProtocol");
+
+    std::span<const std::uint8_t> buf_;
+    std::size_t off_ = 0;
+
+public:
+    explicit FrameReader(std::span<const std::uint8_t> bytes) : buf_(bytes) {}
+
+    // The next payload's bytes, or nullopt at the end.
+    std::optional<std::span<const std::uint8_t>> next_payload() {
+        if (off_ == buf_.size()) return std::nullopt;
+        const auto e = detail::frame_extent<P, F>(buf_.subspan(off_), false, SIZE_MAX);
+        auto payload = buf_.subspan(off_ + e.payload_off, e.size - e.payload_off);
+        off_ += e.size;
+        return payload;
+    }
+
+    std::optional<typename P::Deserializer> next() {
+        auto payload = next_payload();
+        if (!payload) return std::nullopt;
+        return typename P::Deserializer(*payload);
+    }
+
+    // Bytes consumed so far.
+    [[nodiscard]] std::size_t offset() const noexcept { return off_; }
+    [[nodiscard]] bool done() const noexcept { return off_ == buf_.size(); }
+};
+
+/*
+ * FrameDecoder<P, F>
+ * ------------------
+ * Splits frames out of input that arrives in arbitrary chunks (socket reads,
+ * file blocks). feed() calls on_message(const P::Deserializer&) for each
+ * complete message. Messages lying wholly inside the chunk are read in place;
+ * only a message split across chunks is staged in an internal buffer. The
+ * views passed to on_message are valid only during the call.
+ *
+ * max_frame_bytes bounds the staging buffer: a longer frame, or (with
+ * Concatenated framing) that many bytes that do not parse, throws
+ * DeserializationError. If on_message throws, the decoder's position is lost
+ * and it should be discarded.
+ */
+template <Protocol P, Framing F = Framing::LengthPrefixed>
+class FrameDecoder {
+    static_assert(detail::framing_supported<P, F>,
+                  "Framing::Concatenated requires a SelfDelimitingProtocol");
+
+    std::vector<std::uint8_t> pending_; // start of a frame split across chunks
+    std::size_t need_ = 0;              // bytes pending_ lacks at least; 0 = unknown
+    std::size_t max_frame_;
+
+    template <class Fn>
+    static void deliver(std::span<const std::uint8_t> frame, std::size_t payload_off, Fn& on_message) {
+        const typename P::Deserializer msg(frame.subspan(payload_off));
+        on_message(msg);
+    }
+
+public:
+    static constexpr std::size_t DefaultMaxFrame = std::size_t{64} << 20;
+
+    explicit FrameDecoder(std::size_t max_frame_bytes = DefaultMaxFrame) : max_frame_(max_frame_bytes) {}
+
+    // Returns the number of messages delivered.
+    template <class Fn>
+    std::size_t feed(std::span<const std::uint8_t> chunk, Fn&& on_message) {
+        std::size_t delivered = 0;
+        std::size_t used = 0;
+
+        if (!pending_.empty()) {
+            // Stage only the split frame: copy in what it still needs (as
+            // much again as is staged when that is unknown, so re-parsing
+            // stays linear) until it parses, then hand any bytes copied past
+            // its end back to the chunk.
+            for (;;) {
+                if (used == chunk.size()) return delivered;
+                const std::size_t want = need_ ? need_ : pending_.size();
+                const std::size_t take = std::min(want, chunk.size() - used);
+                pending_.insert(pending_.end(), chunk.begin() + used, chunk.begin() + used + take);
+                used += take;
+                if (take < need_) {
+                    need_ -= take;
+                    continue;
+                }
+                const auto e = detail::frame_extent<P, F>(pending_, true, max_frame_);
+                if (e.size == 0) {
+                    need_ = e.need;
+                    continue;
+                }
+                used -= pending_.size() - e.size;
+                deliver(std::span<const std::uint8_t>(pending_).first(e.size), e.payload_off, on_message);
+                ++delivered;
+                pending_.clear();
+                need_ = 0;
+                break;
+            }
+        }
+
+        // Frames wholly inside the chunk: no copies.
+        auto rest = chunk.subspan(used);
+        std::size_t off = 0;
+        while (off < rest.size()) {
+            const auto e = detail::frame_extent<P, F>(rest.subspan(off), true, max_frame_);
+            if (e.size == 0) {
+                need_ = e.need;
+                break;
+            }
+            deliver(rest.subspan(off, e.size), e.payload_off, on_message);
+            ++delivered;
+            off += e.size;
+        }
+        pending_.assign(rest.begin() + static_cast<std::ptrdiff_t>(off), rest.end());
+        return delivered;
+    }
+
+    // Bytes of an incomplete frame held back for the next feed().
+    [[nodiscard]] std::size_t pending() const noexcept { return pending_.size(); }
+
+    // Call at end of input: throws DeserializationError if it ended mid-frame.
+    void finish() const {
+        if (pending_.empty()) return;
+        (void)detail::frame_extent<P, F>(pending_, false, max_frame_);
+        throw DeserializationError("stream: trailing bytes after the last frame");
+    }
+};
+
+} // namespace stream
+} // namespace zerialize
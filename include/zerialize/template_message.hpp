@@ -0,0 +1,175 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <zerialize/concepts.hpp>
+#include <zerialize/errors.hpp>
+#include <zerialize/internals/fixed_string.hpp>
+#include <zerialize/zbuffer.hpp>
+#include <zerialize/zbuilders.hpp>
+
+namespace zerialize {
+
+/*
+ * template_message.hpp
+ * --------------------
+ * A message whose keys and value types never change, only its values, has
+ * the same bytes every time except for the scalar payloads. TemplateMessage
+ * encodes such a message once and then only rewrites those payloads:
+ *
+ *   TemplateMessage<MsgPack, "seq", "ts", "pose"> msg;
+ *   for (;;) {
+ *       auto bytes = msg.encode(seq++, now(), pose);  // pose: std::array<double, 7>
+ *       send(bytes);
+ *   }
+ *
+ * The first encode() writes the map through the protocol's own writer, with
+ * every scalar at its widest encoding (int64 min, uint64 max, a double that is
+ * not a float), and records where each scalar landed by reading the message
+ * back. Later calls with the same value types overwrite those slots in place:
+ * no writer, no allocation, no copy of the skeleton.
+ *
+ * Values may be bool, arithmetic types and std::array of those (nested to any
+ * depth). They are written as serialize() would write them, but always at
+ * full width, so MsgPack and CBOR integers take 9 bytes where serialize()
+ * might use 1. Any reader decodes them to the same values.
+ *
+ * Requires a PatchableProtocol (Zera, MsgPack, CBOR). The returned span is
+ * valid until the next encode() or the TemplateMessage's destruction.
+ */
+
+namespace detail {
+
+template<class T>
+struct is_std_array : std::false_type {};
+template<class T, std::size_t N>
+struct is_std_array<std::array<T, N>> : std::true_type {};
+
+// Types with a fixed-width encoding: scalars, and std::arrays of them.
+template<class T>
+constexpr bool templatable() {
+    if constexpr (std::is_arithmetic_v<T>) return true;
+    else if constexpr (is_std_array<T>::value) return templatable<typename T::value_type>();
+    else return false;
+}
+
+// Identifies the value types a skeleton was built for.
+template<class... Ts>
+inline constexpr char template_shape_tag = 0;
+
+// Not exactly representable as a float, so no writer narrows it.
+inline constexpr double template_placeholder_double = 0.1;
+
+// Scalars go through the same Writer calls as serialize() (char is written
+// as int64 there, whatever its signedness).
+template<class T>
+inline constexpr bool template_signed_v =
+    std::is_signed_v<T> || std::is_same_v<T, char>;
+
+template<class T, Writer W>
+void write_placeholder(W& w) {
+    if constexpr (std::is_same_v<T, bool>) {
+        w.boolean(false);
+    } else if constexpr (std::is_floating_point_v<T>) {
+        w.double_(template_placeholder_double);
+    } else if constexpr (std::is_integral_v<T>) {
+        if constexpr (template_signed_v<T>) w.int64(std::numeric_limits<std::int64_t>::min());
+        else w.uint64(std::numeric_limits<std::uint64_t>::max());
+    } else {
+        constexpr std::size_t N = std::tuple_size_v<T>;
+        w.begin_array(N);
+        for (std::size_t i = 0; i < N; ++i) write_placeholder<typename T::value_type>(w);
+        w.end_array();
+    }
+}
+
+struct TemplateSlot {
+    std::size_t ofs = 0;
+    std::size_t len = 0;
+};
+
+template<class T, class V>
+void collect_slots(const V& v, const std::uint8_t* base, std::vector<TemplateSlot>& slots) {
+    if constexpr (is_std_array<T>::value) {
+        for (std::size_t i = 0; i < std::tuple_size_v<T>; ++i)
+            collect_slots<typename T::value_type>(v[i], base, slots);
+    } else {
+        const auto raw = v.raw_view();
+        slots.push_back({static_cast<std::size_t>(raw.data() - base), raw.size()});
+    }
+}
+
+template<class P, class T>
+void patch_value(std::uint8_t* base, const TemplateSlot*& slot, const T& v) {
+    if constexpr (is_std_array<T>::value) {
+        for (const auto& x : v) patch_value<P>(base, slot, x);
+    } else {
+        const std::span<std::uint8_t> s(base + slot->ofs, slot->len);
+        ++slot;
+        if constexpr (std::is_same_v<T, bool>) P::patch_bool(s, v);
+        else if constexpr (std::is_floating_point_v<T>) P::patch_double(s, static_cast<double>(v));
+        else if constexpr (template_signed_v<T>) P::patch_int64(s, static_cast<std::int64_t>(v));
+        else P::patch_uint64(s, static_cast<std::uint64_t>(v));
+    }
+}
+
+} // namespace detail
+
+template<class P, fixed_string... Keys>
+class TemplateMessage {
+    static_assert(PatchableProtocol<P>, "TemplateMessage: protocol cannot patch scalars in place");
+
+    std::vector<std::uint8_t> bytes_;
+    std::vector<detail::TemplateSlot> slots_;
+    const void* shape_ = nullptr;
+
+public:
+    // Encode {Keys: values...}. Builds the skeleton on the first call, and
+    // again whenever the value types change.
+    template<class... Ts>
+    std::span<const std::uint8_t> encode(const Ts&... values) {
+        static_assert(sizeof...(Ts) == sizeof...(Keys),
+                      "TemplateMessage: number of values must match number of keys");
+        static_assert((detail::templatable<Ts>() && ...),
+                      "TemplateMessage: values must be bool, arithmetic or std::array of those");
+
+        const void* shape = &detail::template_shape_tag<Ts...>;
+        if (shape_ != shape) {
+            shape_ = nullptr;
+            build<Ts...>();
+        }
+        const detail::TemplateSlot* slot = slots_.data();
+        (detail::patch_value<P>(bytes_.data(), slot, values), ...);
+        shape_ = shape; // the protocol accepted every slot
+        return bytes_;
+    }
+
+    // The last message encoded (empty before the first encode()).
+    std::span<const std::uint8_t> view() const { return bytes_; }
+
+private:
+    template<class... Ts>
+    void build() {
+        {
+            typename P::RootSerializer rs;
+            typename P::Serializer w{rs};
+            w.begin_map(sizeof...(Keys));
+            ((write_key<Keys>(w), detail::write_placeholder<Ts>(w)), ...);
+            w.end_map();
+            ZBuffer buf = rs.finish();
+            bytes_.assign(buf.data(), buf.data() + buf.size());
+        }
+        slots_.clear();
+        typename P::Deserializer d{std::span<const std::uint8_t>(bytes_)};
+        (detail::collect_slots<Ts>(d[Keys.view()], bytes_.data(), slots_), ...);
+    }
+};
+
+} // namespace zerialize
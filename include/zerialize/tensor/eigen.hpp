@@ -6,6 +6,7 @@
 #include <optional>
 #include <span>
 #include <type_traits>
+#include <utility>
 #include <Eigen/Dense>
 #include <zerialize/zerialize.hpp>
 #include <zerialize/tensor/utils.hpp>
@@ -16,16 +17,15 @@ namespace Eigen {
 
 template <typename T, int R, int C, int Options, zerialize::Writer W>
 void serialize(const Eigen::Matrix<T, R, C, Options>& m, W& w) {
-    const std::array<std::size_t, 2> shape{
-        static_cast<std::size_t>(m.rows()),
-        static_cast<std::size_t>(m.cols())
+    const std::array<std::uint64_t, 2> shape{
+        static_cast<std::uint64_t>(m.rows()),
+        static_cast<std::uint64_t>(m.cols())
     };
 
-    zerialize::zvec(
+    zerialize::write_typed_array(w,
         zerialize::tensor_dtype_index<T>,
         shape,
-        zerialize::span_from_data_of(m)
-    )(w);
+        zerialize::span_from_data_of(m));
 }
 
 } // namespace Eigen
@@ -37,8 +37,8 @@ namespace eigen {
 //
 // Motivation:
 // - Some protocols expose blobs as a non-owning `std::span<const std::byte>` (true zero-copy possible).
-// - Other protocols materialize blobs as an owning `std::vector<std::byte>` (e.g. JSON base64 decode),
-//   so returning an Eigen view would dangle unless we take ownership.
+// - Other protocols materialize blobs as an owning `std::vector<std::byte>`, or decode them (JSON's
+//   base64) into the matrix storage, so returning an Eigen view would dangle unless we take ownership.
 //
 // `EigenMatrixView` type-erases only the *ownership* of the underlying bytes:
 // - If a zero-copy view is safe, it stores a span into the reader's backing storage.
@@ -102,16 +102,11 @@ private:
     std::size_t cols_ = 0;
 };
 
-template <typename T, int NRows, int NCols, bool TensorIsMap = false, int Options = Eigen::ColMajor>
-EigenMatrixView<T, NRows, NCols, Options> asEigenMatrixView(const Reader auto& buf) {
-    using ViewType = EigenMatrixView<T, NRows, NCols, Options>;
-    using MatrixType = typename ViewType::MatrixType;
-
-    // Note: `isTensor` does dtype/shape/blob presence checks but does not validate payload size.
-    if (!isTensor<T, TensorIsMap>(buf)) { throw DeserializationError("not a tensor"); }
+namespace detail {
 
-    auto dtype_ref = TensorIsMap ? buf[DTypeKey] : buf[0];
-    auto dtype = dtype_ref.asInt32();
+// Check dtype and shape against the requested matrix; returns {rows, cols}.
+template <typename T, int NRows, int NCols>
+std::pair<std::size_t, std::size_t> eigen_matrix_dims(int dtype, const TensorShape& vshape) {
     if (dtype != tensor_dtype_index<T>) {
         throw DeserializationError(
             std::string("asEigenMatrixView asked to deserialize a matrix of type ") +
@@ -119,8 +114,6 @@ EigenMatrixView<T, NRows, NCols, Options> asEigenMatrixView(const Reader auto& b
         );
     }
 
-    auto shape_ref = TensorIsMap ? buf[ShapeKey] : buf[1];
-    TensorShape vshape = tensor_shape(shape_ref);
     if (vshape.size() != 2) {
         throw DeserializationError(
             "asEigenMatrixView asked to deserialize a matrix of rank 2 but found a matrix of rank " + std::to_string(vshape.size())
@@ -140,9 +133,19 @@ EigenMatrixView<T, NRows, NCols, Options> asEigenMatrixView(const Reader auto& b
             throw DeserializationError("asEigenMatrixView expected " + std::to_string(NCols) + " cols, but found " + std::to_string(cols) + ".");
         }
     }
+    return {rows, cols};
+}
 
-    auto data_ref = TensorIsMap ? buf[DataKey] : buf[2];
-    auto blob = data_ref.asBlob();
+// Build the view from an already-located dtype, shape and blob. `Blob` is either a
+// non-owning span (zero-copy candidate) or an owning container (always copied).
+template <typename T, int NRows, int NCols, int Options, typename Blob>
+EigenMatrixView<T, NRows, NCols, Options> eigen_view_from_parts(int dtype, const TensorShape& vshape, const Blob& blob) {
+    using ViewType = EigenMatrixView<T, NRows, NCols, Options>;
+    using MatrixType = typename ViewType::MatrixType;
+
+    const auto dims = eigen_matrix_dims<T, NRows, NCols>(dtype, vshape);
+    const std::size_t rows = dims.first;
+    const std::size_t cols = dims.second;
 
     auto to_span = [](auto&& b) {
         using B = std::remove_cvref_t<decltype(b)>;
@@ -180,7 +183,7 @@ EigenMatrixView<T, NRows, NCols, Options> asEigenMatrixView(const Reader auto& b
     };
 
     // If the blob is owning (e.g. JSON), we must copy to keep storage alive.
-    if constexpr (!std::is_same_v<decltype(blob), std::span<const std::byte>>) {
+    if constexpr (!std::is_same_v<Blob, std::span<const std::byte>>) {
         return make_copy();
     } else {
         // For non-owning blobs, only take the view if the data meets Eigen's scalar alignment needs.
@@ -207,6 +210,69 @@ EigenMatrixView<T, NRows, NCols, Options> asEigenMatrixView(const Reader auto& b
     }
 }
 
+// Build an owning view from a blob the reader decodes (see BlobDecodeReader):
+// the bytes are decoded straight into the matrix storage.
+template <typename T, int NRows, int NCols, int Options, typename V>
+EigenMatrixView<T, NRows, NCols, Options> eigen_view_from_decoded(int dtype, const TensorShape& vshape, const V& blob) {
+    using ViewType = EigenMatrixView<T, NRows, NCols, Options>;
+    using MatrixType = typename ViewType::MatrixType;
+
+    const auto dims = eigen_matrix_dims<T, NRows, NCols>(dtype, vshape);
+    const std::size_t rows = dims.first;
+    const std::size_t cols = dims.second;
+
+    const std::size_t expected = rows * cols * sizeof(T);
+    const std::size_t found = blob.blobSize();
+    if (found != expected) {
+        throw DeserializationError(
+            "asEigenMatrixView expected " + std::to_string(expected) + " bytes, but found " + std::to_string(found)
+        );
+    }
+
+    MatrixType m = [&] {
+        if constexpr (NRows == Eigen::Dynamic || NCols == Eigen::Dynamic) {
+            return MatrixType(static_cast<Eigen::Index>(rows), static_cast<Eigen::Index>(cols));
+        } else {
+            return MatrixType();
+        }
+    }();
+    blob.readBlobInto(std::span<std::byte>(reinterpret_cast<std::byte*>(m.data()), expected));
+
+    tensor::TensorViewInfo info{};
+    info.zero_copy = false;
+    info.reason = tensor::TensorViewReason::NotSpanBacked;
+    info.required_alignment = alignof(T);
+    info.byte_size = expected;
+    return ViewType(std::move(m), rows, cols, info);
+}
+
+} // namespace detail
+
+template <typename T, int NRows, int NCols, bool TensorIsMap = false, int Options = Eigen::ColMajor>
+EigenMatrixView<T, NRows, NCols, Options> asEigenMatrixView(const Reader auto& buf) {
+    // Native typed arrays carry dtype, shape and data in a single value.
+    if constexpr (TypedArrayReader<std::remove_cvref_t<decltype(buf)>>) {
+        if (buf.isTypedArray()) {
+            const TypedArrayView ta = buf.asTypedArray();
+            return detail::eigen_view_from_parts<T, NRows, NCols, Options>(ta.dtype, tensor_shape(ta), ta.data);
+        }
+    }
+
+    // Note: `isTensor` does dtype/shape/blob presence checks but does not validate payload size.
+    if (!isTensor<T, TensorIsMap>(buf)) { throw DeserializationError("not a tensor"); }
+
+    auto dtype_ref = TensorIsMap ? buf[DTypeKey] : buf[0];
+    auto shape_ref = TensorIsMap ? buf[ShapeKey] : buf[1];
+    auto data_ref = TensorIsMap ? buf[DataKey] : buf[2];
+    if constexpr (BlobDecodeReader<decltype(data_ref)>) {
+        return detail::eigen_view_from_decoded<T, NRows, NCols, Options>(
+            dtype_ref.asInt32(), tensor_shape(shape_ref), data_ref);
+    } else {
+        return detail::eigen_view_from_parts<T, NRows, NCols, Options>(
+            dtype_ref.asInt32(), tensor_shape(shape_ref), data_ref.asBlob());
+    }
+}
+
 // Deserialize an eigen matrix/map
 template <typename T, int NRows, int NCols, bool TensorIsMap=false, int Options=Eigen::ColMajor>
 Eigen::Matrix<T, NRows, NCols, Options | Eigen::DontAlign> 
@@ -217,3 +283,14 @@ asEigenMatrix(const Reader auto& buf) {
 
 } // eigen
 } // zerialize
+
+namespace Eigen {
+
+// Read side of serialize() above; copies straight from the tensor bytes when
+// they can be viewed in place.
+template <zerialize::Reader V, typename T, int R, int C, int Options>
+void deserialize(const V& v, Eigen::Matrix<T, R, C, Options>& m) {
+    m = zerialize::eigen::asEigenMatrixView<T, R, C, false, Options>(v).map();
+}
+
+} // namespace Eigen
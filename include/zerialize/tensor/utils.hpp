@@ -112,6 +112,18 @@ TensorShape tensor_shape(const Reader auto& d) {
     return vshape;
 }
 
+inline TensorShape tensor_shape(const TypedArrayView& ta) {
+    TensorShape vshape;
+    vshape.reserve(ta.rank);
+    for (auto d : ta.shape()) {
+        if (d > std::numeric_limits<TensorShapeElement>::max()) {
+            throw DeserializationError("tensor dimension exceeds TensorShapeElement range");
+        }
+        vshape.push_back(static_cast<TensorShapeElement>(d));
+    }
+    return vshape;
+}
+
 template <typename C>
 concept HasDataAndSize = requires(const C& c) {
     { c.data() } -> std::convertible_to<const typename C::value_type*>; 
@@ -137,6 +149,11 @@ T* data_from_blobview(const BlobView auto& blob) {
 
 template <typename T, bool TensorIsMap=false>
 bool isTensor(const Reader auto& buf) {
+    // Protocols with native typed arrays store dtype/shape/data in one value,
+    // whichever layout the caller expects.
+    if constexpr (TypedArrayReader<std::remove_cvref_t<decltype(buf)>>) {
+        if (buf.isTypedArray()) return buf.asTypedArray().dtype == tensor_dtype_index<T>;
+    }
     if constexpr (TensorIsMap) {
         if (!buf.isMap()) return false;
         std::set<std::string_view> keys = buf.mapKeys();
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstring>
 #include <limits>
@@ -7,6 +9,7 @@
 #include <span>
 #include <type_traits>
 #include <cstdint>
+#include <vector>
 #include <xtensor/containers/xtensor.hpp>
 #include <xtensor/containers/xadapt.hpp>
 #include <xtensor/containers/xarray.hpp>
@@ -21,12 +24,22 @@ namespace xt {
 
 template <zerialize::HasDataAndSize X, zerialize::Writer W>
 void serialize(const X& t, W& w) {
-    zerialize::zvec(
+    const auto& tshape = t.shape();
+    std::array<std::uint64_t, zerialize::TypedArrayMaxRank> small{};
+    std::vector<std::uint64_t> large;
+    std::span<const std::uint64_t> dims;
+    if (tshape.size() <= small.size()) {
+        std::copy(tshape.begin(), tshape.end(), small.begin());
+        dims = std::span<const std::uint64_t>(small.data(), tshape.size());
+    } else {
+        large.assign(tshape.begin(), tshape.end());
+        dims = large;
+    }
+
+    zerialize::write_typed_array(w,
         zerialize::tensor_dtype_index<typename X::value_type>,
-        zerialize::shape_of_sizet(t.shape()),
-        zerialize::span_from_data_of(t)
-    )
-    (w);
+        dims,
+        zerialize::span_from_data_of(t));
 }
 
 } // namespace xt
@@ -42,8 +55,8 @@ namespace xtensor {
 // - the blob pointer is aligned for `T` (address % alignof(T) == 0), and
 // - the blob size matches prod(shape) * sizeof(T).
 //
-// If those conditions are not met (including protocols that materialize blobs as owning
-// `std::vector<std::byte>`, such as JSON), this stores an owning `xt::xarray<T>` copy.
+// If those conditions are not met (including protocols whose blobs are encoded, such as
+// JSON's base64, which is decoded straight into it), this stores an owning `xt::xarray<T>`.
 template <typename T>
 class XTensorView {
 public:
@@ -115,13 +128,11 @@ inline std::span<const std::byte> blob_to_span(const Blob& blob) {
     }
 }
 
-// Deserialize as a view-wrapper that can be zero-copy when safe, and otherwise owns a copy.
-template <typename T, int D = -1, bool TensorIsMap = false>
-XTensorView<T> asXTensorView(const Reader auto& buf) {
-    if (!isTensor<T, TensorIsMap>(buf)) { throw DeserializationError("not a tensor"); }
+namespace detail {
 
-    auto dtype_ref = TensorIsMap ? buf[DTypeKey] : buf[0];
-    auto dtype = dtype_ref.asInt32();
+// Check dtype and rank against the requested tensor.
+template <typename T, int D>
+void check_tensor_parts(int dtype, const TensorShape& vshape) {
     if (dtype != tensor_dtype_index<T>) {
         throw DeserializationError(
             std::string("asXTensorView asked to deserialize a tensor of type ") +
@@ -129,9 +140,6 @@ XTensorView<T> asXTensorView(const Reader auto& buf) {
         );
     }
 
-    auto shape_ref = TensorIsMap ? buf[ShapeKey] : buf[1];
-    TensorShape vshape = tensor_shape(shape_ref);
-
     if constexpr (D >= 0) {
         if (vshape.size() != static_cast<std::size_t>(D)) {
             throw DeserializationError(
@@ -140,9 +148,23 @@ XTensorView<T> asXTensorView(const Reader auto& buf) {
             );
         }
     }
+}
+
+// An uninitialized xarray of the given shape.
+template <typename T>
+xt::xarray<T> xarray_of_shape(const TensorShape& vshape) {
+    std::vector<std::size_t> s;
+    s.reserve(vshape.size());
+    for (auto d : vshape) s.push_back(static_cast<std::size_t>(d));
+    return xt::xarray<T>::from_shape(s);
+}
+
+// Build the view from an already-located dtype, shape and blob. `Blob` is either a
+// non-owning span (zero-copy candidate) or an owning container (always copied).
+template <typename T, int D, typename Blob>
+XTensorView<T> xtensor_view_from_parts(int dtype, TensorShape vshape, const Blob& blob) {
+    check_tensor_parts<T, D>(dtype, vshape);
 
-    auto data_ref = TensorIsMap ? buf[DataKey] : buf[2];
-    auto blob = data_ref.asBlob();
     auto bytes = blob_to_span(blob);
 
     // Validate payload size to avoid reading off the end, truncating, or leaving elements uninitialized.
@@ -156,12 +178,7 @@ XTensorView<T> asXTensorView(const Reader auto& buf) {
 
     // Copy into an owning xarray (which provides proper `T`-aligned storage).
     auto make_copy = [&] {
-        xt::xarray<T> out = xt::xarray<T>::from_shape([&] {
-            std::vector<std::size_t> s;
-            s.reserve(vshape.size());
-            for (auto d : vshape) s.push_back(static_cast<std::size_t>(d));
-            return s;
-        }());
+        xt::xarray<T> out = xarray_of_shape<T>(vshape);
         std::memcpy(out.data(), bytes.data(), bytes.size());
         tensor::TensorViewInfo info{};
         info.zero_copy = false;
@@ -172,7 +189,7 @@ XTensorView<T> asXTensorView(const Reader auto& buf) {
         return XTensorView<T>(std::move(out), std::move(vshape), element_count, info);
     };
 
-    if constexpr (!std::is_same_v<decltype(blob), std::span<const std::byte>>) {
+    if constexpr (!std::is_same_v<Blob, std::span<const std::byte>>) {
         return make_copy();
     } else {
         // Special note about alignment:
@@ -187,12 +204,7 @@ XTensorView<T> asXTensorView(const Reader auto& buf) {
         if ((info.address % alignof(T)) != 0) {
             info.zero_copy = false;
             info.reason = tensor::TensorViewReason::Misaligned;
-            xt::xarray<T> out = xt::xarray<T>::from_shape([&] {
-                std::vector<std::size_t> s;
-                s.reserve(vshape.size());
-                for (auto d : vshape) s.push_back(static_cast<std::size_t>(d));
-                return s;
-            }());
+            xt::xarray<T> out = xarray_of_shape<T>(vshape);
             std::memcpy(out.data(), bytes.data(), bytes.size());
             return XTensorView<T>(std::move(out), std::move(vshape), element_count, info);
         }
@@ -202,6 +214,59 @@ XTensorView<T> asXTensorView(const Reader auto& buf) {
     }
 }
 
+// Build an owning view from a blob the reader decodes (see BlobDecodeReader):
+// the bytes are decoded straight into the xarray's storage.
+template <typename T, int D, typename V>
+XTensorView<T> xtensor_view_from_decoded(int dtype, TensorShape vshape, const V& blob) {
+    check_tensor_parts<T, D>(dtype, vshape);
+
+    const std::size_t element_count = checked_element_count(vshape);
+    const std::size_t expected_bytes = element_count * sizeof(T);
+    const std::size_t found = blob.blobSize();
+    if (found != expected_bytes) {
+        throw DeserializationError(
+            "asXTensorView expected " + std::to_string(expected_bytes) + " bytes, but found " + std::to_string(found)
+        );
+    }
+
+    xt::xarray<T> out = xarray_of_shape<T>(vshape);
+    blob.readBlobInto(std::span<std::byte>(reinterpret_cast<std::byte*>(out.data()), expected_bytes));
+
+    tensor::TensorViewInfo info{};
+    info.zero_copy = false;
+    info.reason = tensor::TensorViewReason::NotSpanBacked;
+    info.required_alignment = alignof(T);
+    info.byte_size = expected_bytes;
+    return XTensorView<T>(std::move(out), std::move(vshape), element_count, info);
+}
+
+} // namespace detail
+
+// Deserialize as a view-wrapper that can be zero-copy when safe, and otherwise owns a copy.
+template <typename T, int D = -1, bool TensorIsMap = false>
+XTensorView<T> asXTensorView(const Reader auto& buf) {
+    // Native typed arrays carry dtype, shape and data in a single value.
+    if constexpr (TypedArrayReader<std::remove_cvref_t<decltype(buf)>>) {
+        if (buf.isTypedArray()) {
+            const TypedArrayView ta = buf.asTypedArray();
+            return detail::xtensor_view_from_parts<T, D>(ta.dtype, tensor_shape(ta), ta.data);
+        }
+    }
+
+    if (!isTensor<T, TensorIsMap>(buf)) { throw DeserializationError("not a tensor"); }
+
+    auto dtype_ref = TensorIsMap ? buf[DTypeKey] : buf[0];
+    auto shape_ref = TensorIsMap ? buf[ShapeKey] : buf[1];
+    auto data_ref = TensorIsMap ? buf[DataKey] : buf[2];
+    if constexpr (BlobDecodeReader<decltype(data_ref)>) {
+        return detail::xtensor_view_from_decoded<T, D>(
+            dtype_ref.asInt32(), tensor_shape(shape_ref), data_ref);
+    } else {
+        return detail::xtensor_view_from_parts<T, D>(
+            dtype_ref.asInt32(), tensor_shape(shape_ref), data_ref.asBlob());
+    }
+}
+
 // Deserialize an xtensor/x-adapter
 template <typename T, int D=-1, bool TensorIsMap=false>
 xt::xarray<T> asXTensor(const Reader auto& buf) {
@@ -210,3 +275,19 @@ xt::xarray<T> asXTensor(const Reader auto& buf) {
 
 } // namespace xtensor
 } // namespace zerialize
+
+namespace xt {
+
+// Read side of serialize() above; copies straight from the tensor bytes when
+// they can be viewed in place.
+template <zerialize::Reader V, typename T, xt::layout_type L>
+void deserialize(const V& v, xt::xarray<T, L>& out) {
+    out = zerialize::xtensor::asXTensorView<T>(v).tensor();
+}
+
+template <zerialize::Reader V, typename T, std::size_t N, xt::layout_type L>
+void deserialize(const V& v, xt::xtensor<T, N, L>& out) {
+    out = zerialize::xtensor::asXTensorView<T, static_cast<int>(N)>(v).tensor();
+}
+
+} // namespace xt
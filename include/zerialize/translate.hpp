@@ -1,6 +1,7 @@
 #pragma once
 
 #include <zerialize/concepts.hpp>
+#include <zerialize/internals/serializers.hpp>
 
 namespace zerialize {
 
@@ -37,7 +38,15 @@ inline void write_value(const V& v, W& w) {
     if (v.isUInt())      { w.uint64(v.asUInt64()); return; }
     if (v.isFloat())     { w.double_(v.asDouble()); return; }
     if (v.isString())    { w.string(v.asStringView()); return; }
- 
+
+    if constexpr (TypedArrayReader<V>) {
+        if (v.isTypedArray()) {
+            const TypedArrayView ta = v.asTypedArray();
+            write_typed_array(w, ta.dtype, ta.shape(), ta.data);
+            return;
+        }
+    }
+
     if (v.isBlob()) {
         auto b = v.asBlob();                    // span<const std::byte>
         w.binary(b);
@@ -45,6 +54,18 @@ inline void write_value(const V& v, W& w) {
     }
 
     if (v.isMap()) {
+        // One pass over the entries when the reader can do that cheaply.
+        if constexpr (MapCursorReader<V>) {
+            auto entries = v.mapEntries();
+            w.begin_map(entries.size());
+            for (auto&& [k, child] : entries) {
+                w.key(k);
+                write_value(child, w);
+            }
+            w.end_map();
+            return;
+        }
+
         // We want stable iteration; use the order the reader exposes.
         // mapKeys() returns a forward range of string_view (your StringViewRange).
         std::size_t count = 0;
@@ -60,6 +81,14 @@ inline void write_value(const V& v, W& w) {
     }
 
     if (v.isArray()) {
+        if constexpr (ArrayCursorReader<V>) {
+            auto elems = v.arrayElements();
+            w.begin_array(elems.size());
+            for (auto&& child : elems) write_value(child, w);
+            w.end_array();
+            return;
+        }
+
         const std::size_t n = v.arraySize();
         w.begin_array(n);
         for (std::size_t i = 0; i < n; ++i) write_value(v[i], w);
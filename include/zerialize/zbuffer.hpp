@@ -2,12 +2,16 @@
 
 #include <iomanip>
 #include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <stdexcept>
 #include <string>
 #include <sstream>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #include <span>
-#include <variant>
-#include <functional>
 
 namespace zerialize {
 
@@ -23,9 +27,13 @@ namespace zerialize {
  *       - A moved `std::vector<uint8_t>` (takes ownership of its storage).
  *       - A raw pointer (`uint8_t*`, `char*`, or `void*`) + size + custom deleter.
  *         Useful for integrating with C APIs, malloc/new allocations, or foreign libraries.
- *   • Internally stores either:
- *       - An owned `std::vector<uint8_t>`.
- *       - A managed pointer (`unique_ptr<uint8_t, function<void(uint8_t*)>>`) + length.
+ *       - A moved vector + a recycler that takes the vector back on destruction
+ *         (see BufferPool in buffer_pool.hpp).
+ *   • Internally stores the data pointer and size directly, plus either the
+ *     owned vector or a type-erased deleter. Deleters up to two pointers in
+ *     size that are trivially copyable (function pointers, captureless or
+ *     small capturing lambdas) live inline; only larger ones, such as a
+ *     std::function, are moved to the heap.
  *   • Always provides a uniform view via:
  *       - `.data()`   → raw pointer
  *       - `.size()`   → length in bytes
@@ -74,122 +82,165 @@ public:
         // Use with caution! Ensure the data outlives the ZBuffer.
         static constexpr auto NoOp = [](std::uint8_t*) { };
     };
-    
+
+    // Takes back the vector of a recycled buffer, e.g. into a pool.
+    using Recycler = void (*)(void* context, std::vector<uint8_t>&& storage) noexcept;
 
 private:
-    // --- Storage Strategies ---
+    // --- Storage ---
+    //
+    // Vector-backed buffers keep their bytes in vec_ (release_ is null, or
+    // release_recycle). Pointer-backed buffers keep the deleter in state_:
+    // inline if it is small and trivially copyable, otherwise as a pointer to
+    // a heap copy. Either way state_ is trivially copyable, so a move is a
+    // handful of word copies.
+    using ReleaseFn = void (*)(ZBuffer&) noexcept;
+    static constexpr std::size_t InlineStateSize = 2 * sizeof(void*);
+
+    template<class D>
+    static constexpr bool stores_inline =
+        sizeof(D) <= InlineStateSize && alignof(D) <= alignof(void*) && std::is_trivially_copyable_v<D>;
+
+    std::vector<uint8_t> vec_;
+    uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    ReleaseFn release_ = nullptr;
+    alignas(void*) unsigned char state_[InlineStateSize] = {};
+
+    template<class T, class D>
+    static void release_inline(ZBuffer& b) noexcept {
+        D& d = *std::launder(reinterpret_cast<D*>(b.state_));
+        if (b.data_) d(static_cast<T*>(static_cast<void*>(b.data_)));
+    }
 
-    // 1. Data owned by a std::vector
-    using Ownedvector = std::vector<uint8_t>;
+    template<class T, class D>
+    static void release_heap(ZBuffer& b) noexcept {
+        D* d = nullptr;
+        std::memcpy(&d, b.state_, sizeof(d));
+        if (b.data_) (*d)(static_cast<T*>(static_cast<void*>(b.data_)));
+        delete d;
+    }
 
-    // 2. Data owned by a raw pointer with a custom deleter
-    // We use unique_ptr with a type-erased deleter (std::function)
-    struct ManagedPtr {
-        // unique_ptr stores the pointer and the deleter.
-        // The deleter lambda captures any necessary context (like original type).
-        std::unique_ptr<uint8_t, std::function<void(uint8_t*)>> ptr;
-        size_t count = 0;
+    static void release_recycle(ZBuffer& b) noexcept {
+        Recycler recycle = nullptr;
+        void* context = nullptr;
+        std::memcpy(&recycle, b.state_, sizeof(recycle));
+        std::memcpy(&context, b.state_ + sizeof(void*), sizeof(context));
+        recycle(context, std::move(b.vec_));
+    }
 
-        ManagedPtr(uint8_t* data_to_own, size_t size, std::function<void(uint8_t*)> deleter)
-            : ptr(data_to_own, std::move(deleter)), count(size) {}
+    // Takes ownership of `p`, to be released by deleter `d` called with a T*.
+    template<class T, class D>
+    void adopt(T* p, size_t n, D&& d) {
+        using Del = std::decay_t<D>;
+        static_assert(std::is_invocable_v<Del&, T*>, "ZBuffer: deleter must be callable with the pointer type");
+        if (n > 0 && p == nullptr) {
+            throw std::invalid_argument("ZBuffer: Non-zero size requires a non-null pointer");
+        }
+        if constexpr (std::is_constructible_v<bool, const Del&>) {
+            if (!static_cast<bool>(d)) { // null function pointer or empty std::function
+                throw std::invalid_argument("ZBuffer: A valid deleter function must be provided");
+            }
+        }
+        if constexpr (stores_inline<Del>) {
+            ::new (static_cast<void*>(state_)) Del(std::forward<D>(d));
+            release_ = &release_inline<T, Del>;
+        } else {
+            Del* heap = new Del(std::forward<D>(d));
+            std::memcpy(state_, &heap, sizeof(heap));
+            release_ = &release_heap<T, Del>;
+        }
+        data_ = static_cast<uint8_t*>(static_cast<void*>(p));
+        size_ = n;
+    }
 
-        // Default constructor needed for variant default construction (if needed)
-        ManagedPtr() = default;
-    };
+    void release() noexcept {
+        if (release_) release_(*this);
+        release_ = nullptr;
+        data_ = nullptr;
+        size_ = 0;
+    }
 
-    // --- Variant holding the active storage strategy ---
-    std::variant<Ownedvector, ManagedPtr> storage_;
+    void take(ZBuffer& o) noexcept {
+        vec_ = std::move(o.vec_);
+        data_ = o.data_;
+        size_ = o.size_;
+        release_ = o.release_;
+        std::memcpy(state_, o.state_, sizeof(state_));
+        o.data_ = nullptr;
+        o.size_ = 0;
+        o.release_ = nullptr;
+    }
 
 public:
     // --- Constructors ---
 
     // Default constructor: Creates an empty buffer
-    ZBuffer() noexcept 
-        : storage_(std::in_place_type<Ownedvector>) {}
+    ZBuffer() noexcept = default;
 
-    // Constructor from a moved std::std::vector
+    // Constructor from a moved std::vector
     // Takes ownership of the std::vector's data.
     ZBuffer(std::vector<uint8_t>&& vec) noexcept
-        : storage_(std::in_place_type<Ownedvector>, std::move(vec)) {}
+        : vec_(std::move(vec)), data_(vec_.data()), size_(vec_.size()) {}
 
-    // Constructor taking ownership of a raw uint8_t* pointer with a custom deleter.
-    // The deleter MUST correctly free the provided pointer.
-    ZBuffer(uint8_t* data_to_own, size_t size, std::function<void(uint8_t*)> deleter)
-        : storage_(std::in_place_type<ManagedPtr>, data_to_own, size, std::move(deleter))
+    // Like the vector constructor, but on destruction the vector (with its
+    // capacity) is handed to `recycle(context, vec)` instead of being freed.
+    ZBuffer(std::vector<uint8_t>&& vec, Recycler recycle, void* context) noexcept
+        : ZBuffer(std::move(vec))
     {
-        if (size > 0 && data_to_own == nullptr) {
-            throw std::invalid_argument("ZBuffer: Non-zero size requires a non-null pointer");
-        }
-        if (!std::get<ManagedPtr>(storage_).ptr.get_deleter()) { // Check if deleter is valid (!= nullptr)
-            throw std::invalid_argument("ZBuffer: A valid deleter function must be provided");
-        }
+        std::memcpy(state_, &recycle, sizeof(recycle));
+        std::memcpy(state_ + sizeof(void*), &context, sizeof(context));
+        release_ = &release_recycle;
+    }
+
+    // Constructor taking ownership of a raw uint8_t* pointer with a custom deleter.
+    // The deleter MUST correctly free the provided pointer; it is not called
+    // for a null pointer.
+    template<class D>
+    ZBuffer(uint8_t* data_to_own, size_t size, D&& deleter) {
+        adopt(data_to_own, size, std::forward<D>(deleter));
     }
 
     // Constructor taking ownership of a raw char* pointer with a custom deleter.
     // The provided deleter should expect a char*.
-    ZBuffer(char* data_to_own, size_t size, std::function<void(char*)> char_deleter)
-        // Delegate to the uint8_t* constructor, wrapping the deleter
-        : ZBuffer(reinterpret_cast<uint8_t*>(data_to_own), size,
-            // Create a lambda that captures the original char* deleter
-            // and performs the cast back before calling it.
-            [cd = std::move(char_deleter)](uint8_t* ptr_to_delete) {
-                if (ptr_to_delete) { // Avoid casting/deleting null
-                    cd(reinterpret_cast<char*>(ptr_to_delete));
-                }
-            }) // End of arguments to delegating constructor
-    {}
+    template<class D>
+    ZBuffer(char* data_to_own, size_t size, D&& char_deleter) {
+        adopt(data_to_own, size, std::forward<D>(char_deleter));
+    }
 
     // Constructor taking ownership of a raw void* pointer with a custom *void* deleter
     // Useful for C APIs returning void* (like from malloc).
-    ZBuffer(void* data_to_own, size_t size, std::function<void(void*)> void_deleter)
-        : ZBuffer(static_cast<uint8_t*>(data_to_own), size,
-            [vd = std::move(void_deleter)](uint8_t* ptr_to_delete) {
-                if (ptr_to_delete) {
-                    vd(static_cast<void*>(ptr_to_delete)); // Cast back to void* for deleter
-                }
-            })
-    {}
+    template<class D>
+    ZBuffer(void* data_to_own, size_t size, D&& void_deleter) {
+        adopt(data_to_own, size, std::forward<D>(void_deleter));
+    }
 
     // Delete copy constructor and assignment - ZBuffer manages unique ownership
     ZBuffer(const ZBuffer&) = delete;
     ZBuffer& operator=(const ZBuffer&) = delete;
 
-    // Default move constructor and assignment are okay (variant handles it)
-    ZBuffer(ZBuffer&&) noexcept = default;
-    ZBuffer& operator=(ZBuffer&&) noexcept = default;
+    ZBuffer(ZBuffer&& o) noexcept { take(o); }
+    ZBuffer& operator=(ZBuffer&& o) noexcept {
+        if (this != &o) {
+            release();
+            take(o);
+        }
+        return *this;
+    }
+
+    ~ZBuffer() { release(); }
 
 
     // --- Accessors ---
 
-    [[nodiscard]] size_t size() const noexcept {
-        return std::visit([](const auto& storage_impl) -> size_t {
-            using T = std::decay_t<decltype(storage_impl)>;
-            if constexpr (std::is_same_v<T, Ownedvector>) {
-                return storage_impl.size();
-            } else if constexpr (std::is_same_v<T, ManagedPtr>) {
-                return storage_impl.count;
-            } else {
-                return 0; // Should be unreachable
-            }
-        }, storage_);
-    }
+    [[nodiscard]] size_t size() const noexcept { return size_; }
 
+    // True when the bytes are held in a std::vector (plain or recycled).
     [[nodiscard]] bool owned() const noexcept {
-        return std::holds_alternative<Ownedvector>(storage_);
+        return release_ == nullptr || release_ == &release_recycle;
     }
 
-    [[nodiscard]] const uint8_t* data() const noexcept {
-        return std::visit([](const auto& storage_impl) -> const uint8_t* {
-            using T = std::decay_t<decltype(storage_impl)>;
-            if constexpr (std::is_same_v<T, Ownedvector>) {
-                return storage_impl.data(); // std::vector::data() is fine in C++20
-            } else if constexpr (std::is_same_v<T, ManagedPtr>) {
-                return storage_impl.ptr.get(); // unique_ptr::get()
-            } else {
-                return nullptr; // Should be unreachable
-            }
-        }, storage_);
-    }
+    [[nodiscard]] const uint8_t* data() const noexcept { return data_; }
 
     [[nodiscard]] bool empty() const noexcept {
         return size() == 0;
@@ -82,8 +82,20 @@ constexpr auto zvec(Ts&&... xs)
 }
 
 
+// Emit compile-time key K: pre-encoded bytes when the writer takes them
+// (see RawKeyWriter), otherwise through key().
+template<fixed_string K, Writer W>
+void write_key(W& w) {
+    if constexpr (RawKeyWriter<W>) {
+        w.template key_raw<K>();
+    } else {
+        w.key(K.view());
+    }
+}
+
 //────────────────────────  zmap: map builder  ─────────────────────
-// Compile-time keys (fast path, zero runtime key storage).
+// Compile-time keys (fast path, zero runtime key storage). Writers that
+// support it get each key as bytes encoded at compile time; see write_key.
 // Usage: zmap<"a","b">(3, 5.2)  →  {"a":3, "b":5.2}
 template<fixed_string... Keys, typename... Ts>
 constexpr auto zmap(Ts&&... xs)
@@ -95,15 +107,13 @@ constexpr auto zmap(Ts&&... xs)
              <Writer W>(W& w) mutable
     {
         constexpr std::size_t N = sizeof...(Keys);
-        // Materialize compile-time keys as string_view array once.
-        constexpr auto key_views = std::array<std::string_view, N>{ Keys.view()... };
 
         w.begin_map(N);
 
         // Unroll keys/values in lockstep.
         [&]<std::size_t... I>(std::index_sequence<I...>) {
             (( // key I
-               w.key(key_views[I]),
+               write_key<Keys>(w),
                // value I
                [&]<typename V>(V&& val) {
                    using TVal = std::remove_reference_t<V>;
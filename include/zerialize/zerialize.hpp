@@ -1,8 +1,13 @@
 #pragma once
 
 #include <zerialize/concepts.hpp>
+#include <zerialize/deserialize.hpp>
 #include <zerialize/errors.hpp>
+#include <zerialize/fields.hpp>
+#include <zerialize/output.hpp>
 #include <zerialize/serialize.hpp>
+#include <zerialize/stream.hpp>
+#include <zerialize/template_message.hpp>
 #include <zerialize/translate.hpp>
 #include <zerialize/zbuffer.hpp>
 #include <zerialize/dynamic.hpp>
@@ -3,6 +3,9 @@ module;
 #ifdef ZERIALIZE_HAS_CBOR
 #include <zerialize/protocols/cbor.hpp>
 #endif
+#ifdef ZERIALIZE_HAS_CBOR_JSONCONS
+#include <zerialize/protocols/cbor_jsoncons.hpp>
+#endif
 
 export module zerialize:cbor;
 
@@ -10,12 +13,22 @@ export namespace zerialize {
     #ifdef ZERIALIZE_HAS_CBOR
     using zerialize::CBOR;
     #endif
-    namespace cborjc {
+    #ifdef ZERIALIZE_HAS_CBOR_JSONCONS
+    using zerialize::CBORJsoncons;
+    #endif
+    namespace cbor {
         #ifdef ZERIALIZE_HAS_CBOR
-        using zerialize::cborjc::RootSerializer;
-        using zerialize::cborjc::Serializer;
-        using zerialize::cborjc::CborDeserializer;
-        using zerialize::cborjc::operator==;
+        using zerialize::cbor::BasicRootSerializer;
+        using zerialize::cbor::BasicSerializer;
+        using zerialize::cbor::RootSerializer;
+        using zerialize::cbor::Serializer;
+        using zerialize::cbor::SizeCounter;
+        using zerialize::cbor::CborDeserializer;
+        using zerialize::cbor::operator==;
+        #endif
+        #ifdef ZERIALIZE_HAS_CBOR_JSONCONS
+        using zerialize::cbor::JsonconsRootSerializer;
+        using zerialize::cbor::JsonconsSerializer;
         #endif
     }
 }
@@ -2,6 +2,7 @@ module;
 
 #ifdef ZERIALIZE_HAS_JSON
 #include <zerialize/protocols/json.hpp>
+#include <zerialize/protocols/json_lazy.hpp>
 #endif
 
 export module zerialize:json;
@@ -9,6 +10,8 @@ export module zerialize:json;
 export namespace zerialize {
     #ifdef ZERIALIZE_HAS_JSON
     using zerialize::JSON;
+    using zerialize::JSONDirect;
+    using zerialize::JSONLazy;
     #endif
     namespace json {
         #ifdef ZERIALIZE_HAS_JSON
@@ -16,8 +19,17 @@ export namespace zerialize {
         using zerialize::json::blobEncoding;
         using zerialize::json::KeysView;
         using zerialize::json::JsonDeserializer;
+        using zerialize::json::InsituPadding;
+        using zerialize::json::ReadAllocator;
+        using zerialize::json::KeyIndex;
+        using zerialize::json::key_hash;
         using zerialize::json::RootSerializer;
         using zerialize::json::Serializer;
+        using zerialize::json::BasicDirectRootSerializer;
+        using zerialize::json::BasicDirectSerializer;
+        using zerialize::json::DirectRootSerializer;
+        using zerialize::json::DirectSerializer;
+        using zerialize::json::LazyDeserializer;
         using zerialize::json::operator==;
         using zerialize::json::operator!=;
         #endif
@@ -3,6 +3,9 @@ module;
 #ifdef ZERIALIZE_HAS_MSGPACK
 #include <zerialize/protocols/msgpack.hpp>
 #endif
+#ifdef ZERIALIZE_HAS_MSGPACK_C
+#include <zerialize/protocols/msgpack_c.hpp>
+#endif
 
 export module zerialize:msgpack;
 
@@ -11,6 +14,14 @@ export namespace zerialize {
     using zerialize::MsgPackDeserializer;
     using zerialize::MsgPackRootSerializer;
     using zerialize::MsgPackSerializer;
+    using zerialize::BasicMsgPackRootSerializer;
+    using zerialize::BasicMsgPackSerializer;
+    using zerialize::MsgPackSizeCounter;
     using zerialize::MsgPack;
     #endif
+    #ifdef ZERIALIZE_HAS_MSGPACK_C
+    using zerialize::MsgPackCRootSerializer;
+    using zerialize::MsgPackCSerializer;
+    using zerialize::MsgPackC;
+    #endif
 }
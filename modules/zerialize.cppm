@@ -21,19 +21,45 @@ export namespace zerialize {
     using zerialize::Writer;
     using zerialize::Builder;
     using zerialize::RootSerializer;
+    using zerialize::ReusableRootSerializer;
+    using zerialize::SegmentedRootSerializer;
     using zerialize::SerializerFor;
     using zerialize::Protocol;
+    using zerialize::SelfDelimitingProtocol;
+    using zerialize::PatchableProtocol;
+    using zerialize::SpanOutputProtocol;
+    using zerialize::MeasurableProtocol;
     using zerialize::SerializationError;
+    using zerialize::OutputOverflow;
     using zerialize::DeserializationError;
     using zerialize::serialize;
+    using zerialize::serialize_into;
+    using zerialize::serialize_to;
+    using zerialize::measure;
+    using zerialize::deserialize;
+    using zerialize::read_map;
     using zerialize::write_value;
     using zerialize::translate;
     using zerialize::translate_bytes;
     using zerialize::ZBuffer;
+    using zerialize::BufferPool;
+    using zerialize::VectorOutput;
+    using zerialize::SpanOutput;
+    using zerialize::Segment;
+    using zerialize::SegmentedBuffer;
     using zerialize::BuilderWrapper;
     using zerialize::zvec;
     using zerialize::zmap;
     using zerialize::DynamicValue;
+    using zerialize::TemplateMessage;
+
+    namespace stream {
+        using zerialize::stream::Framing;
+        using zerialize::stream::LengthPrefixSize;
+        using zerialize::stream::FrameWriter;
+        using zerialize::stream::FrameReader;
+        using zerialize::stream::FrameDecoder;
+    }
 
     namespace dyn {
         using zerialize::dyn::Value;